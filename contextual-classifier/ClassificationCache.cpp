@@ -0,0 +1,239 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <climits>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "Utils.h"
+#include "Logger.h"
+#include "AuxRoutines.h"
+#include "ClassificationCache.h"
+
+#define CLASSIFICATION_CACHE_TAG "CLASSIFICATION_CACHE"
+#define CLASSIFICATION_CACHE_HEADER "urm-classification-cache v1 "
+// Numeric fields of the key, preceding the exe path
+#define CLASSIFICATION_CACHE_KEY_FIELDS 5
+
+static uint64_t hashBytes(const char* data, size_t size) {
+    // FNV-1a (64-bit)
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < size; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+ClassificationCache::ClassificationCache(size_t maxEntries) {
+    this->mMaxEntries = maxEntries > 0 ? maxEntries : 1;
+}
+
+void ClassificationCache::setMaxEntries(size_t maxEntries) {
+    const std::lock_guard<std::mutex> lock(this->mCacheMutex);
+    this->mMaxEntries = maxEntries > 0 ? maxEntries : 1;
+
+    while(this->mEntries.size() > this->mMaxEntries) {
+        this->mIndex.erase(this->mEntries.back().first);
+        this->mEntries.pop_back();
+    }
+}
+
+void ClassificationCache::setModelIdentity(const std::string& modelPath) {
+    struct stat modelStat;
+    int64_t size = -1;
+    int64_t mtimeNs = -1;
+    if(stat(modelPath.c_str(), &modelStat) == 0) {
+        size = modelStat.st_size;
+        mtimeNs = (int64_t)modelStat.st_mtim.tv_sec * 1000000000LL + modelStat.st_mtim.tv_nsec;
+    }
+
+    const std::lock_guard<std::mutex> lock(this->mCacheMutex);
+    this->mModelIdentity = std::to_string(size) + ":" + std::to_string(mtimeNs) + ":" + modelPath;
+}
+
+std::string ClassificationCache::encodeKey(const ExeIdentity& identity) {
+    return std::to_string(identity.mDev) + ":" +
+           std::to_string(identity.mIno) + ":" +
+           std::to_string(identity.mMtimeNs) + ":" +
+           std::to_string(identity.mSize) + ":" +
+           std::to_string(identity.mCmdlineHash) + ":" +
+           identity.mExePath;
+}
+
+// Checks the key against the encodeKey format, i.e. the numeric fields followed by a path.
+int8_t ClassificationCache::isValidKey(const std::string& key) {
+    size_t pos = 0;
+    for(int32_t field = 0; field < CLASSIFICATION_CACHE_KEY_FIELDS; field++) {
+        size_t sep = key.find(':', pos);
+        if(sep == std::string::npos || sep == pos) {
+            return false;
+        }
+        for(size_t i = pos; i < sep; i++) {
+            if(!isdigit((unsigned char)key[i]) && !(i == pos && key[i] == '-')) {
+                return false;
+            }
+        }
+        pos = sep + 1;
+    }
+    return (pos < key.length() && key[pos] == '/');
+}
+
+int8_t ClassificationCache::getExeIdentity(pid_t pid, ExeIdentity& identity) {
+    std::string exeLink = "/proc/" + std::to_string(pid) + "/exe";
+
+    char exePath[PATH_MAX];
+    ssize_t len = readlink(exeLink.c_str(), exePath, sizeof(exePath) - 1);
+    if(len <= 0) {
+        return false;
+    }
+    exePath[len] = '\0';
+
+    // stat follows the link to the file actually mapped by the process, even if the
+    // path has since been replaced.
+    struct stat exeStat;
+    if(stat(exeLink.c_str(), &exeStat) < 0) {
+        return false;
+    }
+
+    std::string_view cmdline;
+    if(!AuxRoutines::readProcFile(pid, "cmdline", cmdline)) {
+        return false;
+    }
+
+    identity.mExePath = exePath;
+    identity.mDev = exeStat.st_dev;
+    identity.mIno = exeStat.st_ino;
+    identity.mMtimeNs = (int64_t)exeStat.st_mtim.tv_sec * 1000000000LL + exeStat.st_mtim.tv_nsec;
+    identity.mSize = exeStat.st_size;
+    identity.mCmdlineHash = hashBytes(cmdline.data(), cmdline.size());
+
+    return true;
+}
+
+int8_t ClassificationCache::lookup(const ExeIdentity& identity, int32_t& contextType) {
+    std::string key = encodeKey(identity);
+
+    const std::lock_guard<std::mutex> lock(this->mCacheMutex);
+    auto it = this->mIndex.find(key);
+    if(it == this->mIndex.end()) {
+        return false;
+    }
+
+    // Mark as most recently used
+    this->mEntries.splice(this->mEntries.begin(), this->mEntries, it->second);
+    contextType = it->second->second;
+    return true;
+}
+
+// Expects mCacheMutex to be held.
+void ClassificationCache::insertLocked(const std::string& key, int32_t contextType) {
+    auto it = this->mIndex.find(key);
+    if(it != this->mIndex.end()) {
+        it->second->second = contextType;
+        this->mEntries.splice(this->mEntries.begin(), this->mEntries, it->second);
+        return;
+    }
+
+    if(this->mEntries.size() >= this->mMaxEntries) {
+        this->mIndex.erase(this->mEntries.back().first);
+        this->mEntries.pop_back();
+    }
+
+    this->mEntries.emplace_front(key, contextType);
+    this->mIndex[key] = this->mEntries.begin();
+}
+
+void ClassificationCache::insert(const ExeIdentity& identity, int32_t contextType) {
+    std::string key = encodeKey(identity);
+
+    const std::lock_guard<std::mutex> lock(this->mCacheMutex);
+    this->insertLocked(key, contextType);
+}
+
+size_t ClassificationCache::size() {
+    const std::lock_guard<std::mutex> lock(this->mCacheMutex);
+    return this->mEntries.size();
+}
+
+// File Format: A header line identifying the model, followed by one entry per line,
+// least recently used first:
+// urm-classification-cache v1 <model size>:<model mtime>:<model path>
+// <context type> <dev>:<ino>:<mtime>:<size>:<cmdline hash>:<exe path>
+int8_t ClassificationCache::load(const std::string& filePath) {
+    std::ifstream cacheFile(filePath);
+    if(!cacheFile.is_open()) {
+        return false;
+    }
+
+    const std::lock_guard<std::mutex> lock(this->mCacheMutex);
+    std::string line;
+    if(!std::getline(cacheFile, line) || line != CLASSIFICATION_CACHE_HEADER + this->mModelIdentity) {
+        LOGI(CLASSIFICATION_CACHE_TAG, "Cached classifications are from another model, discarding");
+        return false;
+    }
+
+    // Entries are only taken once the whole file checks out.
+    std::vector<CacheEntry> entries;
+    while(std::getline(cacheFile, line)) {
+        size_t sep = line.find(' ');
+        if(sep == std::string::npos || sep == 0 || !isValidKey(line.substr(sep + 1))) {
+            LOGW(CLASSIFICATION_CACHE_TAG, "Malformed classification cache: " + filePath + ", discarding");
+            return false;
+        }
+
+        try {
+            size_t parsedLen = 0;
+            int32_t contextType = std::stoi(line.substr(0, sep), &parsedLen);
+            if(parsedLen != sep) {
+                throw std::invalid_argument(line);
+            }
+            entries.emplace_back(line.substr(sep + 1), contextType);
+        } catch(const std::exception& e) {
+            LOGW(CLASSIFICATION_CACHE_TAG, "Malformed classification cache: " + filePath + ", discarding");
+            return false;
+        }
+    }
+
+    for(const CacheEntry& entry: entries) {
+        this->insertLocked(entry.first, entry.second);
+    }
+
+    LOGI(CLASSIFICATION_CACHE_TAG,
+         "Loaded " + std::to_string(this->mEntries.size()) + " cached classifications");
+    return true;
+}
+
+int8_t ClassificationCache::save(const std::string& filePath) {
+    std::string tmpPath = filePath + ".tmp";
+    std::ofstream cacheFile(tmpPath, std::ios::out | std::ios::trunc);
+    if(!cacheFile.is_open()) {
+        LOGW(CLASSIFICATION_CACHE_TAG, "Failed to open: " + tmpPath + " Error: " + strerror(errno));
+        return false;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(this->mCacheMutex);
+        cacheFile<<CLASSIFICATION_CACHE_HEADER<<this->mModelIdentity<<"\n";
+        for(auto it = this->mEntries.rbegin(); it != this->mEntries.rend(); ++it) {
+            if(it->first.find('\n') != std::string::npos) {
+                continue;
+            }
+            cacheFile<<it->second<<" "<<it->first<<"\n";
+        }
+    }
+
+    cacheFile.close();
+    if(cacheFile.fail() || rename(tmpPath.c_str(), filePath.c_str()) < 0) {
+        LOGW(CLASSIFICATION_CACHE_TAG, "Failed to persist the cache to: " + filePath);
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
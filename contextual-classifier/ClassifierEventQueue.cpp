@@ -0,0 +1,48 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include "ClassifierEventQueue.h"
+
+ClassifierEventQueue::ClassifierEventQueue(size_t maxSize) {
+    this->mMaxSize = maxSize > 0 ? maxSize : 1;
+}
+
+void ClassifierEventQueue::setMaxSize(size_t maxSize) {
+    this->mMaxSize = maxSize > 0 ? maxSize : 1;
+}
+
+size_t ClassifierEventQueue::getMaxSize() {
+    return this->mMaxSize;
+}
+
+void ClassifierEventQueue::push(const ProcEvent& ev) {
+    this->mPendingEv.push_back(ev);
+    if(this->mPendingEv.size() > this->mMaxSize) {
+        // Full, drop the oldest event.
+        this->mPendingEv.pop_front();
+    }
+}
+
+int8_t ClassifierEventQueue::popRunnable(ProcEvent& ev) {
+    for(auto it = this->mPendingEv.begin(); it != this->mPendingEv.end(); ++it) {
+        if(this->mInFlightPids.count(it->pid) == 0) {
+            ev = *it;
+            this->mPendingEv.erase(it);
+            this->mInFlightPids.insert(ev.pid);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ClassifierEventQueue::markDone(int32_t pid) {
+    this->mInFlightPids.erase(pid);
+}
+
+void ClassifierEventQueue::clear() {
+    this->mPendingEv.clear();
+}
+
+size_t ClassifierEventQueue::size() {
+    return this->mPendingEv.size();
+}
@@ -11,6 +11,7 @@
 #include <dirent.h>
 #include <algorithm>
 #include <pthread.h>
+#include <sys/stat.h>
 
 #include "Utils.h"
 #include "Logger.h"
@@ -21,6 +22,7 @@
 #include "UrmPlatformAL.h"
 #include "SignalRegistry.h"
 #include "RestuneInternal.h"
+#include "SignalInternal.h"
 #include "ContextualClassifier.h"
 #include "ClientGarbageCollector.h"
 
@@ -52,7 +54,12 @@ Inference *ContextualClassifier::GetInferenceObject() {
 #endif
 
 static ContextualClassifier *gClassifier = nullptr;
-static const int32_t pendingQueueControlSize = 30;
+
+static void onFocusHint(pid_t pid) {
+    if(gClassifier != nullptr) {
+        gClassifier->HandleFocusHint(pid);
+    }
+}
 
 ContextualClassifier::ContextualClassifier() {
     this->mInference = GetInferenceObject();
@@ -170,9 +177,21 @@ ErrCode ContextualClassifier::Init() {
     LOGI(CLASSIFIER_TAG, "Classifier module init");
 
     this->LoadIgnoredProcesses();
+    this->LoadClassificationCache();
+    this->LoadSettleDelay();
+    this->LoadWorkerConfig();
+    this->LoadModelConfig();
 
-    // Single worker thread for classification
-    this->mClassifierMain = std::thread(&ContextualClassifier::ClassifierMain, this);
+    try {
+        for(int32_t i = 0; i < this->mWorkerCount; i++) {
+            this->mClassifierWorkers.emplace_back(&ContextualClassifier::ClassifierMain, this, i);
+        }
+    } catch(const std::system_error& e) {
+        TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "classifier", e.what());
+        if(this->mClassifierWorkers.empty()) {
+            return RC_MODULE_INIT_FAILURE;
+        }
+    }
 
     if(this->mNetLinkComm.connect() == -1) {
         LOGE(CLASSIFIER_TAG, "Failed to connect to netlink socket");
@@ -186,130 +205,316 @@ ErrCode ContextualClassifier::Init() {
     }
     LOGI(CLASSIFIER_TAG, "Now listening for process events");
 
+    // Events received from here on are applied on top of the walk, once the listener starts.
+    this->mProcessIndex.populate();
+
     this->mNetlinkThread = std::thread(&ContextualClassifier::HandleProcEv, this);
+    registerFocusHintListener(onFocusHint);
     return RC_SUCCESS;
 }
 
 ErrCode ContextualClassifier::Terminate() {
     LOGI(CLASSIFIER_TAG, "Classifier module terminate.");
 
+    // No focus hints are delivered once this returns.
+    registerFocusHintListener(nullptr);
+
     if(this->mNetLinkComm.getSocket() != -1) {
         this->mNetLinkComm.setListen(false);
     }
 
-    std::unique_lock<std::mutex> lock(this->mQueueMutex);
-    this->mNeedExit = true;
-    // Clear any pending PIDs so the worker doesn't see stale entries
-    while(!this->mPendingEv.empty()) {
-        this->mPendingEv.pop();
+    {
+        const std::lock_guard<std::mutex> lock(this->mQueueMutex);
+        this->mNeedExit = true;
+        // Clear any pending PIDs so the workers don't see stale entries
+        this->mEventQueue.clear();
+        this->mSettlingEv.clear();
+        this->mSettlingPids.clear();
+        this->mQueueCond.notify_all();
     }
-    this->mQueueCond.notify_all();
 
     this->mNetLinkComm.closeSocket();
 
+    if(this->mNetLinkComm.getOverrunCount() > 0) {
+        LOGW(CLASSIFIER_TAG,
+             "Proc event receive queue overflowed " +
+             std::to_string(this->mNetLinkComm.getOverrunCount()) + " times (ENOBUFS)");
+    }
+
+    LOGI(CLASSIFIER_TAG,
+         "Classifications cancelled within the settle delay: " +
+         std::to_string(this->mSettleCancelCount));
+
     if(this->mNetlinkThread.joinable()) {
         this->mNetlinkThread.join();
     }
+    if(this->mIndexResyncThread.joinable()) {
+        this->mIndexResyncThread.join();
+    }
 
-    if(this->mClassifierMain.joinable()) {
-        this->mClassifierMain.join();
+    // The queue lock must not be held here, the threads being joined may be waiting on it.
+    int8_t wasRunning = !this->mClassifierWorkers.empty();
+    for(std::thread& worker: this->mClassifierWorkers) {
+        if(worker.joinable()) {
+            worker.join();
+        }
+    }
+    this->mClassifierWorkers.clear();
+
+    if(wasRunning && this->mPersistClassificationCache) {
+        this->mClassificationCache.save(CLASSIFICATION_CACHE_PATH);
     }
 
     return RC_SUCCESS;
 }
 
-void ContextualClassifier::ClassifierMain() {
-    pthread_setname_np(pthread_self(), "urmClassifier");
-    while (true) {
+void ContextualClassifier::ClassifierMain(int32_t workerId) {
+    std::string threadName = "urmClassifier" + std::to_string(workerId);
+    pthread_setname_np(pthread_self(), threadName.c_str());
+
+    // Off the critical path: Init has returned, and the other workers pick up any
+    // events which arrive in the meantime.
+    if(workerId == 0 && this->mWarmUpModel) {
+        this->mInference->WarmUp();
+    }
+
+    while(true) {
         ProcEvent ev{};
 
-        std::unique_lock<std::mutex> lock(this->mQueueMutex);
-        this->mQueueCond.wait(
-            lock,
-            [this] {
-                return !this->mPendingEv.empty() || this->mNeedExit;
+        {
+            std::unique_lock<std::mutex> lock(this->mQueueMutex);
+            this->PromoteSettledEvents();
+            while(!this->mNeedExit && !this->mEventQueue.popRunnable(ev)) {
+                if(this->mSettlingEv.empty()) {
+                    this->mQueueCond.wait(lock);
+                } else {
+                    this->mQueueCond.wait_until(lock, this->mSettlingEv.front().deadline);
+                }
+                this->PromoteSettledEvents();
             }
-        );
 
-        if(this->mNeedExit) {
-            return;
+            if(this->mNeedExit) {
+                return;
+            }
         }
 
-        ev = this->mPendingEv.front();
-        this->mPendingEv.pop();
+        this->ProcessEvent(ev);
 
-        if(ev.type == CC_APP_OPEN) {
-            std::string comm;
-            uint32_t sigId = URM_SIG_APP_OPEN;
-            uint32_t sigType = DEFAULT_SIGNAL_TYPE;
-            int32_t numArgs = 0;
-            int32_t* args = nullptr;
-            uint32_t ctxDetails = 0U;
+        {
+            const std::lock_guard<std::mutex> lock(this->mQueueMutex);
+            this->mEventQueue.markDone(ev.pid);
+        }
+        // Events for this pid which were held back can now be picked up by any worker.
+        this->mQueueCond.notify_all();
+    }
+}
 
-            if(ev.pid != -1) {
-                if(AuxRoutines::fetchComm(ev.pid, comm) != 0) {
-                    continue;
-                }
+void ContextualClassifier::ProcessEvent(const ProcEvent& ev) {
+    if(ev.type == CC_APP_OPEN) {
+        std::string comm;
+        uint32_t ctxDetails = 0U;
 
-                // Step 1: Figure out workload type
-                int32_t contextType =
-                    this->ClassifyProcess(ev.pid, ev.tgid, comm, ctxDetails);
-				if(contextType == CC_IGNORE) {
-					// Ignore and wait for next event
-					continue;
-				}
-
-                // Identify if any signal configuration exists
-                // Will return the sigID based on the workload
-                // For example: game, browser, multimedia
-                sigId = this->GetSignalIDForWorkload(contextType);
-
-                // Step 2:
-                // Untune any Configurations from the last proc-invocation
-                for(int64_t handle: this->mCurrRestuneHandles) {
-                    if(handle > 0) {
-                        this->untuneRequestHelper(handle);
-                    }
-                }
-                this->mCurrRestuneHandles.clear();
-
-                // Step 3:
-                // - Move the process to focused-cgroup, Also involves removing the process
-                //  already there from the cgroup.
-                // - Move the "threads" from per-app config to appropriate cgroups
-                this->MoveAppThreadsToCGroup(ev.pid, ev.tgid, comm, FOCUSED_CGROUP_IDENTIFIER);
-
-                // Step 4:
-                // Configure any per-app config specified signals.
-                this->configureAppSignals(ev.pid, ev.tgid, comm);
-
-                // Step 5: If the post processing block exists, call it
-                // It might provide us a more specific sigID or sigType
-                PostProcessingCallback postCb =
-                    Extensions::getPostProcessingCallback(comm);
-                if(postCb != nullptr) {
-                    PostProcessCBData postProcessData = {
-                        .mPid = ev.pid,
-                        .mSigId = sigId,
-                        .mSigType = sigType,
-                        .mNumArgs = numArgs,
-                        .mArgs = args,
-                    };
-                    postCb((void*)&postProcessData);
-
-                    sigId = postProcessData.mSigId;
-                    sigType = postProcessData.mSigType;
-                    numArgs = postProcessData.mNumArgs;
-                    args = postProcessData.mArgs;
-                }
+        if(ev.pid != -1) {
+            if(AuxRoutines::fetchComm(ev.pid, comm) != 0) {
+                return;
+            }
+
+            // Step 1: Figure out workload type
+            int32_t contextType =
+                this->ClassifyProcess(ev.pid, ev.tgid, comm, ctxDetails);
+            if(contextType == CC_IGNORE) {
+                // Ignore and wait for next event
+                return;
+            }
+
+            // Classification runs concurrently across the workers, but the focused app
+            // (and the handles tied to it) is switched by one worker at a time.
+            const std::lock_guard<std::mutex> applyLock(this->mApplyMutex);
+            if(!this->mFocusTracker.onClassified(ev.pid, {ev.tgid, comm, contextType}, ev.seq)) {
+                LOGD(CLASSIFIER_TAG,
+                     "Classified app: " + comm + " is not focused, keeping the focused app");
+                this->ApplyBackgroundApp(ev.pid, ev.tgid, comm, contextType);
+                return;
+            }
+
+            this->ApplyFocusedApp(ev.pid, ev.tgid, comm, contextType, ev.seq);
+        }
+    } else if(ev.type == CC_APP_CLOSE) {
+        if(ev.pid == ev.tgid) {
+            const std::lock_guard<std::mutex> applyLock(this->mApplyMutex);
+            this->mFocusTracker.onAppExit(ev.pid);
+            this->RemoveBackgroundActions(ev.pid);
+            if(ev.pid == this->mFocusedTgid) {
+                this->SetFocusedAppRules(-1, "", {});
+            }
+        }
+
+        // No Action Needed, Pulse Monitor to take care of cleanup
+        ClientGarbageCollector::getInstance()->submitClientForCleanup(ev.pid);
+        ClientDataManager::getInstance()->deleteClientPID(ev.pid);
+    }
+}
+
+// Expects mApplyMutex to be held.
+// Switches the per-app profile over to the given app, i.e. drops the actions of the
+// previously focused app and applies the ones for this app.
+void ContextualClassifier::ApplyFocusedApp(pid_t pid,
+                                           pid_t tgid,
+                                           const std::string& comm,
+                                           int32_t contextType,
+                                           uint64_t seq) {
+    uint32_t sigId = 0;
+    uint32_t sigType = DEFAULT_SIGNAL_TYPE;
+    int32_t numArgs = 0;
+    int32_t* args = nullptr;
+
+    // Identify if any signal configuration exists
+    // Will return the sigID based on the workload
+    // For example: game, browser, multimedia
+    GetActionSignal(contextType, true, sigId, sigType);
+
+    LOGD(CLASSIFIER_TAG,
+         "Switching the focused app to: " + comm + " (" + std::to_string(pid) + ")");
+
+    // The app's background actions are superseded by the focused profile.
+    this->RemoveBackgroundActions(pid);
+
+    // Step 2:
+    // Untune any Configurations from the last proc-invocation
+    for(int64_t handle: this->mCurrRestuneHandles) {
+        if(handle > 0) {
+            this->untuneRequestHelper(handle);
+        }
+    }
+    this->mCurrRestuneHandles.clear();
+    this->mFocusTracker.setFocusedApp(pid, seq);
+
+    // Step 3:
+    // - Move the process to focused-cgroup, Also involves removing the process
+    //  already there from the cgroup.
+    // - Move the "threads" from per-app config to appropriate cgroups
+    this->MoveAppThreadsToCGroup(pid, tgid, comm, FOCUSED_CGROUP_IDENTIFIER);
+
+    // Step 4:
+    // Configure any per-app config specified signals.
+    this->configureAppSignals(pid, tgid, comm);
+
+    // Step 5: If the post processing block exists, call it
+    // It might provide us a more specific sigID or sigType
+    PostProcessingCallback postCb =
+        Extensions::getPostProcessingCallback(comm);
+    if(postCb != nullptr) {
+        PostProcessCBData postProcessData = {
+            .mPid = pid,
+            .mSigId = sigId,
+            .mSigType = sigType,
+            .mNumArgs = numArgs,
+            .mArgs = args,
+        };
+        postCb((void*)&postProcessData);
+
+        sigId = postProcessData.mSigId;
+        sigType = postProcessData.mSigType;
+        numArgs = postProcessData.mNumArgs;
+        args = postProcessData.mArgs;
+    }
+
+    // Apply actions, call tuneSignal
+    this->ApplyActions(sigId, sigType, pid, tgid, numArgs, args);
+}
+
+// Expects mApplyMutex to be held.
+// Applies the background variant of the app's workload Signal, if one is configured. The
+// focused app's profile is left as is, these actions are tied to the app's own lifetime.
+void ContextualClassifier::ApplyBackgroundApp(pid_t pid,
+                                              pid_t tgid,
+                                              const std::string& comm,
+                                              int32_t contextType) {
+    uint32_t sigId = 0;
+    uint32_t sigType = DEFAULT_SIGNAL_TYPE;
+    GetActionSignal(contextType, false, sigId, sigType);
+
+    // Not every workload needs background actions, skip quietly if none are configured.
+    uint64_t signalCode = ((uint64_t)sigId << 32) | sigType;
+    if(SignalRegistry::getInstance()->getSignalTableIndex(signalCode) == -1) {
+        return;
+    }
+
+    // Re-classified (for ex. exec'd again), drop the actions applied for the previous image.
+    this->RemoveBackgroundActions(pid);
+
+    Request* request = createTuneRequestFromSignal(sigId, sigType, pid, tgid, 0, nullptr);
+    if(request != nullptr) {
+        if(request->getResourcesCount() > 0) {
+            LOGD(CLASSIFIER_TAG,
+                 "Applying background actions for: " + comm + " (" + std::to_string(pid) + ")");
+            this->mBackgroundHandles[pid].push_back(request->getHandle());
+
+            // fast path to Request Queue
+            submitResProvisionRequest(request, false);
+
+        } else {
+            Request::cleanUpRequest(request);
+        }
+    }
+}
+
+// Expects mApplyMutex to be held.
+void ContextualClassifier::RemoveBackgroundActions(pid_t pid) {
+    auto it = this->mBackgroundHandles.find(pid);
+    if(it == this->mBackgroundHandles.end()) {
+        return;
+    }
+
+    for(int64_t handle: it->second) {
+        if(handle > 0) {
+            this->untuneRequestHelper(handle);
+        }
+    }
+    this->mBackgroundHandles.erase(it);
+}
+
+void ContextualClassifier::HandleFocusHint(pid_t pid) {
+    int8_t needsClassification = false;
+    // The hint supersedes every event received before it.
+    uint64_t seq = this->mArrivalSeq.fetch_add(1) + 1;
+
+    {
+        const std::lock_guard<std::mutex> applyLock(this->mApplyMutex);
+        ClassifiedApp app;
+        FocusAction action = this->mFocusTracker.onFocusHint(pid, app);
+        if(action == FOCUS_UNCHANGED) {
+            return;
+        }
+
+        if(action == FOCUS_SWITCH) {
+            this->ApplyFocusedApp(pid, app.tgid, app.comm, app.contextType, seq);
+            return;
+        }
 
-                // Apply actions, call tuneSignal
-                this->ApplyActions(sigId, sigType, ev.pid, ev.tgid, numArgs, args);
+        // Not classified (yet), the previous app's actions no longer apply. If a
+        // classification is underway, its result is applied once it completes.
+        for(int64_t handle: this->mCurrRestuneHandles) {
+            if(handle > 0) {
+                this->untuneRequestHelper(handle);
             }
-        } else if(ev.type == CC_APP_CLOSE) {
-            // No Action Needed, Pulse Monitor to take care of cleanup
-            ClientGarbageCollector::getInstance()->submitClientForCleanup(ev.pid);
-            ClientDataManager::getInstance()->deleteClientPID(ev.pid);
+        }
+        this->mCurrRestuneHandles.clear();
+        this->SetFocusedAppRules(-1, "", {});
+        needsClassification = true;
+    }
+
+    // For ex. the app was launched before the Server, or was evicted from the pid cache.
+    if(needsClassification && AuxRoutines::fileExists(COMM(pid))) {
+        const std::lock_guard<std::mutex> lock(this->mQueueMutex);
+        if(!this->mClassifierPidCache.isPresent(pid) && this->mSettlingPids.count(pid) == 0) {
+            ProcEvent ev{};
+            ev.pid = pid;
+            ev.tgid = pid;
+            ev.type = CC_APP_OPEN;
+            ev.seq = seq;
+            this->mClassifierPidCache.insert(pid);
+            this->QueueEvent(ev);
         }
     }
 }
@@ -317,10 +522,22 @@ void ContextualClassifier::ClassifierMain() {
 int32_t ContextualClassifier::HandleProcEv() {
     pthread_setname_np(pthread_self(), "urmNetlinkListener");
     int32_t rc = 0;
+    uint64_t indexedOverruns = 0;
+    std::chrono::steady_clock::time_point lastResync = std::chrono::steady_clock::now();
 
     while(!this->mNeedExit) {
         ProcEvent ev{};
         rc = mNetLinkComm.recvEvent(ev);
+
+        // Events were lost (ENOBUFS), so the index may be missing renames and exits.
+        if(this->mNetLinkComm.getOverrunCount() != indexedOverruns &&
+           std::chrono::steady_clock::now() - lastResync >=
+               std::chrono::milliseconds(CLASSIFIER_INDEX_RESYNC_INTERVAL_MS)) {
+            indexedOverruns = this->mNetLinkComm.getOverrunCount();
+            lastResync = std::chrono::steady_clock::now();
+            this->ResyncProcessIndex();
+        }
+
         if(rc == CC_IGNORE) {
             continue;
         }
@@ -337,6 +554,44 @@ int32_t ContextualClassifier::HandleProcEv() {
             return -1;
         }
 
+        if(rc == CC_TASK_FORK) {
+            // Recorded at fork, so that a child which only renames itself (and never
+            // execs) is still known to be the app's descendant.
+            this->mProcessIndex.recordFork(ev.pid, ev.ppid);
+            continue;
+        }
+
+        // Classification results are applied in the order of arrival.
+        ev.seq = this->mArrivalSeq.fetch_add(1) + 1;
+
+        // The index tracks every task, including the ones filtered out below.
+        if(rc == CC_APP_CLOSE) {
+            this->mProcessIndex.remove(ev.pid);
+        } else {
+            this->mProcessIndex.update(ev.pid, ev.tgid, ev.comm);
+            if(rc != CC_TASK_RENAME && ev.pid == ev.tgid) {
+                // Needed to scope thread rules to the app's descendants.
+                pid_t ppid = ProcessIndex::readParent(ev.pid);
+                if(ppid >= 0) {
+                    this->mProcessIndex.setParent(ev.pid, ppid);
+                }
+            }
+            this->PlaceAppThread(ev);
+            if(rc != CC_APP_OPEN) {
+                continue;
+            }
+        }
+
+        if(rc == CC_APP_CLOSE && this->mSettleDelayMs > 0) {
+            // Exited within the settle delay, drop the pending classification. This is
+            // checked before the liveness check below, since the pid may already be reaped.
+            const std::lock_guard<std::mutex> lock(mQueueMutex);
+            if(this->mSettlingPids.erase(ev.pid) > 0) {
+                this->mSettleCancelCount++;
+                continue;
+            }
+        }
+
         // Process still up?
         if(!AuxRoutines::fileExists(COMM(ev.pid))) {
             continue;
@@ -346,16 +601,33 @@ int32_t ContextualClassifier::HandleProcEv() {
             case CC_APP_OPEN:
                 if(!this->shouldProcBeIgnored(ev.type, ev.pid)) {
                     const std::lock_guard<std::mutex> lock(mQueueMutex);
-                    if(this->mClassifierPidCache.isPresent(ev.pid)) {
+                    if(this->mClassifierPidCache.isPresent(ev.pid) ||
+                       this->mSettlingPids.count(ev.pid) > 0) {
                         // Duplicate Notification, skip.
                         break;
                     }
-                    this->mPendingEv.push(ev);
-                    this->mClassifierPidCache.insert(ev.pid);
-                    if(this->mPendingEv.size() > pendingQueueControlSize) {
-                        this->mPendingEv.pop();
+
+                    if(this->mSettleDelayMs == 0) {
+                        this->mClassifierPidCache.insert(ev.pid);
+                        this->QueueEvent(ev);
+                        break;
+                    }
+
+                    // Hold the event back, it is queued for classification only if the
+                    // process is still around once the settle delay elapses. Short-lived
+                    // processes hence never enter mClassifierPidCache or mEventQueue.
+                    SettlingEvent settlingEv;
+                    settlingEv.deadline = std::chrono::steady_clock::now() +
+                                          std::chrono::milliseconds(this->mSettleDelayMs);
+                    settlingEv.seq = ++this->mSettleSeq;
+                    settlingEv.ev = ev;
+
+                    this->mSettlingPids[ev.pid] = settlingEv.seq;
+                    this->mSettlingEv.push_back(settlingEv);
+                    if(this->mSettlingEv.size() == 1) {
+                        // Let the worker pick up the new deadline.
+                        this->mQueueCond.notify_one();
                     }
-                    this->mQueueCond.notify_one();
                 }
 
                 break;
@@ -363,11 +635,7 @@ int32_t ContextualClassifier::HandleProcEv() {
             case CC_APP_CLOSE:
                 if(!this->shouldProcBeIgnored(ev.type, ev.pid)) {
                     const std::lock_guard<std::mutex> lock(mQueueMutex);
-                    this->mPendingEv.push(ev);
-                    if(this->mPendingEv.size() > pendingQueueControlSize) {
-                        this->mPendingEv.pop();
-                    }
-                    this->mQueueCond.notify_one();
+                    this->QueueEvent(ev);
                 }
 
                 break;
@@ -380,6 +648,39 @@ int32_t ContextualClassifier::HandleProcEv() {
     return 0;
 }
 
+// Expects mQueueMutex to be held.
+void ContextualClassifier::QueueEvent(const ProcEvent& ev) {
+    this->mEventQueue.push(ev);
+    this->mQueueCond.notify_one();
+}
+
+// Expects mQueueMutex to be held.
+// The settle delay is the same for all the events, hence mSettlingEv is ordered by deadline.
+void ContextualClassifier::PromoteSettledEvents() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    while(!this->mSettlingEv.empty() && this->mSettlingEv.front().deadline <= now) {
+        SettlingEvent settlingEv = this->mSettlingEv.front();
+        this->mSettlingEv.pop_front();
+
+        auto it = this->mSettlingPids.find(settlingEv.ev.pid);
+        if(it == this->mSettlingPids.end() || it->second != settlingEv.seq) {
+            // Cancelled by the EXIT event, or superseded by a later exec of the same pid.
+            continue;
+        }
+        this->mSettlingPids.erase(it);
+
+        // The EXIT event may have been lost (for ex. receive queue overrun).
+        if(!AuxRoutines::fileExists(COMM(settlingEv.ev.pid))) {
+            this->mSettleCancelCount++;
+            continue;
+        }
+
+        this->mClassifierPidCache.insert(settlingEv.ev.pid);
+        this->QueueEvent(settlingEv.ev);
+    }
+}
+
 int32_t ContextualClassifier::ClassifyProcess(pid_t processPid,
                                               pid_t processTgid,
                                               const std::string &comm,
@@ -396,12 +697,30 @@ int32_t ContextualClassifier::ClassifyProcess(pid_t processPid,
         return CC_IGNORE;
     }
 
+    // Relaunch of an already classified executable, skip extraction and inference.
+    ExeIdentity identity;
+    int8_t identityResolved = ClassificationCache::getExeIdentity(processPid, identity);
+    int32_t cachedContext = CC_IGNORE;
+    if(identityResolved && this->mClassificationCache.lookup(identity, cachedContext)) {
+        LOGD(CLASSIFIER_TAG,
+             "Using cached classification for PID: "
+                + std::to_string(processPid)
+                + ", " + comm
+            );
+        return cachedContext;
+    }
+
     LOGD(CLASSIFIER_TAG,
          "Starting classification for PID: "
             + std::to_string(processPid)
             + ", " + comm
         );
     context = mInference->Classify(processPid);
+
+    // Classify falls back to CC_APP if the process exits midway, such results aren't cached.
+    if(identityResolved && AuxRoutines::fileExists(COMM(processPid))) {
+        this->mClassificationCache.insert(identity, context);
+    }
     return context;
 }
 
@@ -434,6 +753,14 @@ void ContextualClassifier::RemoveActions(pid_t processPid, pid_t processTgid) {
     return;
 }
 
+void ContextualClassifier::GetActionSignal(int32_t contextType,
+                                           int8_t isFocused,
+                                           uint32_t& sigId,
+                                           uint32_t& sigType) {
+    sigId = GetSignalIDForWorkload(contextType);
+    sigType = isFocused ? DEFAULT_SIGNAL_TYPE : BACKGROUND_SIGNAL_TYPE;
+}
+
 uint32_t ContextualClassifier::GetSignalIDForWorkload(int32_t contextType) {
     switch(contextType) {
         case CC_MULTIMEDIA:
@@ -450,6 +777,87 @@ uint32_t ContextualClassifier::GetSignalIDForWorkload(int32_t contextType) {
     return URM_SIG_APP_OPEN;
 }
 
+void ContextualClassifier::LoadClassificationCache() {
+    std::string resultBuffer;
+
+    submitPropGetRequest(CLASSIFIER_CACHE_SIZE, resultBuffer,
+                         std::to_string(CLASSIFICATION_CACHE_DEFAULT_SIZE));
+    try {
+        int32_t cacheSize = std::stoi(resultBuffer);
+        if(cacheSize > 0) {
+            this->mClassificationCache.setMaxEntries(cacheSize);
+        }
+    } catch(const std::exception& e) {
+        LOGW(CLASSIFIER_TAG, "Invalid classification cache size: " + resultBuffer);
+    }
+
+    submitPropGetRequest(CLASSIFIER_CACHE_PERSIST, resultBuffer, "false");
+    this->mPersistClassificationCache = (resultBuffer == "true");
+
+    if(this->mPersistClassificationCache) {
+        this->mClassificationCache.setModelIdentity(FT_MODEL_PATH);
+        std::string cachePath = CLASSIFICATION_CACHE_PATH;
+        mkdir(cachePath.substr(0, cachePath.find_last_of('/')).c_str(), 0755);
+        this->mClassificationCache.load(cachePath);
+    }
+}
+
+void ContextualClassifier::LoadSettleDelay() {
+    std::string resultBuffer;
+
+    submitPropGetRequest(CLASSIFIER_SETTLE_DELAY, resultBuffer,
+                         std::to_string(CLASSIFIER_DEFAULT_SETTLE_DELAY_MS));
+    try {
+        int32_t settleDelayMs = std::stoi(resultBuffer);
+        if(settleDelayMs >= 0) {
+            this->mSettleDelayMs = settleDelayMs;
+        }
+    } catch(const std::exception& e) {
+        LOGW(CLASSIFIER_TAG, "Invalid classification settle delay: " + resultBuffer);
+    }
+}
+
+void ContextualClassifier::LoadWorkerConfig() {
+    std::string resultBuffer;
+
+    submitPropGetRequest(CLASSIFIER_WORKER_COUNT, resultBuffer,
+                         std::to_string(CLASSIFIER_DEFAULT_WORKER_COUNT));
+    try {
+        int32_t workerCount = std::stoi(resultBuffer);
+        if(workerCount > 0) {
+            this->mWorkerCount = std::min(workerCount, CLASSIFIER_MAX_WORKER_COUNT);
+        }
+    } catch(const std::exception& e) {
+        LOGW(CLASSIFIER_TAG, "Invalid classifier worker count: " + resultBuffer);
+    }
+
+    submitPropGetRequest(CLASSIFIER_QUEUE_SIZE, resultBuffer,
+                         std::to_string(CLASSIFIER_DEFAULT_QUEUE_SIZE));
+    try {
+        int32_t queueSize = std::stoi(resultBuffer);
+        if(queueSize > 0) {
+            this->mEventQueue.setMaxSize(queueSize);
+        }
+    } catch(const std::exception& e) {
+        LOGW(CLASSIFIER_TAG, "Invalid classifier queue size: " + resultBuffer);
+    }
+
+    LOGI(CLASSIFIER_TAG,
+         "Classifier workers: " + std::to_string(this->mWorkerCount) +
+         ", queue size: " + std::to_string(this->mEventQueue.getMaxSize()));
+}
+
+void ContextualClassifier::LoadModelConfig() {
+    std::string resultBuffer;
+
+    submitPropGetRequest(CLASSIFIER_MODEL_WARMUP, resultBuffer, "true");
+    this->mWarmUpModel = (resultBuffer == "true");
+
+    LOGI(CLASSIFIER_TAG,
+         "Model load time: " + std::to_string(this->mInference->GetLoadTimeMs()) +
+         " ms, model matrices: " + std::to_string(this->mInference->GetMatrixKb()) + " kB");
+}
+
 void ContextualClassifier::LoadIgnoredProcesses() {
     int8_t isAllowedListPresent = false;
     std::string filePath = ALLOW_LIST_PATH;
@@ -516,67 +924,163 @@ int8_t ContextualClassifier::shouldProcBeIgnored(int32_t evType, pid_t pid) {
     return false;
 }
 
+static Request* createPlacementRequest(pid_t incomingPID, pid_t incomingTID) {
+    Request* request = MPLACED(Request);
+    request->setRequestType(REQ_RESOURCE_TUNING);
+
+    // Generate and store the handle for future use
+    request->setHandle(AuxRoutines::generateUniqueHandle());
+    request->setDuration(-1);
+    request->setPriority(SYSTEM_LOW);
+    request->setClientPID(incomingPID);
+    request->setClientTID(incomingTID);
+    return request;
+}
+
+// Expects mApplyMutex to be held.
+void ContextualClassifier::submitPlacementRequest(Request* request) {
+    // Anything to issue
+    if(request->getResourcesCount() > 0) {
+        // Record:
+        this->mCurrRestuneHandles.push_back(request->getHandle());
+
+        // fast path to Request Queue
+        submitResProvisionRequest(request, true);
+
+    } else {
+        Request::cleanUpRequest(request);
+    }
+}
+
 void ContextualClassifier::MoveAppThreadsToCGroup(pid_t incomingPID,
                                                   pid_t incomingTID,
                                                   const std::string& comm,
                                                   int32_t cgroupIdentifier) {
+    std::vector<ThreadPlacementRule> threadRules;
+
     try {
-        int64_t handleGenerated = -1;
         // Issue a tune request for the new pid (and any associated app-config pids)
-        Request* request = MPLACED(Request);
-        request->setRequestType(REQ_RESOURCE_TUNING);
-
-        // Generate and store the handle for future use
-        handleGenerated = AuxRoutines::generateUniqueHandle();
-        request->setHandle(handleGenerated);
-        request->setDuration(-1);
-        request->setPriority(SYSTEM_LOW);
-        request->setClientPID(incomingPID);
-        request->setClientTID(incomingTID);
+        Request* request = createPlacementRequest(incomingPID, incomingTID);
 
         // Move the incoming pid
         ResIterable* resIter = createMovePidResource(cgroupIdentifier, incomingPID);
         request->addResource(resIter);
 
-        AppConfig* appConfig = AppConfigs::getInstance()->getAppConfig(comm);
+        // Hold the generation, appConfig must stay valid across a Config reload.
+        std::shared_ptr<AppConfigs> appConfigs = AppConfigs::getInstance();
+        AppConfig* appConfig = appConfigs->getAppConfig(comm);
         if(appConfig != nullptr && appConfig->mThreadNameList != nullptr) {
             int32_t numThreads = appConfig->mNumThreads;
-            // Go over the list of proc names (comm) and get their pids
+            // Go over the list of thread names (comm) and look up the matching tasks
             for(int32_t i = 0; i < numThreads; i++) {
                 std::string targetComm = appConfig->mThreadNameList[i];
-                pid_t targetPID = AuxRoutines::fetchPid(targetComm);
-                if(targetPID != -1 && targetPID != incomingPID) {
-                    // Get the CGroup
-                    int32_t currCGroupID = appConfig->mCGroupIds[i];
-                    request->addResource(createMovePidResource(currCGroupID, targetPID));
+                int32_t currCGroupID = appConfig->mCGroupIds[i];
+                threadRules.push_back({targetComm, currCGroupID});
+
+                for(pid_t targetPID: this->mProcessIndex.findTasks(targetComm, incomingPID)) {
+                    if(targetPID != incomingPID) {
+                        request->addResource(createMovePidResource(currCGroupID, targetPID));
+                    }
                 }
             }
         }
 
-        // Anything to issue
-        if(request->getResourcesCount() > 0) {
-            // Record:
-            this->mCurrRestuneHandles.push_back(request->getHandle());
+        this->submitPlacementRequest(request);
 
-            // fast path to Request Queue
-            submitResProvisionRequest(request, true);
+    } catch(const std::exception& e) {
+        LOGE(CLASSIFIER_TAG,
+             "Failed to move per-app threads to cgroup, Error: " + std::string(e.what()));
+    }
 
-        } else {
-            Request::cleanUpRequest(request);
+    // Threads which show up (or get renamed) from here on are placed by PlaceAppThread.
+    this->SetFocusedAppRules(incomingPID, comm, std::move(threadRules));
+}
+
+// Expects mApplyMutex to be held.
+void ContextualClassifier::SetFocusedAppRules(pid_t tgid,
+                                              const std::string& comm,
+                                              std::vector<ThreadPlacementRule> threadRules) {
+    const std::lock_guard<std::mutex> lock(this->mFocusedAppMutex);
+    this->mFocusedTgid = tgid;
+    this->mFocusedComm = comm;
+    this->mFocusedThreadRules = std::move(threadRules);
+}
+
+void ContextualClassifier::PlaceAppThread(const ProcEvent& ev) {
+    pid_t focusedTgid = -1;
+    int32_t cgroupId = -1;
+
+    // Runs on the netlink listener for every exec and rename, so the common case (no
+    // rule matches) is settled against the snapshot alone.
+    {
+        const std::lock_guard<std::mutex> lock(this->mFocusedAppMutex);
+        if(this->mFocusedTgid == -1 || ev.pid == this->mFocusedTgid) {
+            return;
+        }
+
+        for(const ThreadPlacementRule& rule: this->mFocusedThreadRules) {
+            if(std::strstr(ev.comm, rule.mThreadName.c_str()) != nullptr) {
+                cgroupId = rule.mCGroupId;
+                break;
+            }
+        }
+        focusedTgid = this->mFocusedTgid;
+    }
+
+    if(cgroupId == -1) {
+        return;
+    }
+
+    // Same scope as ProcessIndex::findTasks: the app's own threads, or its descendants.
+    if(ev.tgid != focusedTgid && !this->mProcessIndex.isDescendant(ev.tgid, focusedTgid)) {
+        return;
+    }
+
+    try {
+        const std::lock_guard<std::mutex> applyLock(this->mApplyMutex);
+        // Focus may have moved on meanwhile, the handles belong to the app in effect.
+        if(focusedTgid != this->mFocusedTgid) {
+            return;
         }
 
+        Request* request = createPlacementRequest(focusedTgid, ev.pid);
+        request->addResource(createMovePidResource(cgroupId, ev.pid));
+        this->submitPlacementRequest(request);
+
+        LOGD(CLASSIFIER_TAG,
+             "Placed thread " + std::string(ev.comm) + " (" + std::to_string(ev.pid) + ") of " +
+             this->mFocusedComm);
+
     } catch(const std::exception& e) {
         LOGE(CLASSIFIER_TAG,
-             "Failed to move per-app threads to cgroup, Error: " + std::string(e.what()));
+             "Failed to place per-app thread, Error: " + std::string(e.what()));
     }
 }
 
+void ContextualClassifier::ResyncProcessIndex() {
+    // A walk is already underway, it picks up the current state anyway.
+    if(this->mIndexResyncRunning.exchange(true)) {
+        return;
+    }
+
+    if(this->mIndexResyncThread.joinable()) {
+        this->mIndexResyncThread.join();
+    }
+
+    this->mIndexResyncThread = std::thread([this] {
+        pthread_setname_np(pthread_self(), "urmIndexResync");
+        this->mProcessIndex.populate();
+        this->mIndexResyncRunning = false;
+    });
+}
+
 void ContextualClassifier::configureAppSignals(pid_t incomingPID,
                                                pid_t incomingTID,
                                                const std::string& comm) {
     try {
         // Configure any associated signal
-        AppConfig* appConfig = AppConfigs::getInstance()->getAppConfig(comm);
+        std::shared_ptr<AppConfigs> appConfigs = AppConfigs::getInstance();
+        AppConfig* appConfig = appConfigs->getAppConfig(comm);
         if(appConfig != nullptr && appConfig->mSignalCodes != nullptr) {
             int32_t numSignals = appConfig->mNumSignals;
             // Go over the list of proc names (comm) and get their pids
@@ -8,21 +8,46 @@
 #include <algorithm>
 #include <cerrno>
 #include <chrono>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstring>
+#include <deque>
 #include <dirent.h>
 #include <fstream>
+#include <future>
 #include <iostream>
-#include <regex>
+#include <mutex>
 #include <sstream>
 #include <sys/stat.h>
+#include <thread>
 #include <unistd.h>
 
+#ifdef USE_SD_JOURNAL
+#include <systemd/sd-journal.h>
+#endif
+
 #define PRUNED_DIR "/var/cache/pruned"
 #define UNFILTERED_DIR "/var/cache/unfiltered"
 #define SCANNER_TAG "FeatureExtractor"
 #define LOG_LINES 20
 
+// Journal reads are on the path between an EXEC event and the app being moved
+// into its cgroup, hence they are bounded in time and cached per comm.
+#define JOURNAL_READ_BUDGET_MS 15
+#define JOURNAL_CACHE_TTL_MS 60000
+#define JOURNAL_CACHE_MAX_ENTRIES 128
+
+// Bounds on feature collection, so that classification latency does not grow with the
+// size of the process. map_files, fd and the journal are collected concurrently with
+// the other sources, each within the per-source budget, all within the total budget.
+#define FEATURE_SOURCE_BUDGET_MS 25
+#define FEATURE_COLLECTION_BUDGET_MS 60
+#define FEATURE_MAX_DIR_ENTRIES 4096
+// Directory scans check the deadline once per these many entries.
+#define FEATURE_DEADLINE_CHECK_INTERVAL 64
+
+typedef std::chrono::steady_clock::time_point Deadline;
+
 std::unordered_map<std::string, std::unordered_set<std::string>> FeatureExtractor::mTokenIgnoreMap;
 
 static std::string format_string(const char *fmt, ...) {
@@ -51,6 +76,22 @@ std::string join_vector(const std::vector<std::string> &vec) {
     return res;
 }
 
+static Deadline getSourceDeadline(Deadline collectionDeadline) {
+    return std::min(std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(FEATURE_SOURCE_BUDGET_MS),
+                    collectionDeadline);
+}
+
+// Run the source on its own thread, or inline (on get) if a thread can't be created.
+template <typename Callable>
+static std::future<std::vector<std::string>> launchSource(Callable source) {
+    try {
+        return std::async(std::launch::async, source);
+    } catch (const std::system_error &e) {
+        return std::async(std::launch::deferred, source);
+    }
+}
+
 int FeatureExtractor::CollectAndStoreData( pid_t pid,
     std::map<std::string, std::string> &output_data, int8_t dump_csv) {
     if (!IsValidPidViaProc(pid)) {
@@ -59,6 +100,22 @@ int FeatureExtractor::CollectAndStoreData( pid_t pid,
         return 1;
     }
 
+    Deadline collectionDeadline = std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(FEATURE_COLLECTION_BUDGET_MS);
+
+    std::future<std::vector<std::string>> mapsFuture =
+        launchSource([pid, collectionDeadline] {
+            return ParseMapFiles(pid, "/()_:.", getSourceDeadline(collectionDeadline));
+        });
+    std::future<std::vector<std::string>> fdsFuture =
+        launchSource([pid, collectionDeadline] {
+            return ParseFd(pid, ":[]/()=", getSourceDeadline(collectionDeadline));
+        });
+    std::future<std::vector<std::string>> journalFuture =
+        launchSource([pid] {
+            return ReadJournalForPid(pid, LOG_LINES);
+        });
+
     std::string delimiters = ".:";
     std::vector<std::string> context = ParseAttrCurrent(pid, delimiters);
     std::vector<std::string> lowerContext =
@@ -104,12 +161,11 @@ int FeatureExtractor::CollectAndStoreData( pid_t pid,
     FeaturePruner::normalize_numbers_inplace(filtered_comm);
 
     t1 = std::chrono::high_resolution_clock::now();
-    delimiters = "/()_:.";
-    std::vector<std::string> maps = ParseMapFiles(pid, delimiters);
+    std::vector<std::string> maps = mapsFuture.get();
     t2 = std::chrono::high_resolution_clock::now();
     LOGD(SCANNER_TAG,
          format_string(
-             "maps took %f ms",
+             "maps waited for %f ms",
              std::chrono::duration<double, std::milli>(t2 - t1).count()));
 
     std::vector<std::string> lowermaps = FeaturePruner::toLowercaseVector(maps);
@@ -120,12 +176,11 @@ int FeatureExtractor::CollectAndStoreData( pid_t pid,
     FeaturePruner::normalize_numbers_inplace(filtered_maps);
 
     t1 = std::chrono::high_resolution_clock::now();
-    delimiters = ":[]/()=";
-    std::vector<std::string> fds = ParseFd(pid, delimiters);
+    std::vector<std::string> fds = fdsFuture.get();
     t2 = std::chrono::high_resolution_clock::now();
     LOGD(SCANNER_TAG,
          format_string(
-             "fds took %f ms",
+             "fds waited for %f ms",
              std::chrono::duration<double, std::milli>(t2 - t1).count()));
 
     std::vector<std::string> lowerfds = FeaturePruner::toLowercaseVector(fds);
@@ -160,17 +215,17 @@ int FeatureExtractor::CollectAndStoreData( pid_t pid,
 
     delimiters = "=!'&/.,:- ";
     t1 = std::chrono::high_resolution_clock::now();
-    auto journalctl_logs = ReadJournalForPid(pid, LOG_LINES);
-    if (journalctl_logs.empty()) {
+    auto journal_logs = journalFuture.get();
+    if (journal_logs.empty()) {
         LOGD(SCANNER_TAG, format_string("No logs found for PID %d", pid));
     }
     t2 = std::chrono::high_resolution_clock::now();
     LOGD(SCANNER_TAG,
          format_string(
-             "journalctl took %f ms",
+             "journal waited for %f ms",
              std::chrono::duration<double, std::milli>(t2 - t1).count()));
 
-    auto extracted_Logs = ExtractProcessNameAndMessage(journalctl_logs);
+    auto extracted_Logs = ExtractProcessNameAndMessage(journal_logs);
     std::vector<std::string> logs;
     for (const auto &entry : extracted_Logs) {
         auto tokens = ParseLog(entry, delimiters);
@@ -323,15 +378,14 @@ std::vector<std::string>
 FeatureExtractor::ParseAttrCurrent(const uint32_t pid,
                                    const std::string &delimiters) {
     std::vector<std::string> context_parts;
-    std::string path = "/proc/" + std::to_string(pid) + "/attr/current";
-    std::ifstream infile(path);
-    if (!infile.is_open()) {
-        LOGE(SCANNER_TAG, format_string("Failed to open %s", path.c_str()));
+    std::string_view contents;
+    if (!AuxRoutines::readProcFile(pid, "attr/current", contents)) {
+        LOGE(SCANNER_TAG, format_string("Failed to open /proc/%u/attr/current", pid));
         return context_parts;
     }
-    std::string line;
-    if (std::getline(infile, line)) {
-        line = std::regex_replace(line, std::regex(R"(\s*\(enforce\))"), "");
+    if (!contents.empty()) {
+        std::string line =
+            FeaturePruner::removeEnforceMarker(AuxRoutines::firstLine(contents));
         context_parts = FeaturePruner::splitString(line, delimiters);
     }
     return context_parts;
@@ -340,17 +394,17 @@ FeatureExtractor::ParseAttrCurrent(const uint32_t pid,
 std::vector<std::string>
 FeatureExtractor::ParseCgroup(pid_t pid, const std::string &delimiters) {
     std::vector<std::string> tokens;
-    std::string path = "/proc/" + std::to_string(pid) + "/cgroup";
-    std::ifstream infile(path);
-    if (!infile.is_open()) {
-        LOGE(SCANNER_TAG, format_string("Failed to open %s", path.c_str()));
+    std::string_view contents;
+    if (!AuxRoutines::readProcFile(pid, "cgroup", contents)) {
+        LOGE(SCANNER_TAG, format_string("Failed to open /proc/%d/cgroup", pid));
         return tokens;
     }
-    std::string line;
-    while (std::getline(infile, line)) {
+    while (!contents.empty()) {
+        std::string_view line = AuxRoutines::firstLine(contents);
         std::vector<std::string> lineTokens =
             FeaturePruner::splitString(line, delimiters);
         tokens.insert(tokens.end(), lineTokens.begin(), lineTokens.end());
+        contents.remove_prefix(std::min(line.size() + 1, contents.size()));
     }
     return tokens;
 }
@@ -358,19 +412,16 @@ FeatureExtractor::ParseCgroup(pid_t pid, const std::string &delimiters) {
 std::vector<std::string>
 FeatureExtractor::ParseCmdline(pid_t pid, const std::string &delimiters) {
     std::vector<std::string> tokens;
-    std::string path = "/proc/" + std::to_string(pid) + "/cmdline";
-    std::ifstream infile(path, std::ios::binary);
-    if (!infile.is_open()) {
-        LOGE(SCANNER_TAG, format_string("Failed to open %s", path.c_str()));
+    std::string_view content;
+    if (!AuxRoutines::readProcFile(pid, "cmdline", content)) {
+        LOGE(SCANNER_TAG, format_string("Failed to open /proc/%d/cmdline", pid));
         return tokens;
     }
-    std::string content((std::istreambuf_iterator<char>(infile)),
-                        std::istreambuf_iterator<char>());
     size_t start = 0;
     for (size_t i = 0; i < content.size(); ++i) {
         if (content[i] == '\0') {
             if (i > start) {
-                std::string arg = content.substr(start, i - start);
+                std::string_view arg = content.substr(start, i - start);
                 for (const auto &raw :
                      FeaturePruner::splitString(arg, delimiters)) {
                     std::string cleaned;
@@ -396,14 +447,12 @@ FeatureExtractor::ParseCmdline(pid_t pid, const std::string &delimiters) {
 std::vector<std::string>
 FeatureExtractor::ParseComm(pid_t pid, const std::string &delimiters) {
     std::vector<std::string> tokens;
-    std::string path = "/proc/" + std::to_string(pid) + "/comm";
-    std::ifstream infile(path);
-    if (!infile.is_open()) {
-        LOGE(SCANNER_TAG, format_string("Failed to open %s", path.c_str()));
+    std::string_view contents;
+    if (!AuxRoutines::readProcFile(pid, "comm", contents)) {
+        LOGE(SCANNER_TAG, format_string("Failed to open /proc/%d/comm", pid));
         return tokens;
     }
-    std::string comm;
-    std::getline(infile, comm);
+    std::string_view comm = AuxRoutines::firstLine(contents);
     for (const auto &t : FeaturePruner::splitString(comm, delimiters)) {
         std::string cleaned = FeaturePruner::trim(t);
         if (!cleaned.empty() && cleaned.size() > 1) {
@@ -413,8 +462,33 @@ FeatureExtractor::ParseComm(pid_t pid, const std::string &delimiters) {
     return tokens;
 }
 
+// Hash of the link target, entries pointing to an already seen target (for ex. the
+// many mappings of one library) are skipped before any string is built for them.
+static int8_t isNewLinkTarget(std::unordered_set<size_t> &seenTargets,
+                              const char *target, size_t len) {
+    return seenTargets.insert(std::hash<std::string_view>()(std::string_view(target, len))).second;
+}
+
+// Expects to be called once per directory entry, returns false once the scan should stop.
+static int8_t withinScanBudget(size_t entriesScanned, Deadline deadline,
+                               const std::string &dirPath) {
+    if (entriesScanned >= FEATURE_MAX_DIR_ENTRIES) {
+        LOGD(SCANNER_TAG, format_string("Entry limit reached, cutting off scan of %s",
+                                        dirPath.c_str()));
+        return false;
+    }
+    if (entriesScanned % FEATURE_DEADLINE_CHECK_INTERVAL == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+        LOGD(SCANNER_TAG, format_string("Time budget exceeded, cutting off scan of %s",
+                                        dirPath.c_str()));
+        return false;
+    }
+    return true;
+}
+
 std::vector<std::string>
-FeatureExtractor::ParseMapFiles(pid_t pid, const std::string &delimiters) {
+FeatureExtractor::ParseMapFiles(pid_t pid, const std::string &delimiters,
+                                Deadline deadline) {
     std::vector<std::string> results;
     std::string dir_path = "/proc/" + std::to_string(pid) + "/map_files";
     DIR *dir = opendir(dir_path.c_str());
@@ -422,28 +496,29 @@ FeatureExtractor::ParseMapFiles(pid_t pid, const std::string &delimiters) {
         LOGE(SCANNER_TAG, format_string("Failed to open %s", dir_path.c_str()));
         return results;
     }
+    std::unordered_set<size_t> seenTargets;
+    std::unordered_set<std::string> seenTokens;
+    size_t entriesScanned = 0;
     struct dirent *entry;
     char link_target[PATH_MAX];
     while ((entry = readdir(dir)) != nullptr) {
         if (entry->d_name[0] == '.')
             continue;
-        std::string link_path = dir_path + "/" + entry->d_name;
+        if (!withinScanBudget(entriesScanned++, deadline, dir_path))
+            break;
         ssize_t len =
-            readlink(link_path.c_str(), link_target, sizeof(link_target) - 1);
-        if (len != -1) {
-            link_target[len] = '\0';
-            std::string target_str(link_target);
-            for (const auto &tok :
-                 FeaturePruner::splitString(target_str, delimiters)) {
+            readlinkat(dirfd(dir), entry->d_name, link_target, sizeof(link_target) - 1);
+        if (len != -1 && isNewLinkTarget(seenTargets, link_target, len)) {
+            for (const auto &tok : FeaturePruner::splitString(
+                     std::string_view(link_target, len), delimiters)) {
                 std::string simplified =
                     FeaturePruner::normalizeLibraryName(tok);
                 if (simplified.empty() || simplified.size() <= 1)
                     continue;
                 if (FeaturePruner::isDigitsOnly(simplified))
                     continue;
-                if (std::find(results.begin(), results.end(), simplified) ==
-                    results.end()) {
-                    results.push_back(simplified);
+                if (seenTokens.insert(simplified).second) {
+                    results.push_back(std::move(simplified));
                 }
             }
         }
@@ -453,7 +528,8 @@ FeatureExtractor::ParseMapFiles(pid_t pid, const std::string &delimiters) {
 }
 
 std::vector<std::string>
-FeatureExtractor::ParseFd(pid_t pid, const std::string &delimiters) {
+FeatureExtractor::ParseFd(pid_t pid, const std::string &delimiters,
+                          Deadline deadline) {
     std::vector<std::string> results;
     std::string dir_path = "/proc/" + std::to_string(pid) + "/fd";
     DIR *dir = opendir(dir_path.c_str());
@@ -462,19 +538,21 @@ FeatureExtractor::ParseFd(pid_t pid, const std::string &delimiters) {
              format_string("Unable to open fd directory %s", dir_path.c_str()));
         return results;
     }
+    std::unordered_set<size_t> seenTargets;
+    std::unordered_set<std::string> seenTokens;
+    size_t entriesScanned = 0;
     struct dirent *entry;
     char link_target[PATH_MAX];
     while ((entry = readdir(dir)) != nullptr) {
         if (entry->d_name[0] == '.')
             continue;
-        std::string link_path = dir_path + "/" + entry->d_name;
+        if (!withinScanBudget(entriesScanned++, deadline, dir_path))
+            break;
         ssize_t len =
-            readlink(link_path.c_str(), link_target, sizeof(link_target) - 1);
-        if (len != -1) {
-            link_target[len] = '\0';
-            std::string target_str(link_target);
-            std::vector<std::string> tokens =
-                FeaturePruner::splitString(target_str, delimiters);
+            readlinkat(dirfd(dir), entry->d_name, link_target, sizeof(link_target) - 1);
+        if (len != -1 && isNewLinkTarget(seenTargets, link_target, len)) {
+            std::vector<std::string> tokens = FeaturePruner::splitString(
+                std::string_view(link_target, len), delimiters);
             for (const auto &tok : tokens) {
                 if (tok.empty())
                     continue;
@@ -486,9 +564,8 @@ FeatureExtractor::ParseFd(pid_t pid, const std::string &delimiters) {
                     std::all_of(cleaned.begin(), cleaned.end(), ::isdigit);
                 if (isNumber)
                     continue;
-                if (std::find(results.begin(), results.end(), cleaned) ==
-                    results.end()) {
-                    results.push_back(cleaned);
+                if (seenTokens.insert(cleaned).second) {
+                    results.push_back(std::move(cleaned));
                 }
             }
         }
@@ -500,14 +577,14 @@ FeatureExtractor::ParseFd(pid_t pid, const std::string &delimiters) {
 std::vector<std::string>
 FeatureExtractor::ParseEnviron(pid_t pid, const std::string &delimiters) {
     std::vector<std::string> out;
-    std::string path = "/proc/" + std::to_string(pid) + "/environ";
-    std::ifstream in(path, std::ios::binary);
-    if (!in) {
-        LOGE(SCANNER_TAG, format_string("Failed to open: %s", path.c_str()));
+    std::string_view contents;
+    if (!AuxRoutines::readProcFile(pid, "environ", contents)) {
+        LOGE(SCANNER_TAG, format_string("Failed to open: /proc/%d/environ", pid));
         return out;
     }
-    std::string entry;
-    while (std::getline(in, entry, '\0')) {
+    while (!contents.empty()) {
+        std::string_view entry = contents.substr(0, contents.find('\0'));
+        contents.remove_prefix(std::min(entry.size() + 1, contents.size()));
         if (entry.empty())
             continue;
         std::vector<std::string> tokens =
@@ -552,33 +629,250 @@ FeatureExtractor::ParseExe(pid_t pid, const std::string &delimiters) {
     return out;
 }
 
+typedef struct {
+    std::chrono::steady_clock::time_point mExpiry;
+    std::vector<std::string> mLines;
+} JournalCacheEntry;
+
+// Guards journalCache.
+static std::mutex journalMutex;
+static std::unordered_map<std::string, JournalCacheEntry> journalCache;
+
+static int8_t lookupJournalCache(const std::string &comm,
+                                 std::vector<std::string> &lines) {
+    auto it = journalCache.find(comm);
+    if (it == journalCache.end()) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() >= it->second.mExpiry) {
+        journalCache.erase(it);
+        return false;
+    }
+    lines = it->second.mLines;
+    return true;
+}
+
+static void updateJournalCache(const std::string &comm,
+                               const std::vector<std::string> &lines) {
+    auto now = std::chrono::steady_clock::now();
+    if (journalCache.size() >= JOURNAL_CACHE_MAX_ENTRIES) {
+        for (auto it = journalCache.begin(); it != journalCache.end();) {
+            if (now >= it->second.mExpiry) {
+                it = journalCache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (journalCache.size() >= JOURNAL_CACHE_MAX_ENTRIES) {
+            journalCache.erase(journalCache.begin());
+        }
+    }
+    journalCache[comm] = {now + std::chrono::milliseconds(JOURNAL_CACHE_TTL_MS),
+                          lines};
+}
+
+#ifdef USE_SD_JOURNAL
+// sd-journal objects must not be used from more than one thread over their
+// lifetime. The journal is opened (once, opening maps all of its files) and
+// read on a dedicated reader thread, the collection threads post their
+// queries to it.
+typedef struct {
+    std::string mComm;
+    uint32_t mNumLines;
+    std::promise<std::vector<std::string>> mLines;
+} JournalQuery;
+
+static std::mutex journalQueueMutex;
+static std::condition_variable journalQueueCond;
+static std::deque<JournalQuery *> journalQueue;
+static std::thread journalReader;
+static int8_t journalReaderRunning = false;
+static int8_t journalReaderStop = false;
+
+static std::string getJournalField(sd_journal *journal, const char *field) {
+    const void *data = nullptr;
+    size_t length = 0;
+    if (sd_journal_get_data(journal, field, &data, &length) < 0) {
+        return "";
+    }
+    // Data is returned as "FIELD=value"
+    size_t prefixLen = strlen(field) + 1;
+    if (length < prefixLen) {
+        return "";
+    }
+    return std::string((const char *)data + prefixLen, length - prefixLen);
+}
+
+// Runs on the reader thread.
+// Returns the last numLines entries for comm (oldest first), in the same
+// "<host> <identifier>[<pid>]: <message>" shape as journalctl's short output.
+static int8_t readJournal(sd_journal *journal, const std::string &comm,
+                          uint32_t numLines, std::vector<std::string> &lines) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(JOURNAL_READ_BUDGET_MS);
+
+    // Pick up journal files which were rotated in since the last read.
+    sd_journal_process(journal);
+    if (std::chrono::steady_clock::now() >= deadline) {
+        return false;
+    }
+
+    // Entries are matched on the syslog identifier (the name journalctl shows),
+    // as well as on _COMM, for processes which log under another identifier.
+    std::string identifierMatch = "SYSLOG_IDENTIFIER=" + comm;
+    std::string commMatch = "_COMM=" + comm;
+    sd_journal_flush_matches(journal);
+    if (sd_journal_add_match(journal, identifierMatch.c_str(),
+                             identifierMatch.length()) < 0 ||
+        sd_journal_add_disjunction(journal) < 0 ||
+        sd_journal_add_match(journal, commMatch.c_str(), commMatch.length()) < 0 ||
+        sd_journal_seek_tail(journal) < 0) {
+        return false;
+    }
+
+    int8_t withinBudget = true;
+    while (lines.size() < numLines && sd_journal_previous(journal) > 0) {
+        std::string message = getJournalField(journal, "MESSAGE");
+        if (!message.empty()) {
+            // Same fallbacks as journalctl.
+            std::string identifier = getJournalField(journal, "SYSLOG_IDENTIFIER");
+            if (identifier.empty()) {
+                identifier = getJournalField(journal, "_COMM");
+            }
+            std::string entryPid = getJournalField(journal, "SYSLOG_PID");
+            if (entryPid.empty()) {
+                entryPid = getJournalField(journal, "_PID");
+            }
+            lines.push_back(getJournalField(journal, "_HOSTNAME") + " " +
+                            identifier + "[" + entryPid + "]: " + message);
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            withinBudget = false;
+            break;
+        }
+    }
+
+    std::reverse(lines.begin(), lines.end());
+    return withinBudget;
+}
+
+static void journalReaderLoop() {
+    sd_journal *journal = nullptr;
+    int rc = sd_journal_open(&journal, SD_JOURNAL_LOCAL_ONLY);
+    if (rc < 0) {
+        journal = nullptr;
+        LOGE(SCANNER_TAG,
+             format_string("sd_journal_open failed: %s, process logs will not be used",
+                           strerror(-rc)));
+    }
+
+    std::unique_lock<std::mutex> lock(journalQueueMutex);
+    while (true) {
+        journalQueueCond.wait(lock, [] {
+            return journalReaderStop || !journalQueue.empty();
+        });
+        // Queries posted before the stop are still answered.
+        if (journalQueue.empty()) {
+            break;
+        }
+
+        JournalQuery *query = journalQueue.front();
+        journalQueue.pop_front();
+        lock.unlock();
+
+        std::vector<std::string> lines;
+        if (journal != nullptr &&
+            !readJournal(journal, query->mComm, query->mNumLines, lines)) {
+            // Whatever was read within the budget is used (and cached), so that
+            // a slow journal is not hit again for the same comm.
+            LOGD(SCANNER_TAG,
+                 format_string("Journal read budget exceeded for %s, %zu lines read",
+                               query->mComm.c_str(), lines.size()));
+        }
+        query->mLines.set_value(std::move(lines));
+
+        lock.lock();
+    }
+
+    if (journal != nullptr) {
+        sd_journal_close(journal);
+    }
+}
+#endif
+
+void FeatureExtractor::OpenJournal() {
+#ifdef USE_SD_JOURNAL
+    std::lock_guard<std::mutex> lock(journalQueueMutex);
+    if (journalReaderRunning) {
+        return;
+    }
+    journalReaderStop = false;
+    journalReader = std::thread(journalReaderLoop);
+    journalReaderRunning = true;
+#else
+    static int8_t logged = false;
+    if (!logged) {
+        LOGI(SCANNER_TAG,
+             "Built without libsystemd, process logs will not be used");
+        logged = true;
+    }
+#endif
+}
+
+void FeatureExtractor::CloseJournal() {
+#ifdef USE_SD_JOURNAL
+    {
+        std::lock_guard<std::mutex> lock(journalQueueMutex);
+        if (!journalReaderRunning) {
+            return;
+        }
+        journalReaderStop = true;
+    }
+    journalQueueCond.notify_all();
+    journalReader.join();
+
+    std::lock_guard<std::mutex> lock(journalQueueMutex);
+    journalReaderRunning = false;
+#endif
+}
+
 std::vector<std::string>
 FeatureExtractor::ReadJournalForPid(pid_t pid, uint32_t numLines) {
     std::vector<std::string> lines;
     std::string comm;
-    std::ifstream commFile("/proc/" + std::to_string(pid) + "/comm");
-    if (commFile.is_open()) {
-        std::getline(commFile, comm);
-        commFile.close();
-    } else {
+    if (AuxRoutines::fetchComm(pid, comm) != 0) {
         LOGE(SCANNER_TAG, format_string("Failed to open /proc/%d/comm", pid));
         return lines;
     }
-    std::string cmd = "journalctl --no-pager -n " + std::to_string(numLines) +
-                      " _COMM=" + comm;
-    FILE *pipe = popen(cmd.c_str(), "r");
-    if (!pipe) {
-        LOGE(SCANNER_TAG, format_string("popen failed: %s", strerror(errno)));
-        return lines;
-    }
-    char buffer[4096];
-    while (fgets(buffer, sizeof(buffer), pipe)) {
-        lines.emplace_back(buffer);
+
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        if (lookupJournalCache(comm, lines)) {
+            return lines;
+        }
     }
-    int rc = pclose(pipe);
-    if (rc == -1) {
-        LOGE(SCANNER_TAG, format_string("pclose failed: %s", strerror(errno)));
+
+#ifdef USE_SD_JOURNAL
+    JournalQuery query;
+    query.mComm = comm;
+    query.mNumLines = numLines;
+    std::future<std::vector<std::string>> result = query.mLines.get_future();
+    {
+        std::lock_guard<std::mutex> lock(journalQueueMutex);
+        if (!journalReaderRunning || journalReaderStop) {
+            return lines;
+        }
+        journalQueue.push_back(&query);
     }
+    journalQueueCond.notify_one();
+    lines = result.get();
+#else
+    (void)numLines;
+#endif
+
+    std::lock_guard<std::mutex> lock(journalMutex);
+    updateJournalCache(comm, lines);
     return lines;
 }
 
@@ -588,9 +882,7 @@ FeatureExtractor::ParseLog(const std::string &input,
     std::vector<std::string> tokens;
     std::string token;
     std::unordered_set<char> delimSet(delimiters.begin(), delimiters.end());
-    std::regex bracketedTag(R"(\[\s*(info|warn|error|debug|trace)?\s*\]?)",
-                            std::regex_constants::icase);
-    std::string cleaned_input = std::regex_replace(input, bracketedTag, "");
+    std::string cleaned_input = FeaturePruner::removeLogLevelTags(input);
     cleaned_input.erase(
         std::remove(cleaned_input.begin(), cleaned_input.end(), '\n'),
         cleaned_input.end());
@@ -622,13 +914,10 @@ FeatureExtractor::ParseLog(const std::string &input,
 std::vector<std::string> FeatureExtractor::ExtractProcessNameAndMessage(
     const std::vector<std::string> &journalLines) {
     std::vector<std::string> filtered;
-    std::regex pattern(R"(.*? (\S+)\[(\d+)\]: (.*))");
+    std::string formatted;
     for (const auto &line : journalLines) {
-        std::smatch match;
-        if (std::regex_search(line, match, pattern) && match.size() == 4) {
-            std::string processName = match[1];
-            std::string message = match[3];
-            filtered.push_back(processName + ": " + message);
+        if (FeaturePruner::formatJournalLine(line, formatted)) {
+            filtered.push_back(formatted);
         }
     }
     return filtered;
@@ -6,47 +6,122 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
-#include <regex>
 #include <sstream>
 
-static std::string escapeForCharClass(const std::string &d) {
-    std::string out;
-    out.reserve(d.size() * 2);
-    for (char c : d) {
-        switch (c) {
-        case '\\':
-        case ']':
-        case '^':
-        case '-':
-            out.push_back('\\');
-            [[fallthrough]];
-        default:
-            out.push_back(c);
+// Character classes, as std::regex (ECMAScript, "C" locale) defines them.
+static inline int8_t isDigitChar(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline int8_t isHexChar(char c) {
+    return isDigitChar(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// \w
+static inline int8_t isWordChar(char c) {
+    return isDigitChar(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '_';
+}
+
+// \s
+static inline int8_t isSpaceChar(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+           c == '\r';
+}
+
+static inline char toLowerChar(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// \b at position pos
+static inline int8_t isWordBoundary(std::string_view s, size_t pos) {
+    int8_t wordBefore = pos > 0 && isWordChar(s[pos - 1]);
+    int8_t wordAfter = pos < s.size() && isWordChar(s[pos]);
+    return wordBefore != wordAfter;
+}
+
+// Exactly count digits starting at pos.
+static inline int8_t hasDigitsAt(std::string_view s, size_t pos, size_t count) {
+    if (pos + count > s.size()) {
+        return false;
+    }
+    for (size_t i = pos; i < pos + count; ++i) {
+        if (!isDigitChar(s[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline size_t spaceRunAt(std::string_view s, size_t pos) {
+    size_t end = pos;
+    while (end < s.size() && isSpaceChar(s[end])) {
+        end++;
+    }
+    return end - pos;
+}
+
+static inline int8_t hasPrefixIcase(std::string_view s, size_t pos,
+                                    std::string_view prefix) {
+    if (pos + prefix.size() > s.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        if (toLowerChar(s[pos + i]) != prefix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A matcher returns the length of the match starting at pos, or 0 if there is none.
+typedef size_t (*TextMatcher)(std::string_view s, size_t pos);
+
+// Equivalent of std::regex_replace: non-overlapping matches, scanned left to right.
+static void replaceMatches(std::string_view in, TextMatcher matcher,
+                           std::string_view replacement, std::string &out) {
+    out.clear();
+    out.reserve(in.size());
+    size_t pos = 0;
+    while (pos < in.size()) {
+        size_t len = matcher(in, pos);
+        if (len > 0) {
+            out.append(replacement);
+            pos += len;
+        } else {
+            out.push_back(in[pos]);
+            pos++;
         }
     }
-    return out;
 }
 
 std::vector<std::string>
-FeaturePruner::splitString(const std::string &input,
-                           const std::string &delimiters) {
-    std::string regexPattern = "[" + escapeForCharClass(delimiters) + "]";
-    std::regex re(regexPattern);
-    std::sregex_token_iterator it(input.begin(), input.end(), re, -1);
-    std::sregex_token_iterator end;
+FeaturePruner::splitString(std::string_view input,
+                           std::string_view delimiters) {
+    int8_t isDelim[256] = {0};
+    for (char c : delimiters) {
+        isDelim[static_cast<unsigned char>(c)] = true;
+    }
+
     std::vector<std::string> result;
-    for (; it != end; ++it) {
-        if (!it->str().empty()) {
-            result.push_back(it->str());
+    size_t start = 0;
+    for (size_t i = 0; i <= input.size(); ++i) {
+        if (i == input.size() || isDelim[static_cast<unsigned char>(input[i])]) {
+            if (i > start) {
+                result.emplace_back(input.substr(start, i - start));
+            }
+            start = i + 1;
         }
     }
     return result;
 }
 
-std::string FeaturePruner::trim(const std::string &s) {
+std::string FeaturePruner::trim(std::string_view s) {
     size_t start = s.find_first_not_of(" \t\r\n");
     size_t end = s.find_last_not_of(" \t\r\n");
-    return (start == std::string::npos) ? "" : s.substr(start, end - start + 1);
+    return (start == std::string_view::npos)
+               ? ""
+               : std::string(s.substr(start, end - start + 1));
 }
 
 std::string FeaturePruner::normalizeLibraryName(const std::string &s) {
@@ -71,24 +146,289 @@ std::string FeaturePruner::normalizeLibraryName(const std::string &s) {
     return result;
 }
 
+// [-/.]
+static inline int8_t isDateSeparator(std::string_view s, size_t pos) {
+    return pos < s.size() && (s[pos] == '-' || s[pos] == '/' || s[pos] == '.');
+}
+
+// (\b\d{1,2}[-/.]\d{1,2}[-/.]\d{2,4}\b)|(\b\d{4}[-/.]\d{1,2}[-/.]\d{1,2}\b)
+static size_t matchNumericDate(std::string_view s, size_t pos) {
+    if (!isWordBoundary(s, pos)) {
+        return 0;
+    }
+
+    for (size_t day = 2; day >= 1; --day) {
+        if (!hasDigitsAt(s, pos, day) || !isDateSeparator(s, pos + day)) {
+            continue;
+        }
+        size_t monthPos = pos + day + 1;
+        for (size_t month = 2; month >= 1; --month) {
+            if (!hasDigitsAt(s, monthPos, month) ||
+                !isDateSeparator(s, monthPos + month)) {
+                continue;
+            }
+            size_t yearPos = monthPos + month + 1;
+            for (size_t year = 4; year >= 2; --year) {
+                if (hasDigitsAt(s, yearPos, year) &&
+                    isWordBoundary(s, yearPos + year)) {
+                    return yearPos + year - pos;
+                }
+            }
+        }
+    }
+
+    if (hasDigitsAt(s, pos, 4) && isDateSeparator(s, pos + 4)) {
+        size_t monthPos = pos + 5;
+        for (size_t month = 2; month >= 1; --month) {
+            if (!hasDigitsAt(s, monthPos, month) ||
+                !isDateSeparator(s, monthPos + month)) {
+                continue;
+            }
+            size_t dayPos = monthPos + month + 1;
+            for (size_t day = 2; day >= 1; --day) {
+                if (hasDigitsAt(s, dayPos, day) &&
+                    isWordBoundary(s, dayPos + day)) {
+                    return dayPos + day - pos;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+// jan(?:uary)?|feb(?:ruary)?|...|sep(?:t|tember)?|..., in the order the alternatives are tried.
+static const std::string_view kMonthNames[] = {
+    "january", "jan",  "february", "feb",  "march",     "mar",  "april",
+    "apr",     "may",  "june",     "jun",  "july",      "jul",  "august",
+    "aug",     "sept", "september", "sep", "october",   "oct",  "november",
+    "nov",     "december", "dec",
+};
+
+// (?:,\s*)?\s+\d{2,4}\b
+static size_t matchDateYearTail(std::string_view s, size_t pos) {
+    auto matchYear = [&s](size_t from) -> size_t {
+        size_t spaces = spaceRunAt(s, from);
+        for (size_t k = spaces; k >= 1; --k) {
+            size_t yearPos = from + k;
+            for (size_t year = 4; year >= 2; --year) {
+                if (hasDigitsAt(s, yearPos, year) &&
+                    isWordBoundary(s, yearPos + year)) {
+                    return yearPos + year;
+                }
+            }
+        }
+        return 0;
+    };
+
+    if (pos < s.size() && s[pos] == ',') {
+        size_t spaces = spaceRunAt(s, pos + 1);
+        for (size_t k = spaces + 1; k-- > 0;) {
+            size_t end = matchYear(pos + 1 + k);
+            if (end > 0) {
+                return end;
+            }
+        }
+    }
+    return matchYear(pos);
+}
+
+// \b(?:MONTH)\s+\d{1,2}(?:,\s*)?\s+\d{2,4}\b|\b\d{1,2}\s+(?:MONTH)(?:,\s*)?\s+\d{2,4}\b
+// Case insensitive.
+static size_t matchNamedDate(std::string_view s, size_t pos) {
+    if (!isWordBoundary(s, pos)) {
+        return 0;
+    }
+
+    for (std::string_view month : kMonthNames) {
+        if (!hasPrefixIcase(s, pos, month)) {
+            continue;
+        }
+        size_t afterMonth = pos + month.size();
+        size_t spaces = spaceRunAt(s, afterMonth);
+        for (size_t k = spaces; k >= 1; --k) {
+            size_t dayPos = afterMonth + k;
+            for (size_t day = 2; day >= 1; --day) {
+                if (!hasDigitsAt(s, dayPos, day)) {
+                    continue;
+                }
+                size_t end = matchDateYearTail(s, dayPos + day);
+                if (end > 0) {
+                    return end - pos;
+                }
+            }
+        }
+    }
+
+    for (size_t day = 2; day >= 1; --day) {
+        if (!hasDigitsAt(s, pos, day)) {
+            continue;
+        }
+        size_t afterDay = pos + day;
+        size_t spaces = spaceRunAt(s, afterDay);
+        for (size_t k = spaces; k >= 1; --k) {
+            size_t monthPos = afterDay + k;
+            for (std::string_view month : kMonthNames) {
+                if (!hasPrefixIcase(s, monthPos, month)) {
+                    continue;
+                }
+                size_t end = matchDateYearTail(s, monthPos + month.size());
+                if (end > 0) {
+                    return end - pos;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+// \b\d{1,2}:\d{2}(:\d{2})?\s*(AM|PM)?\b, case insensitive.
+static size_t matchTime(std::string_view s, size_t pos) {
+    if (!isWordBoundary(s, pos)) {
+        return 0;
+    }
+
+    for (size_t hour = 2; hour >= 1; --hour) {
+        size_t colon = pos + hour;
+        if (!hasDigitsAt(s, pos, hour) || colon >= s.size() || s[colon] != ':' ||
+            !hasDigitsAt(s, colon + 1, 2)) {
+            continue;
+        }
+        size_t afterMinutes = colon + 3;
+
+        for (int8_t withSeconds = 1; withSeconds >= 0; --withSeconds) {
+            size_t afterTime = afterMinutes;
+            if (withSeconds) {
+                if (afterMinutes >= s.size() || s[afterMinutes] != ':' ||
+                    !hasDigitsAt(s, afterMinutes + 1, 2)) {
+                    continue;
+                }
+                afterTime = afterMinutes + 3;
+            }
+
+            size_t spaces = spaceRunAt(s, afterTime);
+            for (size_t k = spaces + 1; k-- > 0;) {
+                size_t meridiemPos = afterTime + k;
+                if ((hasPrefixIcase(s, meridiemPos, "am") ||
+                     hasPrefixIcase(s, meridiemPos, "pm")) &&
+                    isWordBoundary(s, meridiemPos + 2)) {
+                    return meridiemPos + 2 - pos;
+                }
+                if (isWordBoundary(s, meridiemPos)) {
+                    return meridiemPos - pos;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+// \s{2,}
+static size_t matchSpaceRun(std::string_view s, size_t pos) {
+    size_t spaces = spaceRunAt(s, pos);
+    return spaces >= 2 ? spaces : 0;
+}
+
 std::string
-FeaturePruner::removeDatesAndTimesFromToken(const std::string &input) {
-    std::string out = input;
-    static const std::regex date_numeric(
-        R"((\b\d{1,2}[-/.]\d{1,2}[-/.]\d{2,4}\b)|(\b\d{4}[-/.]\d{1,2}[-/.]\d{1,2}\b))",
-        std::regex::ECMAScript | std::regex::icase);
-    static const std::regex date_month_name(
-        R"(\b(?:(?:jan(?:uary)?|feb(?:ruary)?|mar(?:ch)?|apr(?:il)?|may|jun(?:e)?|jul(?:y)?|aug(?:ust)?|sep(?:t|tember)?|oct(?:ober)?|nov(?:ember)?|dec(?:ember)?))\s+\d{1,2}(?:,\s*)?\s+\d{2,4}\b|\b\d{1,2}\s+(?:jan(?:uary)?|feb(?:ruary)?|mar(?:ch)?|apr(?:il)?|may|jun(?:e)?|jul(?:y)?|aug(?:ust)?|sep(?:t|tember)?|oct(?:ober)?|nov(?:ember)?|dec(?:ember)?)(?:,\s*)?\s+\d{2,4}\b)",
-        std::regex::ECMAScript | std::regex::icase);
-    static const std::regex time_hm(R"(\b\d{1,2}:\d{2}(:\d{2})?\s*(AM|PM)?\b)",
-                                    std::regex::ECMAScript | std::regex::icase);
-    out = std::regex_replace(out, date_numeric, "");
-    out = std::regex_replace(out, date_month_name, "");
-    out = std::regex_replace(out, time_hm, "");
-    out = std::regex_replace(out, std::regex(R"(\s{2,})"), " ");
+FeaturePruner::removeDatesAndTimesFromToken(std::string_view input) {
+    std::string out;
+    std::string scratch;
+    replaceMatches(input, matchNumericDate, "", out);
+    replaceMatches(out, matchNamedDate, "", scratch);
+    replaceMatches(scratch, matchTime, "", out);
+    replaceMatches(out, matchSpaceRun, " ", scratch);
+    return scratch;
+}
+
+// \s*\(enforce\)
+static size_t matchEnforceMarker(std::string_view s, size_t pos) {
+    size_t spaces = spaceRunAt(s, pos);
+    if (s.substr(pos + spaces, 9) == "(enforce)") {
+        return spaces + 9;
+    }
+    return 0;
+}
+
+std::string FeaturePruner::removeEnforceMarker(std::string_view input) {
+    std::string out;
+    replaceMatches(input, matchEnforceMarker, "", out);
+    return out;
+}
+
+// \[\s*(info|warn|error|debug|trace)?\s*\]?, case insensitive.
+static size_t matchLogLevelTag(std::string_view s, size_t pos) {
+    static const std::string_view kLevels[] = {"info", "warn", "error", "debug",
+                                               "trace"};
+    if (s[pos] != '[') {
+        return 0;
+    }
+
+    size_t end = pos + 1;
+    end += spaceRunAt(s, end);
+    for (std::string_view level : kLevels) {
+        if (hasPrefixIcase(s, end, level)) {
+            end += level.size();
+            break;
+        }
+    }
+    end += spaceRunAt(s, end);
+    if (end < s.size() && s[end] == ']') {
+        end++;
+    }
+    return end - pos;
+}
+
+std::string FeaturePruner::removeLogLevelTags(std::string_view input) {
+    std::string out;
+    replaceMatches(input, matchLogLevelTag, "", out);
     return out;
 }
 
+// Equivalent of searching for ".*? (\S+)\[(\d+)\]: (.*)" and joining the 1st and 3rd
+// groups: the first space followed by a "<comm>[<pid>]:" token and another space.
+int8_t FeaturePruner::formatJournalLine(std::string_view line,
+                                        std::string &out) {
+    for (size_t space = line.find(' '); space != std::string_view::npos;
+         space = line.find(' ', space + 1)) {
+        size_t tokenEnd = space + 1;
+        while (tokenEnd < line.size() && !isSpaceChar(line[tokenEnd])) {
+            tokenEnd++;
+        }
+
+        // Token ends with "[<digits>]:" and is followed by a space.
+        if (tokenEnd >= line.size() || line[tokenEnd] != ' ' ||
+            tokenEnd - space < 6 || line[tokenEnd - 1] != ':' ||
+            line[tokenEnd - 2] != ']') {
+            continue;
+        }
+
+        size_t digitsStart = tokenEnd - 2;
+        while (digitsStart > space + 1 && isDigitChar(line[digitsStart - 1])) {
+            digitsStart--;
+        }
+        size_t bracket = digitsStart - 1;
+        if (digitsStart == tokenEnd - 2 || bracket <= space + 1 ||
+            line[bracket] != '[') {
+            continue;
+        }
+
+        // '.' stops at line terminators.
+        size_t messageStart = tokenEnd + 1;
+        size_t messageEnd = line.find_first_of("\r\n", messageStart);
+        if (messageEnd == std::string_view::npos) {
+            messageEnd = line.size();
+        }
+
+        out.assign(line.substr(space + 1, bracket - space - 1));
+        out.append(": ");
+        out.append(line.substr(messageStart, messageEnd - messageStart));
+        return true;
+    }
+    return false;
+}
+
 std::string FeaturePruner::removePunctuation(const std::string &s) {
     std::string out;
     for (size_t i = 0; i < s.size(); ++i) {
@@ -116,12 +456,11 @@ int8_t FeaturePruner::isAllSpecialChars(const std::string &token) {
     return true;
 }
 
-int8_t FeaturePruner::hasDigit(const std::string &str) {
-    std::regex digitRegex("[0-9]");
-    return std::regex_search(str, digitRegex);
+int8_t FeaturePruner::hasDigit(std::string_view str) {
+    return std::any_of(str.begin(), str.end(), isDigitChar);
 }
 
-int8_t FeaturePruner::isDigitsOnly(const std::string &str) {
+int8_t FeaturePruner::isDigitsOnly(std::string_view str) {
     return !str.empty() && std::all_of(str.begin(), str.end(), ::isdigit);
 }
 
@@ -168,23 +507,200 @@ void FeaturePruner::removeDoubleDash(std::vector<std::string> &vec) {
     }
 }
 
-static const std::regex
-    kUuidRe(R"(\b[0-9a-fA-F]{8}(?:-[0-9a-fA-F]{4}){3}-[0-9a-fA-F]{12}\b)");
-static const std::regex kHexRunRe(R"(\b[0-9a-fA-F]{4,}\b)");
-static const std::regex kDecRe(R"(\b[+-]?\d+\b)");
+// \b[0-9a-fA-F]{8}(?:-[0-9a-fA-F]{4}){3}-[0-9a-fA-F]{12}\b
+static size_t matchUuid(std::string_view s, size_t pos) {
+    static const size_t kGroups[] = {8, 4, 4, 4, 12};
+    if (!isWordBoundary(s, pos)) {
+        return 0;
+    }
+
+    size_t end = pos;
+    for (size_t i = 0; i < sizeof(kGroups) / sizeof(kGroups[0]); ++i) {
+        if (i > 0) {
+            if (end >= s.size() || s[end] != '-') {
+                return 0;
+            }
+            end++;
+        }
+        for (size_t j = 0; j < kGroups[i]; ++j, ++end) {
+            if (end >= s.size() || !isHexChar(s[end])) {
+                return 0;
+            }
+        }
+    }
+    return isWordBoundary(s, end) ? end - pos : 0;
+}
+
+// \b[0-9a-fA-F]{4,}\b
+static size_t matchHexRun(std::string_view s, size_t pos) {
+    if (!isWordBoundary(s, pos)) {
+        return 0;
+    }
 
-static std::string replace_numbers_and_hex_with_N(const std::string &in) {
-    std::string s = std::regex_replace(in, kUuidRe, "n");
-    s = std::regex_replace(s, kHexRunRe, "n");
-    s = std::regex_replace(s, kDecRe, "n");
-    return s;
+    size_t end = pos;
+    while (end < s.size() && isHexChar(s[end])) {
+        end++;
+    }
+    // A shorter run always ends between two hex (word) characters, hence only the
+    // full run can be followed by a boundary.
+    return (end - pos >= 4 && isWordBoundary(s, end)) ? end - pos : 0;
+}
+
+// \b[+-]?\d+\b
+static size_t matchDecimal(std::string_view s, size_t pos) {
+    if (!isWordBoundary(s, pos)) {
+        return 0;
+    }
+
+    size_t end = pos;
+    if (s[end] == '+' || s[end] == '-') {
+        end++;
+    }
+    size_t digitsStart = end;
+    while (end < s.size() && isDigitChar(s[end])) {
+        end++;
+    }
+    return (end > digitsStart && isWordBoundary(s, end)) ? end - pos : 0;
+}
+
+static void replace_numbers_and_hex_with_N(std::string &s, std::string &scratch) {
+    replaceMatches(s, matchUuid, "n", scratch);
+    replaceMatches(scratch, matchHexRun, "n", s);
+    replaceMatches(s, matchDecimal, "n", scratch);
+    s.swap(scratch);
 }
 
 void FeaturePruner::normalize_numbers_inplace(
     std::vector<std::string> &tokens) {
+    std::string scratch;
     for (auto &s : tokens) {
-        s = replace_numbers_and_hex_with_N(s);
+        replace_numbers_and_hex_with_N(s, scratch);
+    }
+}
+
+// Tokens dropped by cleanText, same as in the model training pipeline.
+static const std::unordered_set<std::string_view> kRemoveKeywords = {
+    "unconfined", "user.slice", "user-n.slice", "user@n.service",
+    "app.slice", "app-org.gnome.terminal.slice", "vte-spawn-n.scope",
+    "usr", "bin", "lib"
+};
+
+// Tokens containing these are kept irrespective of their length.
+static const std::string_view kBrowserTerms[] = {
+    "httrack", "konqueror", "amfora", "luakit", "epiphany",
+    "firefox", "chrome", "chromium", "webkit", "gecko", "safari",
+    "opera", "brave", "vivaldi", "edge", "lynx", "w3m", "falkon"
+};
+
+// ^<prefix>\d+<suffix>$
+static int8_t isNumberedName(std::string_view t, std::string_view prefix,
+                             std::string_view suffix) {
+    if (t.size() <= prefix.size() + suffix.size() ||
+        t.substr(0, prefix.size()) != prefix ||
+        t.substr(t.size() - suffix.size()) != suffix) {
+        return false;
+    }
+    std::string_view number =
+        t.substr(prefix.size(), t.size() - prefix.size() - suffix.size());
+    return std::all_of(number.begin(), number.end(), isDigitChar);
+}
+
+// ^\d+(\.\d+)?$
+static int8_t isDecimalNumber(std::string_view t) {
+    size_t dot = t.find('.');
+    std::string_view whole = t.substr(0, dot);
+    if (whole.empty() || !std::all_of(whole.begin(), whole.end(), isDigitChar)) {
+        return false;
     }
+    if (dot == std::string_view::npos) {
+        return true;
+    }
+    std::string_view fraction = t.substr(dot + 1);
+    return !fraction.empty() &&
+           std::all_of(fraction.begin(), fraction.end(), isDigitChar);
+}
+
+// 0x[a-f0-9]+, case insensitive
+static size_t matchHexLiteral(std::string_view s, size_t pos) {
+    if (s[pos] != '0' || pos + 1 >= s.size() || toLowerChar(s[pos + 1]) != 'x') {
+        return 0;
+    }
+    size_t end = pos + 2;
+    while (end < s.size() && isHexChar(s[end])) {
+        end++;
+    }
+    return end > pos + 2 ? end - pos : 0;
+}
+
+// \d{4,}
+static size_t matchLongNumber(std::string_view s, size_t pos) {
+    size_t end = pos;
+    while (end < s.size() && isDigitChar(s[end])) {
+        end++;
+    }
+    return end - pos >= 4 ? end - pos : 0;
+}
+
+std::string FeaturePruner::cleanText(std::string_view input) {
+    // Lower case, with commas and brackets turned into separators.
+    std::string line(input);
+    for (char &c : line) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        if (c == ',' || c == '[' || c == ']' || c == '(' || c == ')' ||
+            c == '{' || c == '}') {
+            c = ' ';
+        }
+    }
+
+    std::string result;
+    std::string token;
+    std::string scratch;
+    result.reserve(line.size());
+
+    std::string_view text(line);
+    size_t pos = 0;
+    while (pos < text.size()) {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        size_t start = pos;
+        while (pos < text.size() && !std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        if (pos == start) {
+            break;
+        }
+
+        std::string_view t = text.substr(start, pos - start);
+        if (kRemoveKeywords.count(t) > 0 ||
+            isNumberedName(t, "user-", ".slice") ||
+            isNumberedName(t, "user@", ".service") ||
+            (t.size() >= 16 && t.substr(0, 10) == "vte-spawn-" &&
+             t.substr(t.size() - 6) == ".scope") ||
+            isDecimalNumber(t)) {
+            continue;
+        }
+
+        replaceMatches(t, matchHexLiteral, "<hex>", scratch);
+        replaceMatches(scratch, matchLongNumber, "<num>", token);
+
+        int8_t isBrowserTerm = false;
+        for (std::string_view browserTerm : kBrowserTerms) {
+            if (token.find(browserTerm) != std::string::npos) {
+                isBrowserTerm = true;
+                break;
+            }
+        }
+
+        if (isBrowserTerm || token.length() > 1) {
+            if (!result.empty()) {
+                result.push_back(' ');
+            }
+            result.append(token);
+        }
+    }
+
+    return result;
 }
 
 std::unordered_map<std::string, std::unordered_set<std::string>>
@@ -0,0 +1,88 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <algorithm>
+
+#include "Utils.h"
+#include "Logger.h"
+#include "AuxRoutines.h"
+#include "FocusTracker.h"
+
+#define FOCUS_TRACKER_TAG "FOCUS_TRACKER"
+
+void FocusTracker::trackApp(pid_t pid, const ClassifiedApp& app) {
+    if(this->mClassifiedApps.size() >= CLASSIFIER_MAX_TRACKED_APPS) {
+        // EXIT events may have been lost, drop the apps which are gone.
+        for(auto it = this->mClassifiedApps.begin(); it != this->mClassifiedApps.end();) {
+            if(!AuxRoutines::fileExists(COMM(it->first))) {
+                it = this->mClassifiedApps.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if(this->mClassifiedApps.size() >= CLASSIFIER_MAX_TRACKED_APPS) {
+            return;
+        }
+    }
+    this->mClassifiedApps[pid] = app;
+}
+
+int8_t FocusTracker::onClassified(pid_t pid, const ClassifiedApp& app, uint64_t seq) {
+    this->trackApp(pid, app);
+
+    // With a focus provider present, an app launched in the background is only
+    // recorded, it is switched to once it gets focus (onFocusHint).
+    if(this->mFocusHintsSeen) {
+        return (pid == this->mFocusHintPid);
+    }
+
+    // A newer launch is already in effect.
+    return (seq >= this->mLastAppliedSeq);
+}
+
+FocusAction FocusTracker::onFocusHint(pid_t pid, ClassifiedApp& app) {
+    if(!this->mFocusHintsSeen) {
+        LOGI(FOCUS_TRACKER_TAG, "Focus hints received, switching profiles on focus changes only");
+        this->mFocusHintsSeen = true;
+    }
+
+    this->mFocusHintPid = pid;
+    if(pid == this->mFocusedPid) {
+        // Already in effect, nothing to switch.
+        return FOCUS_UNCHANGED;
+    }
+
+    auto it = this->mClassifiedApps.find(pid);
+    if(it != this->mClassifiedApps.end()) {
+        app = it->second;
+        return FOCUS_SWITCH;
+    }
+
+    // Not classified (yet), the previous app's profile no longer applies.
+    this->mFocusedPid = -1;
+    return FOCUS_CLASSIFY;
+}
+
+void FocusTracker::onAppExit(pid_t pid) {
+    this->mClassifiedApps.erase(pid);
+    if(pid == this->mFocusedPid) {
+        this->mFocusedPid = -1;
+    }
+}
+
+void FocusTracker::setFocusedApp(pid_t pid, uint64_t seq) {
+    this->mFocusedPid = pid;
+    this->mLastAppliedSeq = std::max(this->mLastAppliedSeq, seq);
+}
+
+void FocusTracker::clearFocusedApp() {
+    this->mFocusedPid = -1;
+}
+
+pid_t FocusTracker::getFocusedApp() {
+    return this->mFocusedPid;
+}
+
+int8_t FocusTracker::focusHintsSeen() {
+    return this->mFocusHintsSeen;
+}
@@ -0,0 +1,104 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef CLASSIFICATION_CACHE_H
+#define CLASSIFICATION_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <sys/types.h>
+#include <unordered_map>
+
+#define CLASSIFICATION_CACHE_DEFAULT_SIZE 256
+#define CLASSIFICATION_CACHE_PATH "/var/cache/urm/classification_cache"
+
+/**
+ * @brief Identifies the program a process is running, independent of its pid.
+ * @details The executable is identified by its path along with the inode, mtime and size
+ *          of the file backing it, so that a binary which is upgraded (or replaced) in place
+ *          is classified afresh. The cmdline is part of the identity as well, since
+ *          interpreters and launchers (python, java, electron etc.) run entirely different
+ *          apps from the same executable.
+ */
+typedef struct {
+    std::string mExePath;
+    uint64_t mDev;
+    uint64_t mIno;
+    int64_t mMtimeNs;
+    int64_t mSize;
+    uint64_t mCmdlineHash;
+} ExeIdentity;
+
+/**
+ * @brief ClassificationCache
+ * @details LRU cache of classification results keyed by ExeIdentity, relaunches of a known app
+ *          skip feature extraction and inference altogether. The cache can optionally be
+ *          persisted across Server restarts, refer load and save. The persisted results are
+ *          tied to the model which produced them, refer setModelIdentity.
+ */
+class ClassificationCache {
+private:
+    typedef std::pair<std::string, int32_t> CacheEntry;
+
+    size_t mMaxEntries;
+    // Most recently used entries at the front
+    std::list<CacheEntry> mEntries;
+    std::unordered_map<std::string, std::list<CacheEntry>::iterator> mIndex;
+    std::mutex mCacheMutex;
+    // <size>:<mtime>:<path> of the model file, written to (and checked against) the file header
+    std::string mModelIdentity;
+
+    static std::string encodeKey(const ExeIdentity& identity);
+    static int8_t isValidKey(const std::string& key);
+    void insertLocked(const std::string& key, int32_t contextType);
+
+public:
+    ClassificationCache(size_t maxEntries = CLASSIFICATION_CACHE_DEFAULT_SIZE);
+
+    void setMaxEntries(size_t maxEntries);
+
+    /**
+     * @brief Record the model the results come from. A persisted cache written for a
+     *        different (for ex. updated) model is discarded on load.
+     */
+    void setModelIdentity(const std::string& modelPath);
+
+    /**
+     * @brief Resolve the ExeIdentity of a running process.
+     * @return int8_t:\n
+     *            - true: If the identity could be resolved\n
+     *            - false: Otherwise, for ex. the process exited or is a kernel thread
+     */
+    static int8_t getExeIdentity(pid_t pid, ExeIdentity& identity);
+
+    /**
+     * @brief Fetch the cached classification result, the entry is marked as most recently used.
+     * @return int8_t:\n
+     *            - true: If a result was found, in which case contextType is filled in\n
+     *            - false: Otherwise
+     */
+    int8_t lookup(const ExeIdentity& identity, int32_t& contextType);
+    void insert(const ExeIdentity& identity, int32_t contextType);
+
+    size_t size();
+
+    /**
+     * @brief Read back the entries saved by a previous instance. Entries which no longer
+     *        fit are dropped, least recently used first.
+     * @return int8_t:\n
+     *            - true: If the entries were loaded\n
+     *            - false: If the file is missing, malformed or was written for another model,
+     *                     in which case nothing is loaded.
+     */
+    int8_t load(const std::string& filePath);
+
+    /**
+     * @brief Persist the entries (least recently used first), by writing a new file
+     *        and renaming it over filePath.
+     */
+    int8_t save(const std::string& filePath);
+};
+
+#endif
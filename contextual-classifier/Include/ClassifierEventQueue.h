@@ -0,0 +1,75 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef CLASSIFIER_EVENT_QUEUE_H
+#define CLASSIFIER_EVENT_QUEUE_H
+
+#include <deque>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+typedef enum : int8_t {
+    CC_IGNORE = 0x00,
+    CC_APP_OPEN = 0x01,
+    CC_APP_CLOSE = 0x02,
+    // Exec of a process which is not a classification candidate, only tracked in the ProcessIndex
+    CC_TASK_EXEC = 0x03,
+    // A process or thread changed its comm (for ex. via prctl(PR_SET_NAME))
+    CC_TASK_RENAME = 0x04,
+    // A new process was forked, only tracked in the ProcessIndex
+    CC_TASK_FORK = 0x05
+} EventType;
+
+// Size of the comm field, including the terminating NUL (TASK_COMM_LEN)
+#define PROC_EVENT_COMM_LEN 16
+
+struct ProcEvent {
+    int32_t pid;
+    int32_t tgid;
+    int32_t type; // EventType
+    char comm[PROC_EVENT_COMM_LEN]; // Set for CC_APP_OPEN, CC_TASK_EXEC and CC_TASK_RENAME
+    int32_t ppid; // Set for CC_TASK_FORK
+    // Order of arrival, stamped by the classifier when the event is received. Results are
+    // applied in this order, irrespective of the order in which their classification completes.
+    uint64_t seq;
+};
+
+/**
+ * @brief ClassifierEventQueue
+ * @details Bounded queue of the events waiting for a classifier worker. A pid is handled by
+ *          at most one worker at a time, which keeps the events of a given pid in order, while
+ *          the events of other pids are picked up in parallel.\n
+ *          Not thread-safe, the caller serializes access (ContextualClassifier's mQueueMutex).
+ */
+class ClassifierEventQueue {
+private:
+    std::deque<ProcEvent> mPendingEv;
+    std::unordered_set<int32_t> mInFlightPids;
+    size_t mMaxSize;
+
+public:
+    ClassifierEventQueue(size_t maxSize);
+
+    void setMaxSize(size_t maxSize);
+    size_t getMaxSize();
+
+    // Once full, the oldest event is dropped.
+    void push(const ProcEvent& ev);
+
+    /**
+     * @brief Pick the oldest event whose pid is not being handled by another worker.
+     * @details The pid is marked in flight, until markDone is called for it.
+     * @return int8_t:\n
+     *            - true: If an event was picked\n
+     *            - false: If there is no runnable event
+     */
+    int8_t popRunnable(ProcEvent& ev);
+    void markDone(int32_t pid);
+
+    // Drops the pending events, the in-flight pids are still to be marked done.
+    void clear();
+    size_t size();
+};
+
+#endif
@@ -4,8 +4,10 @@
 #ifndef CONTEXTUAL_CLASSIFIER_H
 #define CONTEXTUAL_CLASSIFIER_H
 
+#include <deque>
+#include <atomic>
+#include <chrono>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <vector>
 #include <thread>
@@ -16,16 +18,15 @@
 #include "Resource.h"
 #include "AppConfigs.h"
 #include "NetLinkComm.h"
+#include "FocusTracker.h"
+#include "ClassifierEventQueue.h"
+#include "ProcessIndex.h"
 #include "AuxRoutines.h"
 #include "ComponentRegistry.h"
+#include "ClassificationCache.h"
 
 class Inference;
-
-typedef enum : int8_t {
-    CC_IGNORE = 0x00,
-    CC_APP_OPEN = 0x01,
-    CC_APP_CLOSE = 0x02
-} EventType;
+class Request;
 
 typedef enum CC_TYPE {
     CC_APP = 0x01,
@@ -34,10 +35,24 @@ typedef enum CC_TYPE {
     CC_MULTIMEDIA = 0x04,
 } CC_TYPE;
 
-struct ProcEvent {
-    int32_t pid;
-    int32_t tgid;
-    int32_t type; // CC_APP_OPEN / CC_APP_CLOSE / CC_IGNORE
+#define CLASSIFIER_DEFAULT_SETTLE_DELAY_MS 100
+#define CLASSIFIER_DEFAULT_WORKER_COUNT 2
+#define CLASSIFIER_MAX_WORKER_COUNT 8
+#define CLASSIFIER_DEFAULT_QUEUE_SIZE 30
+// Min gap between rebuilds of the ProcessIndex, after proc events were lost.
+#define CLASSIFIER_INDEX_RESYNC_INTERVAL_MS 5000
+
+// An EXEC event waiting out the settle delay.
+struct SettlingEvent {
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t seq; // Matches mSettlingPids, unless cancelled (or the pid was re-used)
+    ProcEvent ev;
+};
+
+// Per-app config thread rule: tasks whose comm contains mThreadName are moved to mCGroupId.
+struct ThreadPlacementRule {
+    std::string mThreadName;
+    int32_t mCGroupId;
 };
 
 class ContextualClassifier {
@@ -52,19 +67,78 @@ private:
     // PID cache to check for duplicates
     MinLRUCache mClassifierPidCache;
 
-    // Event queue for classifier main thread
-    std::queue<ProcEvent> mPendingEv;
+    // Results for already classified executables
+    ClassificationCache mClassificationCache;
+    int8_t mPersistClassificationCache = false;
+
+    // Event queue shared by the classifier workers, refer ClassifierEventQueue.
+    ClassifierEventQueue mEventQueue{CLASSIFIER_DEFAULT_QUEUE_SIZE};
+    // Last arrival sequence stamped (ProcEvent::seq), focus hints are stamped as well.
+    std::atomic<uint64_t> mArrivalSeq{0};
     std::mutex mQueueMutex;
     std::condition_variable mQueueCond;
-    std::thread mClassifierMain;
+    int32_t mWorkerCount = CLASSIFIER_DEFAULT_WORKER_COUNT;
+    std::vector<std::thread> mClassifierWorkers;
     std::thread mNetlinkThread;
+    int8_t mWarmUpModel = true;
+
+    // Serializes switching the focused app, i.e. mCurrRestuneHandles and the
+    // cgroup / signal requests issued for the app.
+    std::mutex mApplyMutex;
+
+    // App whose per-app profile (mCurrRestuneHandles) is in effect, along with its thread
+    // placement rules. Written with mApplyMutex held, and read by the netlink listener
+    // (PlaceAppThread) under mFocusedAppMutex only, which keeps the listener off mApplyMutex.
+    std::mutex mFocusedAppMutex;
+    pid_t mFocusedTgid = -1;
+    std::string mFocusedComm;
+    std::vector<ThreadPlacementRule> mFocusedThreadRules;
+
+    // Decides which app holds the profile, refer FocusTracker. Guarded by mApplyMutex.
+    FocusTracker mFocusTracker;
+
+    // Handles of the background actions applied for apps which are not focused, keyed
+    // by the app's pid. Guarded by mApplyMutex.
+    std::unordered_map<pid_t, std::vector<int64_t>> mBackgroundHandles;
+
+    // Comm of every task, maintained by the netlink listener.
+    ProcessIndex mProcessIndex;
+    // Rebuilds the index after lost events, off the netlink listener.
+    std::thread mIndexResyncThread;
+    std::atomic<int8_t> mIndexResyncRunning{false};
+
+    // EXEC events are held back for mSettleDelayMs, an EXIT within that window
+    // cancels the classification. Guarded by mQueueMutex.
+    uint32_t mSettleDelayMs = CLASSIFIER_DEFAULT_SETTLE_DELAY_MS;
+    std::deque<SettlingEvent> mSettlingEv;
+    std::unordered_map<int32_t, uint64_t> mSettlingPids;
+    uint64_t mSettleSeq = 0;
+    uint64_t mSettleCancelCount = 0;
 
     std::unordered_set<std::string> mIgnoredProcesses;
     std::unordered_set<std::string> mAllowedProcesses;
 
-    void ClassifierMain();
+    void ClassifierMain(int32_t workerId);
     int32_t HandleProcEv();
 
+    void ProcessEvent(const ProcEvent& ev);
+    void ApplyFocusedApp(pid_t pid,
+                         pid_t tgid,
+                         const std::string& comm,
+                         int32_t contextType,
+                         uint64_t seq);
+    void ApplyBackgroundApp(pid_t pid,
+                            pid_t tgid,
+                            const std::string& comm,
+                            int32_t contextType);
+    void RemoveBackgroundActions(pid_t pid);
+
+    void LoadSettleDelay();
+    void LoadWorkerConfig();
+    void LoadModelConfig();
+    void QueueEvent(const ProcEvent& ev);
+    void PromoteSettledEvents();
+
     // Main classification flow
     int32_t ClassifyProcess(pid_t pid,
                             pid_t tgid,
@@ -72,7 +146,7 @@ private:
                             uint32_t &ctxDetails);
 
     // Fetch signal configuration info
-    uint32_t GetSignalIDForWorkload(int32_t contextType);
+    static uint32_t GetSignalIDForWorkload(int32_t contextType);
 
     // Methods for tuning / untuning signals based on the workload
     void ApplyActions(uint32_t sigId,
@@ -83,6 +157,8 @@ private:
                       int32_t* arg);
     void RemoveActions(pid_t pid, int32_t tgid);
 
+    void LoadClassificationCache();
+
     // blacklisting mechanism
     void LoadIgnoredProcesses();
     int8_t shouldProcBeIgnored(int32_t evType, pid_t pid);
@@ -97,6 +173,14 @@ private:
                                 const std::string& comm,
                                 int32_t cgroupIdentifier);
 
+    // Apply the focused app's thread rules to a task which was just exec'd or renamed.
+    void PlaceAppThread(const ProcEvent& ev);
+    void SetFocusedAppRules(pid_t tgid,
+                            const std::string& comm,
+                            std::vector<ThreadPlacementRule> threadRules);
+    void ResyncProcessIndex();
+    void submitPlacementRequest(Request* request);
+
     void configureAppSignals(pid_t incomingPID,
                              pid_t incomingTID,
                              const std::string& comm);
@@ -109,6 +193,19 @@ public:
 
     ErrCode Init();
     ErrCode Terminate();
+
+    // The focused app changed, as hinted via URM_SIG_APP_FOCUS.
+    void HandleFocusHint(pid_t pid);
+
+    /**
+     * @brief Signal carrying the actions for a classified app of the given workload type.
+     * @details The focused app gets the workload's Signal, apps classified in the background
+     *          get its background variant (BACKGROUND_SIGNAL_TYPE) instead, if configured.
+     */
+    static void GetActionSignal(int32_t contextType,
+                                int8_t isFocused,
+                                uint32_t& sigId,
+                                uint32_t& sigType);
 };
 
 #endif // CONTEXTUAL_CLASSIFIER_H
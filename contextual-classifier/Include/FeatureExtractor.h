@@ -4,6 +4,7 @@
 #ifndef FEATURE_EXTRACTOR_H
 #define FEATURE_EXTRACTOR_H
 
+#include <chrono>
 #include <cstdint>
 #include <map>
 #include <string>
@@ -33,11 +34,14 @@ private:
 	static std::vector<std::string> ParseComm(pid_t pid,
 											  const std::string &delimiters);
 
+	// Directory scans stop at the deadline, or after FEATURE_MAX_DIR_ENTRIES entries.
 	static std::vector<std::string> ParseMapFiles(pid_t pid,
-		                                          const std::string &delimiters);
+		                                          const std::string &delimiters,
+		                                          std::chrono::steady_clock::time_point deadline);
 
 	static std::vector<std::string> ParseFd(pid_t pid,
-											const std::string &delimiters);
+											const std::string &delimiters,
+											std::chrono::steady_clock::time_point deadline);
 
 	static std::vector<std::string> ParseEnviron(pid_t pid,
 												 const std::string &delimiters);
@@ -66,6 +70,12 @@ public:
 		mTokenIgnoreMap = FeaturePruner::loadIgnoreMap(IGNORE_TOKENS_PATH, labels);
 	}
 
+	// Starts the journal reader for ReadJournalForPid, which opens the journal and
+	// owns it from then on. Called at init, so that the open does not count against
+	// the read budget of the first classified process.
+	static void OpenJournal();
+	static void CloseJournal();
+
 	static int CollectAndStoreData(
 		pid_t pid,
 		std::map<std::string, std::string> &output_data,
@@ -6,14 +6,18 @@
 
 #include <string>
 #include <vector>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 
 class FeaturePruner {
 public:
-	static std::string trim(const std::string &s);
-	static std::vector<std::string> splitString(const std::string &input,
-												const std::string &delimiters);
+	// Note: The helpers below are hand-written equivalents of the std::regex based
+	// normalisation the model was trained with, the output must stay byte-identical.
+
+	static std::string trim(std::string_view s);
+	static std::vector<std::string> splitString(std::string_view input,
+												std::string_view delimiters);
 
 	static std::string normalizeLibraryName(const std::string &s);
 
@@ -30,13 +34,25 @@ public:
 
 	static void normalize_numbers_inplace(std::vector<std::string> &tokens);
 
-	static int8_t isDigitsOnly(const std::string &str);
+	static int8_t isDigitsOnly(std::string_view str);
 
-	static int8_t hasDigit(const std::string &str);
+	static int8_t hasDigit(std::string_view str);
 
 	static int8_t isAllSpecialChars(const std::string &token);
 
-	static std::string removeDatesAndTimesFromToken(const std::string &input);
+	static std::string removeDatesAndTimesFromToken(std::string_view input);
+
+	// Drops the "(enforce)" marker (and the whitespace before it) from an SELinux context.
+	static std::string removeEnforceMarker(std::string_view input);
+
+	// Drops bracketed log level tags, for ex. "[ INFO ]", "[warn]" or a bare "[".
+	static std::string removeLogLevelTags(std::string_view input);
+
+	// Reduce a "<host> <comm>[<pid>]: <message>" journal line to "<comm>: <message>".
+	static int8_t formatJournalLine(std::string_view line, std::string &out);
+
+	// Normalise the concatenated features into the text fed to the model.
+	static std::string cleanText(std::string_view input);
 
 	static std::string removePunctuation(const std::string &s);
 
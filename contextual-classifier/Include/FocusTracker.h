@@ -0,0 +1,80 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef FOCUS_TRACKER_H
+#define FOCUS_TRACKER_H
+
+#include <string>
+#include <cstdint>
+#include <sys/types.h>
+#include <unordered_map>
+
+// Max running apps whose classification is remembered, for focus switches.
+#define CLASSIFIER_MAX_TRACKED_APPS 256
+
+// Classification result of a running app, so that focus can move to it without re-classifying.
+struct ClassifiedApp {
+    pid_t tgid;
+    std::string comm;
+    int32_t contextType;
+};
+
+typedef enum : int8_t {
+    // The hinted app already holds the per-app profile
+    FOCUS_UNCHANGED = 0x00,
+    // Switch the per-app profile over to the (already classified) hinted app
+    FOCUS_SWITCH = 0x01,
+    // The hinted app is not classified yet, the previous profile is to be dropped
+    FOCUS_CLASSIFY = 0x02
+} FocusAction;
+
+/**
+ * @brief FocusTracker
+ * @details Decides which app holds the per-app profile. Until a focus hint (URM_SIG_APP_FOCUS)
+ *          is received, every classified app is taken to be focused. From then on, only a focus
+ *          change switches the profile, and apps classified in the background are just recorded.
+ *          Not thread-safe, the caller serializes access (ContextualClassifier's mApplyMutex).
+ */
+class FocusTracker {
+private:
+    int8_t mFocusHintsSeen = false;
+    pid_t mFocusHintPid = -1;
+    // App whose per-app profile is in effect
+    pid_t mFocusedPid = -1;
+    // Arrival sequence of the event (launch or focus hint) behind the profile in effect
+    uint64_t mLastAppliedSeq = 0;
+    std::unordered_map<pid_t, ClassifiedApp> mClassifiedApps;
+
+    void trackApp(pid_t pid, const ClassifiedApp& app);
+
+public:
+    /**
+     * @brief Record the classification result of an app.
+     * @details Without focus hints, the most recently launched app is taken to be focused.
+     *          Classification of a given app can complete after that of an app launched
+     *          later, in which case its (stale) result must not override the newer app's.
+     * @param seq Arrival sequence of the app's launch event
+     * @return int8_t:\n
+     *            - true: If the app is (to be taken as) focused, i.e. the profile is to be switched to it.\n
+     *            - false: If it was launched in the background, or before the app in effect.
+     */
+    int8_t onClassified(pid_t pid, const ClassifiedApp& app, uint64_t seq);
+
+    /**
+     * @brief The focused app changed.
+     * @param pid Pid of the newly focused app
+     * @param app Filled in with the app's classification, for FOCUS_SWITCH
+     */
+    FocusAction onFocusHint(pid_t pid, ClassifiedApp& app);
+
+    void onAppExit(pid_t pid);
+
+    // The per-app profile was switched over to the given app, for the event with the given sequence.
+    void setFocusedApp(pid_t pid, uint64_t seq);
+    void clearFocusedApp();
+
+    pid_t getFocusedApp();
+    int8_t focusHintsSeen();
+};
+
+#endif
@@ -20,8 +20,19 @@ public:
         return CC_APP;
     }
 
+    // Run a throwaway inference, so that the first real classification does not pay
+    // for the first-touch costs of the model. Called from a classifier worker.
+    virtual void WarmUp() {}
+
+    // Time taken to load the model and the size of the matrices it allocated,
+    // 0 if no model is used.
+    int64_t GetLoadTimeMs() const { return load_time_ms_; }
+    int64_t GetMatrixKb() const { return matrix_kb_; }
+
 protected:
     std::string model_path_;
+    int64_t load_time_ms_ = 0;
+    int64_t matrix_kb_ = 0;
 };
 
 #endif // INFERENCE_H
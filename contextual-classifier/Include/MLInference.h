@@ -4,8 +4,6 @@
 #ifndef ML_INFERENCE_H
 #define ML_INFERENCE_H
 
-#include <mutex>
-#include <regex>
 #include <string>
 #include <vector>
 #include <floret/fasttext.h>
@@ -20,33 +18,15 @@ private:
                      const std::map<std::string, std::string> &rawData,
                      std::string &cat);
 
+    // Read-only once loaded: predict() and the dictionary lookups are const and keep
+    // their scratch state on the stack, hence Predict is called concurrently from all
+    // the classifier workers without any locking.
     fasttext::FastText ft_model_;
-    std::mutex predict_mutex_;
 
     std::vector<std::string> classes_;
     std::vector<std::string> text_cols_;
     int32_t embedding_dim_;
 
-    // initialize a set having string that we can ignore.
-    const std::set<std::string> REMOVE_KEYWORDS = {
-        "unconfined", "user.slice", "user-n.slice", "user@n.service",
-        "app.slice", "app-org.gnome.terminal.slice", "vte-spawn-n.scope",
-        "usr", "bin", "lib"
-    };
-
-    const std::set<std::string> BROWSER_TERMS = {
-        "httrack", "konqueror", "amfora", "luakit", "epiphany",
-        "firefox", "chrome", "chromium", "webkit", "gecko", "safari",
-        "opera", "brave", "vivaldi", "edge", "lynx", "w3m", "falkon"
-    };
-
-    std::regex user_slice_pattern_;
-    std::regex user_service_pattern_;
-    std::regex vte_spawn_pattern_;
-    std::regex decimal_pattern_;
-    std::regex hex_pattern_;
-    std::regex long_number_pattern_;
-
     // Method to clean the text as same as we are doing in floret model building.
     std::string CleanTextPython(const std::string &input);
 
@@ -55,6 +35,7 @@ public:
     ~MLInference();
 
     CC_TYPE Classify(int processPid) override;
+    void WarmUp() override;
 };
 
 #endif // ML_INFERENCE_H
@@ -4,6 +4,8 @@
 #ifndef NETLINK_COMM_H
 #define NETLINK_COMM_H
 
+#include <atomic>
+#include <cstdint>
 #include <linux/cn_proc.h>
 #include <linux/connector.h>
 #include <linux/netlink.h>
@@ -20,13 +22,42 @@ struct cn_msg_hdr {
     __u16 flags;
 };
 
-// Forward declaration; ProcEvent is defined in ContextualClassifier.h
+// A single proc connector message, as received from the socket.
+typedef struct __attribute__((aligned(NLMSG_ALIGNTO))) {
+    struct nlmsghdr nl_hdr;
+    struct __attribute__((__packed__)) {
+        struct cn_msg_hdr cn_msg;
+        struct proc_event proc_ev;
+    };
+} NetLinkProcMsg;
+
+// Number of messages drained from the socket per recvmmsg call.
+#define NETLINK_RECV_BATCH_SIZE 32
+// Receive buffer requested for the socket, to absorb bursts (for ex. build storms).
+#define NETLINK_RCVBUF_SIZE (4 * 1024 * 1024)
+// Upper bound on a blocking receive, so that the listener notices a shutdown even
+// without events (closing the socket does not wake up a blocked receive).
+#define NETLINK_RECV_TIMEOUT_MS 500
+
+// Forward declaration; ProcEvent is defined in ClassifierEventQueue.h
 struct ProcEvent;
 
 class NetLinkComm {
 private:
 	int32_t mNlSock;
 
+    // Messages received by the last recvmmsg call, handed out one at a time by recvEvent.
+    NetLinkProcMsg mBatch[NETLINK_RECV_BATCH_SIZE];
+    uint32_t mBatchLen[NETLINK_RECV_BATCH_SIZE];
+    int32_t mBatchCount;
+    int32_t mBatchIndex;
+
+    // Number of times the socket reported ENOBUFS, i.e. events were dropped by the kernel.
+    std::atomic<uint64_t> mOverrunCount;
+
+    int32_t fillBatch();
+    void setupSocketFilter();
+
 public:
 	NetLinkComm();
     ~NetLinkComm();
@@ -37,12 +68,19 @@ public:
     void closeSocket();
 
     // Receive a single proc connector event and fill ProcEvent.
+    // Events are drained from the socket in batches, only FORK, EXEC, COMM and EXIT
+    // events are let through by the socket filter.
     // Returns:
-    //   CC_APP_OPEN  on EXEC
-    //   CC_APP_CLOSE on EXIT
-    //   0            on non-actionable events
+    //   CC_APP_OPEN    on EXEC of a candidate for classification
+    //   CC_TASK_EXEC   on EXEC of any other process
+    //   CC_TASK_RENAME on COMM
+    //   CC_TASK_FORK   on FORK of a process (not of a thread)
+    //   CC_APP_CLOSE   on EXIT
+    //   0            on non-actionable events, or if events were dropped (ENOBUFS)
     //   -1           on error
     int32_t recvEvent(ProcEvent &ev);
+
+    uint64_t getOverrunCount() const;
 };
 
 #endif // NETLINK_COMM_H
@@ -0,0 +1,81 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef PROCESS_INDEX_H
+#define PROCESS_INDEX_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sys/types.h>
+#include <unordered_map>
+
+// Max depth of the process tree walked when looking for an ancestor.
+#define PROCESS_INDEX_MAX_ANCESTRY_DEPTH 32
+
+typedef struct {
+    pid_t mTgid;
+    std::string mComm;
+} TaskInfo;
+
+/**
+ * @brief ProcessIndex
+ * @details In-memory index of every task (process and thread) on the system, along with
+ *          its comm and, for processes, their parent. It is built with a single walk over
+ *          /proc (refer populate), and then kept up to date from the proc connector's FORK,
+ *          EXEC, COMM and EXIT events, so that tasks can be looked up by name without scanning /proc.
+ */
+class ProcessIndex {
+private:
+    // tid -> TaskInfo
+    std::unordered_map<pid_t, TaskInfo> mTasks;
+    // Process (tgid) -> parent process
+    std::unordered_map<pid_t, pid_t> mParents;
+    std::mutex mIndexMutex;
+
+    int8_t isDescendantLocked(pid_t tgid, pid_t ancestor);
+
+public:
+    /**
+     * @brief Rebuild the index from /proc/<pid>/task/<tid>/comm, discarding its contents.
+     */
+    void populate();
+
+    /**
+     * @brief Record the comm of a task which was exec'd or renamed.
+     */
+    void update(pid_t tid, pid_t tgid, const std::string& comm);
+    void setParent(pid_t tgid, pid_t ppid);
+
+    /**
+     * @brief Record a newly forked process, along with its parent.
+     * @details The parent is kept across the child's subsequent renames (COMM events), so that
+     *          a child which never execs is still scoped to the app which spawned it.
+     */
+    void recordFork(pid_t pid, pid_t ppid);
+    void remove(pid_t tid);
+
+    /**
+     * @brief Check if the process tgid was (transitively) spawned by the process ancestor.
+     */
+    int8_t isDescendant(pid_t tgid, pid_t ancestor);
+
+    /**
+     * @brief Find the tasks of the given app whose comm contains the given name.
+     * @details Only the app's own threads, and the processes (and threads) it spawned
+     *          are considered, so that unrelated tasks of the same name are never matched.
+     */
+    std::vector<pid_t> findTasks(const std::string& name, pid_t tgid);
+
+    size_t size();
+
+    /**
+     * @brief Read the parent of a process from /proc/<pid>/stat.
+     * @return pid_t:\n
+     *            - The parent's pid, or -1 if the process is gone.
+     */
+    static pid_t readParent(pid_t pid);
+};
+
+#endif
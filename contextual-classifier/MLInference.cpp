@@ -5,6 +5,7 @@
 #include "ContextualClassifier.h"
 #include "FeatureExtractor.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
@@ -26,6 +27,20 @@ static std::string format_string(const char *fmt, ...) {
     return std::string(buffer);
 }
 
+// Size of the input and output matrices, which floret allocates (and fully populates)
+// while loading the model. Quantized models keep these compressed, hence not reported.
+static int64_t getMatrixKb(const fasttext::FastText &model) {
+    if (model.isQuant()) {
+        return 0;
+    }
+
+    int64_t bytes = 0;
+    for (const auto &matrix : {model.getInputMatrix(), model.getOutputMatrix()}) {
+        bytes += matrix->size(0) * matrix->size(1) * sizeof(fasttext::real);
+    }
+    return bytes / 1024;
+}
+
 MLInference::MLInference(const std::string &ft_model_path) : Inference(ft_model_path) {
     text_cols_ = {
         "attr",                                                  // 1x weight
@@ -39,18 +54,17 @@ MLInference::MLInference(const std::string &ft_model_path) : Inference(ft_model_
         "logs"                                                   // 1x weight
     };
 
-    // Initialize regex patterns
-    user_slice_pattern_   = std::regex("^user-\\d+\\.slice$");
-    user_service_pattern_ = std::regex("^user@\\d+\\.service$");
-    vte_spawn_pattern_    = std::regex("^vte-spawn-.*\\.scope$");
-    decimal_pattern_      = std::regex("^\\d+(\\.\\d+)?$");
-    hex_pattern_          = std::regex("0x[a-f0-9]+", std::regex::icase);
-    long_number_pattern_  = std::regex("\\d{4,}");
-
     LOGD(CLASSIFIER_TAG, "Loading Floret model from: "+ft_model_path);
     try {
+        auto start_load = std::chrono::steady_clock::now();
         ft_model_.loadModel(ft_model_path);
-        LOGD(CLASSIFIER_TAG, "Floret model Successfully loaded");
+
+        load_time_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_load).count();
+        matrix_kb_ = getMatrixKb(ft_model_);
+        LOGI(CLASSIFIER_TAG,
+             format_string("Floret model loaded in %lld ms, matrices %lld kB",
+                           (long long)load_time_ms_, (long long)matrix_kb_));
 
         embedding_dim_ = ft_model_.getDimension();
         LOGD(CLASSIFIER_TAG,
@@ -62,113 +76,41 @@ MLInference::MLInference(const std::string &ft_model_path) : Inference(ft_model_
         throw;
     }
 
+    FeatureExtractor::OpenJournal();
+
     LOGI(CLASSIFIER_TAG, "MLInference initialized");
     (void)ft_model_path;
 }
 
-MLInference::~MLInference() = default;
-
-std::string MLInference::CleanTextPython(const std::string &input) {
-    if (input.empty()) {
-        return "";
-    }
-
-    // Step 1: Convert to lowercase
-    std::string line = input;
-    line = AuxRoutines::toLowerCase(line);
-
-    // Step 2: Replace commas with spaces
-    std::replace(line.begin(), line.end(), ',', ' ');
+MLInference::~MLInference() {
+    FeatureExtractor::CloseJournal();
+}
 
-    // Replace brackets with spaces: [](){}
-    for (char& c : line) {
-        if (c == '[' || c == ']' || c == '(' || c == ')' || c == '{' || c == '}') {
-            c = ' ';
-        }
-    }
+void MLInference::WarmUp() {
+    auto start = std::chrono::steady_clock::now();
 
-    // Step 3: Split into tokens
-    std::istringstream iss(line);
-    std::vector<std::string> tokens;
-    std::string token;
-    while (iss >> token) {
-        tokens.push_back(token);
+    // Any text touches the dictionary and both the matrices, the column names will do.
+    std::string text;
+    for (const auto &col : text_cols_) {
+        text += col + " ";
     }
+    std::istringstream iss(CleanTextPython(text) + "\n");
 
-    // Step 4: Clean tokens (Python logic)
-    std::vector<std::string> clean_tokens;
-    std::set<std::string> seen;  // Track duplicates
-
-    for (const auto& tok : tokens) {
-        std::string t = tok;
-
-        // Trim whitespace
-        t.erase(0, t.find_first_not_of(" \t\n\r"));
-        t.erase(t.find_last_not_of(" \t\n\r") + 1);
-
-        if (t.empty()) {
-            continue;
-        }
-
-        // Skip if in REMOVE_KEYWORDS
-        if (REMOVE_KEYWORDS.find(t) != REMOVE_KEYWORDS.end()) {
-            continue;
-        }
-
-        // Skip if matches user-N.slice pattern
-        if (std::regex_match(t, user_slice_pattern_)) {
-            continue;
-        }
-
-        // Skip if matches user@N.service pattern
-        if (std::regex_match(t, user_service_pattern_)) {
-            continue;
-        }
-
-        // Skip if matches vte-spawn-*.scope pattern
-        if (std::regex_match(t, vte_spawn_pattern_)) {
-            continue;
-        }
-
-        // Skip if it's just a number (integer or decimal)
-        if (std::regex_match(t, decimal_pattern_)) {
-            continue;
-        }
-
-        // Replace hex values with <hex>
-        t = std::regex_replace(t, hex_pattern_, "<hex>");
-
-        // Replace long numbers (4+ digits) with <num>
-        t = std::regex_replace(t, long_number_pattern_, "<num>");
-
-        // Keep important browser-related terms (even if duplicate)
-        int8_t is_browser_term = false;
-        for (const auto& browser_term : BROWSER_TERMS) {
-            if (t.find(browser_term) != std::string::npos) {
-                is_browser_term = true;
-                break;
-            }
-        }
-
-        if (is_browser_term) {
-            clean_tokens.push_back(t);
-            continue;  // Skip duplicate check for browser terms
-        }
-        if(!t.empty() && t.length() > 1){
-            clean_tokens.push_back(t);
-        }
+    std::vector<int32_t> words, labels;
+    std::vector<std::pair<fasttext::real, int32_t>> predictions;
+    ft_model_.getDictionary()->getLine(iss, words, labels);
+    if (!words.empty()) {
+        ft_model_.predict(1, words, predictions, 0.0);
     }
 
-    // Step 5: Join tokens with spaces
-    std::ostringstream result;
-    for (size_t i = 0; i < clean_tokens.size(); ++i) {
-        if (i > 0) {
-            result << " ";
-        }
-        result << clean_tokens[i];
-    }
+    LOGI(CLASSIFIER_TAG,
+         format_string("Floret model warm-up took %f ms",
+                       std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - start).count()));
+}
 
-    return result.str();
+std::string MLInference::CleanTextPython(const std::string &input) {
+    return FeaturePruner::cleanText(input);
 }
 
 CC_TYPE MLInference::Classify(pid_t processPid) {
@@ -259,8 +201,6 @@ uint32_t MLInference::Predict(int pid,
                               const std::map<std::string, std::string> &rawData,
                               std::string &cat) {
 
-    std::lock_guard<std::mutex> lock(predict_mutex_);
-
     LOGD(CLASSIFIER_TAG,
              format_string("Starting prediction for PID: %d", pid));
 
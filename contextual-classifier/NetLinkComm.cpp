@@ -3,8 +3,11 @@
 
 #include <cerrno>
 #include <cstdarg>
+#include <cstddef>
 #include <cstring>
 #include <unistd.h>
+#include <arpa/inet.h>
+#include <linux/filter.h>
 
 #include "Logger.h"
 #include "AuxRoutines.h"
@@ -13,42 +16,27 @@
 
 #define CLASSIFIER_TAG "CLASSIFIER_NETLINK"
 
-static int8_t procHasControlTerminal(pid_t pid) {
-    std::string procStatPath = STAT(pid);
-    std::string stat = AuxRoutines::readFromFile(procStatPath);
-    if(stat.empty()) {
-        return false;
-    }
-
-    // Find the closing ')' of the comm field.
-    size_t pos = stat.rfind(')');
-    if(pos == std::string::npos) {
-        return false;
-    }
+// tty_nr field of /proc/<pid>/stat
+#define PROC_STAT_TTY_NR_FIELD 7
 
-    // Start parsing right after ')' and skip any spaces.
-    pos++;
-    while(pos < stat.size() && stat[pos] == ' ') {
-        pos++;
-    }
-    if(pos >= stat.size()) {
+static int8_t procHasControlTerminal(pid_t pid) {
+    std::string_view stat;
+    int64_t ttyNr = 0;
+    if(!AuxRoutines::readProcFile(pid, "stat", stat) ||
+       !AuxRoutines::getStatField(stat, PROC_STAT_TTY_NR_FIELD, ttyNr)) {
         return false;
     }
 
-    std::istringstream statStream(stat.substr(pos));
-
-    char state = '\0';
-    int64_t ppid = 0, pgrp = 0, session = 0, ttyNr = 0;
-    statStream >> state >> ppid >> pgrp >> session >> ttyNr;
-
     // For daemon / system services, tty number (controlling terminal) will be 0.
     return (ttyNr != 0);
 }
 
 static int8_t procEnvironChecks(pid_t pid) {
-    std::string environ = "/proc/" + std::to_string(pid) + "/environ";
-    std::string envData = AuxRoutines::readFromFile(environ);
-    return (envData.find("DISPLAY") != std::string::npos);
+    std::string_view envData;
+    if(!AuxRoutines::readProcFile(pid, "environ", envData)) {
+        return false;
+    }
+    return (envData.find("DISPLAY") != std::string_view::npos);
 }
 
 static int8_t procPreliminaryChecks(pid_t pid) {
@@ -65,6 +53,9 @@ static int8_t procPreliminaryChecks(pid_t pid) {
 
 NetLinkComm::NetLinkComm() {
     this->mNlSock = -1;
+    this->mBatchCount = 0;
+    this->mBatchIndex = 0;
+    this->mOverrunCount.store(0);
 }
 
 NetLinkComm::~NetLinkComm() {
@@ -101,9 +92,76 @@ int32_t NetLinkComm::connect() {
         return -1;
     }
 
+    // Bursts of events are otherwise dropped by the kernel (ENOBUFS).
+    // SO_RCVBUFFORCE lifts the rmem_max cap, but requires CAP_NET_ADMIN.
+    int32_t rcvBufSize = NETLINK_RCVBUF_SIZE;
+    if(setsockopt(this->mNlSock, SOL_SOCKET, SO_RCVBUFFORCE, &rcvBufSize, sizeof(rcvBufSize)) == -1 &&
+       setsockopt(this->mNlSock, SOL_SOCKET, SO_RCVBUF, &rcvBufSize, sizeof(rcvBufSize)) == -1) {
+        TYPELOGV(ERRNO_LOG, "setsockopt", strerror(errno));
+    }
+
+    struct timeval recvTimeout;
+    recvTimeout.tv_sec = NETLINK_RECV_TIMEOUT_MS / 1000;
+    recvTimeout.tv_usec = (NETLINK_RECV_TIMEOUT_MS % 1000) * 1000;
+    if(setsockopt(this->mNlSock, SOL_SOCKET, SO_RCVTIMEO, &recvTimeout, sizeof(recvTimeout)) == -1) {
+        TYPELOGV(ERRNO_LOG, "setsockopt", strerror(errno));
+    }
+
+    this->setupSocketFilter();
+    this->mBatchCount = 0;
+    this->mBatchIndex = 0;
+
     return this->mNlSock;
 }
 
+// Classic BPF filter, which lets only the EXEC, COMM and EXIT proc events through to userspace.
+// FORK, UID, GID, SID etc. events are dropped in the kernel, without waking up the listener.
+// Note: BPF_ABS loads are in network byte order, while netlink messages are in host byte order.
+void NetLinkComm::setupSocketFilter() {
+    const uint32_t cnIdxOffset = offsetof(NetLinkProcMsg, cn_msg) + offsetof(struct cn_msg_hdr, id) +
+                                 offsetof(struct cb_id, idx);
+    const uint32_t cnValOffset = offsetof(NetLinkProcMsg, cn_msg) + offsetof(struct cn_msg_hdr, id) +
+                                 offsetof(struct cb_id, val);
+    const uint32_t whatOffset = offsetof(NetLinkProcMsg, proc_ev) + offsetof(struct proc_event, what);
+
+    struct sock_filter filter[] = {
+        // Single part (NLMSG_DONE) messages only
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, offsetof(struct nlmsghdr, nlmsg_type)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htons(NLMSG_DONE), 1, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+
+        // From the proc connector
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, cnIdxOffset),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(CN_IDX_PROC), 1, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, cnValOffset),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(CN_VAL_PROC), 1, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+
+        // FORK, EXEC, COMM or EXIT events
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, whatOffset),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(proc_event::PROC_EVENT_FORK), 4, 0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(proc_event::PROC_EVENT_EXEC), 3, 0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(proc_event::PROC_EVENT_COMM), 2, 0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(proc_event::PROC_EVENT_EXIT), 1, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+    };
+
+    struct sock_fprog program;
+    program.len = sizeof(filter) / sizeof(filter[0]);
+    program.filter = filter;
+
+    // Not fatal, events are filtered in userspace (recvEvent) as well.
+    if(setsockopt(this->mNlSock, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) == -1) {
+        TYPELOGV(ERRNO_LOG, "setsockopt", strerror(errno));
+    }
+}
+
+uint64_t NetLinkComm::getOverrunCount() const {
+    return this->mOverrunCount.load();
+}
+
 int32_t NetLinkComm::setListen(int8_t enable) {
     struct __attribute__((aligned(NLMSG_ALIGNTO))) {
         struct nlmsghdr nl_hdr;
@@ -132,56 +190,132 @@ int32_t NetLinkComm::setListen(int8_t enable) {
     return 0;
 }
 
+// Drain up to NETLINK_RECV_BATCH_SIZE messages with a single syscall,
+// blocking only until the first one is available.
+int32_t NetLinkComm::fillBatch() {
+    struct mmsghdr msgs[NETLINK_RECV_BATCH_SIZE];
+    struct iovec iovs[NETLINK_RECV_BATCH_SIZE];
+
+    memset(msgs, 0, sizeof(msgs));
+    for(int32_t i = 0; i < NETLINK_RECV_BATCH_SIZE; i++) {
+        iovs[i].iov_base = &this->mBatch[i];
+        iovs[i].iov_len = sizeof(NetLinkProcMsg);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int32_t count = recvmmsg(this->mNlSock, msgs, NETLINK_RECV_BATCH_SIZE, MSG_WAITFORONE, nullptr);
+    if(count <= 0) {
+        return count;
+    }
+
+    for(int32_t i = 0; i < count; i++) {
+        this->mBatchLen[i] = msgs[i].msg_len;
+    }
+
+    this->mBatchCount = count;
+    this->mBatchIndex = 0;
+    return count;
+}
+
 int32_t NetLinkComm::recvEvent(ProcEvent &ev) {
     int32_t rc = 0;
-    struct __attribute__((aligned(NLMSG_ALIGNTO))) {
-        struct nlmsghdr nl_hdr;
-        struct __attribute__((__packed__)) {
-            struct cn_msg_hdr cn_msg;
-            struct proc_event proc_ev;
-        };
-    } nlcn_msg;
 
-    rc = recv(this->mNlSock, &nlcn_msg, sizeof(nlcn_msg), 0);
-    if(rc == 0) {
-        // Socket shutdown or no more data.
-        return 0;
-    }
+    if(this->mBatchIndex >= this->mBatchCount) {
+        this->mBatchCount = 0;
+        this->mBatchIndex = 0;
+
+        rc = this->fillBatch();
+        if(rc == 0) {
+            // Socket shutdown or no more data.
+            return 0;
+        }
+
+        if(rc == -1) {
+            if(errno == ENOBUFS) {
+                // The receive queue overflowed and events were lost, the socket is still usable.
+                uint64_t overruns = ++this->mOverrunCount;
+                LOGW(CLASSIFIER_TAG,
+                     "Proc events dropped by the kernel (ENOBUFS), overrun count: " + std::to_string(overruns));
+                return CC_IGNORE;
+            }
+
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Receive timed out, let the caller check if it needs to exit.
+                return CC_IGNORE;
+            }
 
-    if(rc == -1) {
-        if(errno == EINTR) {
-            // Caller (ContextualClassifier::HandleProcEv) will handle EINTR.
+            if(errno == EINTR) {
+                // Caller (ContextualClassifier::HandleProcEv) will handle EINTR.
+                return -1;
+            }
+            TYPELOGV(ERRNO_LOG, "netlink recvmmsg", strerror(errno));
             return -1;
         }
-        TYPELOGV(ERRNO_LOG, "netlink recv", strerror(errno));
-        return -1;
     }
 
+    const NetLinkProcMsg& nlcn_msg = this->mBatch[this->mBatchIndex];
+    uint32_t msgLen = this->mBatchLen[this->mBatchIndex];
+    this->mBatchIndex++;
+
     ev.pid = -1;
     ev.tgid = -1;
+    ev.ppid = -1;
     ev.type = CC_IGNORE;
+    memset(ev.comm, 0, sizeof(ev.comm));
+    rc = CC_IGNORE;
+
+    if(msgLen < offsetof(NetLinkProcMsg, proc_ev) + offsetof(struct proc_event, event_data)) {
+        // Truncated
+        return rc;
+    }
 
     switch(nlcn_msg.proc_ev.what) {
-        case PROC_EVENT_NONE:
-        case PROC_EVENT_FORK:
-        case PROC_EVENT_UID:
-        case PROC_EVENT_GID: {
+        case proc_event::PROC_EVENT_NONE:
+        case proc_event::PROC_EVENT_UID:
+        case proc_event::PROC_EVENT_GID: {
             // No actionable item.
             break;
         }
 
-        case PROC_EVENT_EXEC:
+        case proc_event::PROC_EVENT_FORK: {
+            // Threads share their process' parent, only new processes are of interest.
+            if(nlcn_msg.proc_ev.event_data.fork.child_pid != nlcn_msg.proc_ev.event_data.fork.child_tgid) {
+                break;
+            }
+            ev.pid = nlcn_msg.proc_ev.event_data.fork.child_pid;
+            ev.tgid = nlcn_msg.proc_ev.event_data.fork.child_tgid;
+            ev.ppid = nlcn_msg.proc_ev.event_data.fork.parent_tgid;
+            rc = ev.type = CC_TASK_FORK;
+            break;
+        }
+
+        case proc_event::PROC_EVENT_EXEC: {
             ev.pid = nlcn_msg.proc_ev.event_data.exec.process_pid;
             ev.tgid = nlcn_msg.proc_ev.event_data.exec.process_tgid;
-            ev.type = CC_APP_OPEN;
 
-            rc = CC_APP_OPEN;
-            if(!AuxRoutines::fileExists(COMM(ev.pid)) || !procPreliminaryChecks(ev.pid)) {
-                rc = ev.type = CC_IGNORE;
+            std::string comm;
+            if(AuxRoutines::fetchComm(ev.pid, comm) != 0 || comm.empty()) {
+                // Already exited
+                break;
+            }
+            strncpy(ev.comm, comm.c_str(), sizeof(ev.comm) - 1);
+
+            rc = ev.type = CC_APP_OPEN;
+            if(!procPreliminaryChecks(ev.pid)) {
+                rc = ev.type = CC_TASK_EXEC;
             }
             break;
+        }
+
+        case proc_event::PROC_EVENT_COMM:
+            ev.pid = nlcn_msg.proc_ev.event_data.comm.process_pid;
+            ev.tgid = nlcn_msg.proc_ev.event_data.comm.process_tgid;
+            memcpy(ev.comm, nlcn_msg.proc_ev.event_data.comm.comm, sizeof(ev.comm) - 1);
+            rc = ev.type = CC_TASK_RENAME;
+            break;
 
-        case PROC_EVENT_EXIT:
+        case proc_event::PROC_EVENT_EXIT:
             ev.pid = nlcn_msg.proc_ev.event_data.exit.process_pid;
             ev.tgid = nlcn_msg.proc_ev.event_data.exit.process_tgid;
             rc = ev.type = CC_APP_CLOSE;
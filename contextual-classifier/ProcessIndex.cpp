@@ -0,0 +1,147 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <cstring>
+#include <dirent.h>
+
+#include "Utils.h"
+#include "Logger.h"
+#include "AuxRoutines.h"
+#include "ProcessIndex.h"
+
+#define PROCESS_INDEX_TAG "PROCESS_INDEX"
+// Field number of ppid in /proc/<pid>/stat, refer proc(5)
+#define PROC_STAT_PPID_FIELD 4
+
+pid_t ProcessIndex::readParent(pid_t pid) {
+    std::string_view stat;
+    int64_t ppid = -1;
+    if(!AuxRoutines::readProcFile(pid, "stat", stat) ||
+       !AuxRoutines::getStatField(stat, PROC_STAT_PPID_FIELD, ppid)) {
+        return -1;
+    }
+    return (pid_t)ppid;
+}
+
+void ProcessIndex::populate() {
+    std::unordered_map<pid_t, TaskInfo> tasks;
+    std::unordered_map<pid_t, pid_t> parents;
+
+    DIR* procDir = opendir("/proc");
+    if(procDir == nullptr) {
+        TYPELOGV(ERRNO_LOG, "opendir", strerror(errno));
+        return;
+    }
+
+    struct dirent* procEntry;
+    while((procEntry = readdir(procDir)) != nullptr) {
+        if(procEntry->d_type != DT_DIR || !AuxRoutines::isNumericString(procEntry->d_name)) {
+            continue;
+        }
+
+        pid_t tgid = (pid_t)std::strtol(procEntry->d_name, nullptr, 10);
+        std::string taskPath = "/proc/" + std::string(procEntry->d_name) + "/task";
+        DIR* taskDir = opendir(taskPath.c_str());
+        if(taskDir == nullptr) {
+            // Exited meanwhile
+            continue;
+        }
+
+        pid_t ppid = readParent(tgid);
+        if(ppid >= 0) {
+            parents[tgid] = ppid;
+        }
+
+        struct dirent* taskEntry;
+        while((taskEntry = readdir(taskDir)) != nullptr) {
+            if(!AuxRoutines::isNumericString(taskEntry->d_name)) {
+                continue;
+            }
+
+            pid_t tid = (pid_t)std::strtol(taskEntry->d_name, nullptr, 10);
+            std::string comm;
+            if(AuxRoutines::fetchComm(tid, comm) == 0 && !comm.empty()) {
+                tasks[tid] = {tgid, comm};
+            }
+        }
+        closedir(taskDir);
+    }
+    closedir(procDir);
+
+    const std::lock_guard<std::mutex> lock(this->mIndexMutex);
+    this->mTasks = std::move(tasks);
+    this->mParents = std::move(parents);
+
+    LOGI(PROCESS_INDEX_TAG, "Indexed " + std::to_string(this->mTasks.size()) + " tasks");
+}
+
+void ProcessIndex::update(pid_t tid, pid_t tgid, const std::string& comm) {
+    const std::lock_guard<std::mutex> lock(this->mIndexMutex);
+    this->mTasks[tid] = {tgid, comm};
+}
+
+void ProcessIndex::setParent(pid_t tgid, pid_t ppid) {
+    const std::lock_guard<std::mutex> lock(this->mIndexMutex);
+    this->mParents[tgid] = ppid;
+}
+
+void ProcessIndex::recordFork(pid_t pid, pid_t ppid) {
+    const std::lock_guard<std::mutex> lock(this->mIndexMutex);
+    this->mParents[pid] = ppid;
+
+    // The child runs under its parent's comm, until it execs or renames itself.
+    auto it = this->mTasks.find(ppid);
+    if(it != this->mTasks.end()) {
+        this->mTasks[pid] = {pid, it->second.mComm};
+    }
+}
+
+void ProcessIndex::remove(pid_t tid) {
+    const std::lock_guard<std::mutex> lock(this->mIndexMutex);
+    this->mTasks.erase(tid);
+    this->mParents.erase(tid);
+}
+
+// Expects mIndexMutex to be held.
+int8_t ProcessIndex::isDescendantLocked(pid_t tgid, pid_t ancestor) {
+    for(int32_t depth = 0; depth < PROCESS_INDEX_MAX_ANCESTRY_DEPTH; depth++) {
+        auto it = this->mParents.find(tgid);
+        if(it == this->mParents.end() || it->second <= 1) {
+            return false;
+        }
+        if(it->second == ancestor) {
+            return true;
+        }
+        tgid = it->second;
+    }
+    return false;
+}
+
+int8_t ProcessIndex::isDescendant(pid_t tgid, pid_t ancestor) {
+    const std::lock_guard<std::mutex> lock(this->mIndexMutex);
+    return this->isDescendantLocked(tgid, ancestor);
+}
+
+std::vector<pid_t> ProcessIndex::findTasks(const std::string& name, pid_t tgid) {
+    std::vector<pid_t> tids;
+    if(name.empty()) {
+        return tids;
+    }
+
+    const std::lock_guard<std::mutex> lock(this->mIndexMutex);
+    for(const auto& entry: this->mTasks) {
+        if(entry.second.mComm.find(name) == std::string::npos) {
+            continue;
+        }
+        if(entry.second.mTgid != tgid && !this->isDescendantLocked(entry.second.mTgid, tgid)) {
+            continue;
+        }
+        tids.push_back(entry.first);
+    }
+    return tids;
+}
+
+size_t ProcessIndex::size() {
+    const std::lock_guard<std::mutex> lock(this->mIndexMutex);
+    return this->mTasks.size();
+}
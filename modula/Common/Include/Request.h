@@ -40,6 +40,14 @@ public:
 
     ErrCode deserialize(char* buf);
 
+    /**
+     * @brief Encode a Tune Request in the wire format accepted by deserialize.
+     * @return int32_t:\n
+     *            - Number of bytes written to buf\n
+     *            - -1: if the Request does not fit in bufSize bytes.
+     */
+    int32_t serialize(char* buf, int32_t bufSize);
+
     void populateUntuneRequest(Request* request);
     void populateRetuneRequest(Request* request, int64_t duration);
     static void cleanUpRequest(Request* request);
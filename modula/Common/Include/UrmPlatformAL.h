@@ -219,6 +219,7 @@ X(CLUSTER_PLUS_CORE_2,        0x00000203) \
 X(CLUSTER_PLUS_CORE_3,        0x00000204) \
 /* misc */                                \
 X(DEFAULT_SIGNAL_TYPE,        0x00000000) \
+X(BACKGROUND_SIGNAL_TYPE,     0x00000001) \
 
 enum ResCodesDef {
 #define X(name, value) name = value,
@@ -281,6 +282,7 @@ enum {
     URM_SIG_BROWSER_APP_OPEN            = 0x00020002,
     URM_SIG_GAME_APP_OPEN               = 0x00020003,
     URM_SIG_MULTIMEDIA_APP_OPEN         = 0x00020004,
+    URM_SIG_APP_FOCUS                   = 0x00020005,
 
     // Multimedia
     URM_SIG_VIDEO_DECODE                = 0x00030001,
@@ -32,7 +32,8 @@ enum RequestType : int8_t {
     REQ_PROP_GET,
     REQ_SIGNAL_TUNING,
     REQ_SIGNAL_UNTUNING,
-    REQ_SIGNAL_RELAY
+    REQ_SIGNAL_RELAY,
+    REQ_CLIENT_TEARDOWN, //!< Internal only, issued by the Garbage Collector for a dead client thread.
 };
 
 /**
@@ -105,6 +106,7 @@ typedef struct {
 typedef ErrCode (*EventCallback)(void*);
 typedef int8_t (*ServerOnlineCheckCallback)();
 typedef void (*MessageReceivedCallback)(int32_t, MsgForwardInfo*);
+typedef void (*ServerReadyCallback)(int8_t);
 
 #define HIGH_TRANSFER_PRIORITY -1
 #define SERVER_CLEANUP_TRIGGER_PRIORITY -2
@@ -124,6 +126,12 @@ typedef void (*MessageReceivedCallback)(int32_t, MsgForwardInfo*);
 #define LOGGER_LOGGING_LEVEL_TYPE "urm.logging.level.exact"
 #define LOGGER_LOGGING_OUTPUT_REDIRECT "urm.logging.redirect_to"
 #define URM_MAX_PLUGIN_COUNT "urm.extensions_lib.count"
+#define CLASSIFIER_CACHE_SIZE "urm.classifier.cache.size"
+#define CLASSIFIER_CACHE_PERSIST "urm.classifier.cache.persist"
+#define CLASSIFIER_SETTLE_DELAY "urm.classifier.settle_delay_ms"
+#define CLASSIFIER_WORKER_COUNT "urm.classifier.workers"
+#define CLASSIFIER_QUEUE_SIZE "urm.classifier.queue.size"
+#define CLASSIFIER_MODEL_WARMUP "urm.classifier.model.warmup"
 
 #define COMM(pid) ("/proc/" + std::to_string(pid) + "/comm")
 #define COMM_S(pidstr) ("/proc/" + pidstr + "/comm")
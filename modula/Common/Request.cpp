@@ -1,6 +1,8 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <cstring>
+
 #include "Request.h"
 
 Request::Request() {
@@ -150,6 +152,58 @@ ErrCode Request::deserialize(char* buf) {
     return RC_SUCCESS;
 }
 
+int32_t Request::serialize(char* buf, int32_t bufSize) {
+    if(buf == nullptr || bufSize <= 0) return -1;
+
+    int32_t offset = 0;
+    auto append = [&](const void* data, int32_t size) {
+        if(offset < 0 || offset + size > bufSize) {
+            offset = -1;
+            return;
+        }
+        std::memcpy(buf + offset, data, size);
+        offset += size;
+    };
+
+    // Same encoding order as the Client APIs, refer tuneResources
+    int8_t moduleID = MOD_RESTUNE;
+    int32_t numResources = this->getResourcesCount();
+
+    append(&moduleID, sizeof(moduleID));
+    append(&this->mReqType, sizeof(this->mReqType));
+    append(&this->mHandle, sizeof(this->mHandle));
+    append(&this->mDuration, sizeof(this->mDuration));
+    append(&numResources, sizeof(numResources));
+    append(&this->mProperties, sizeof(this->mProperties));
+    append(&this->mClientPID, sizeof(this->mClientPID));
+    append(&this->mClientTID, sizeof(this->mClientTID));
+
+    if(this->mResourceList != nullptr) {
+        DL_ITERATE(this->mResourceList) {
+            if(iter == nullptr) continue;
+            Resource* resource = (Resource*)((ResIterable*)iter)->mData;
+            if(resource == nullptr) return -1;
+
+            uint32_t resCode = resource->getResCode();
+            int32_t resInfo = resource->getResInfo();
+            int32_t optionalInfo = resource->getOptionalInfo();
+            int32_t numValues = resource->getValuesCount();
+
+            append(&resCode, sizeof(resCode));
+            append(&resInfo, sizeof(resInfo));
+            append(&optionalInfo, sizeof(optionalInfo));
+            append(&numValues, sizeof(numValues));
+
+            for(int32_t i = 0; i < numValues; i++) {
+                int32_t value = resource->getValueAt(i);
+                append(&value, sizeof(value));
+            }
+        }
+    }
+
+    return offset;
+}
+
 // Request Utils
 void Request::cleanUpRequest(Request* request) {
     if(request == nullptr) {
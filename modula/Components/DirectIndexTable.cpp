@@ -0,0 +1,74 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include "DirectIndexTable.h"
+
+DirectIndexTable::DirectIndexTable() {
+    this->reset();
+}
+
+void DirectIndexTable::reset() {
+    this->mReady = false;
+    for(uint32_t i = 0; i < mMajorKeySpace; i++) {
+        this->mMinorBase[i] = 0;
+        this->mMinorSpan[i] = 0;
+        this->mOffset[i] = 0;
+        this->mOverflow[i] = false;
+    }
+    this->mSlots.clear();
+}
+
+void DirectIndexTable::build(const std::vector<std::pair<uint32_t, int32_t>>& entries) {
+    this->reset();
+
+    // Pass 1: Compute the [min, max] minor key range for each major key.
+    uint32_t minorMin[mMajorKeySpace];
+    uint32_t minorMax[mMajorKeySpace];
+    int8_t used[mMajorKeySpace];
+    for(uint32_t i = 0; i < mMajorKeySpace; i++) {
+        minorMin[i] = UINT32_MAX;
+        minorMax[i] = 0;
+        used[i] = false;
+    }
+
+    for(const std::pair<uint32_t, int32_t>& entry: entries) {
+        if(entry.first >> 24) continue;
+        uint32_t major = entry.first >> 16;
+        uint32_t minor = entry.first & 0xffff;
+
+        used[major] = true;
+        if(minor < minorMin[major]) minorMin[major] = minor;
+        if(minor > minorMax[major]) minorMax[major] = minor;
+    }
+
+    // Pass 2: Lay out the second level, one dense block per major key.
+    uint32_t totalSlots = 0;
+    for(uint32_t major = 0; major < mMajorKeySpace; major++) {
+        if(!used[major]) continue;
+
+        uint32_t span = minorMax[major] - minorMin[major] + 1;
+        if(span > mMaxMinorSpan) {
+            // Too sparse, let the caller resolve these through its own index.
+            this->mOverflow[major] = true;
+            continue;
+        }
+
+        this->mMinorBase[major] = minorMin[major];
+        this->mMinorSpan[major] = span;
+        this->mOffset[major] = totalSlots;
+        totalSlots += span;
+    }
+
+    // Pass 3: Populate the slots.
+    this->mSlots.assign(totalSlots, -1);
+    for(const std::pair<uint32_t, int32_t>& entry: entries) {
+        if(entry.first >> 24) continue;
+        uint32_t major = entry.first >> 16;
+        uint32_t minor = entry.first & 0xffff;
+
+        if(this->mOverflow[major]) continue;
+        this->mSlots[this->mOffset[major] + (minor - this->mMinorBase[major])] = entry.second;
+    }
+
+    this->mReady = true;
+}
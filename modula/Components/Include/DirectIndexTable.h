@@ -0,0 +1,84 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef DIRECT_INDEX_TABLE_H
+#define DIRECT_INDEX_TABLE_H
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+/**
+ * @brief Returned by DirectIndexTable::lookup when the key cannot be resolved through
+ *        the direct table, and the caller needs to consult its own (slower) index instead.
+ */
+#define DIRECT_INDEX_FALLBACK -2
+
+/**
+ * @brief Two-level direct-indexed lookup table, mapping 24-bit codes to table indices.
+ * @details Resource and Signal codes share the same layout: an 8-bit major key (ResType or
+ *          Signal Category) in bits 17-24, and a 16-bit minor key (ResID or SignalID) in the
+ *          lower 16 bits. The first level is indexed by the major key, and points into a dense,
+ *          flattened second level covering [min, max] of the minor keys registered under it.
+ *          This makes the hot-path lookup a couple of array accesses, instead of a hash-map probe.\n
+ *          Major keys whose minor key span is too sparse to be stored compactly are not expanded,
+ *          lookups for them return DIRECT_INDEX_FALLBACK.
+ */
+class DirectIndexTable {
+private:
+    static const uint32_t mMajorKeySpace = 256;
+    static const uint32_t mMaxMinorSpan = 4096;
+
+    int8_t mReady;
+    uint32_t mMinorBase[mMajorKeySpace];
+    uint32_t mMinorSpan[mMajorKeySpace];
+    uint32_t mOffset[mMajorKeySpace];
+    int8_t mOverflow[mMajorKeySpace];
+    std::vector<int32_t> mSlots;
+
+public:
+    DirectIndexTable();
+
+    /**
+     * @brief Build the table from the given (code, index) pairs.
+     * @details Any previously built state is discarded. Codes with any of the upper 8 bits set
+     *          are skipped. An index of DIRECT_INDEX_FALLBACK can be stored to force callers
+     *          onto their slow path for a particular code.
+     * @param entries List of (code, index) pairs
+     */
+    void build(const std::vector<std::pair<uint32_t, int32_t>>& entries);
+
+    /**
+     * @brief Discard the table contents, subsequent lookups return DIRECT_INDEX_FALLBACK.
+     */
+    void reset();
+
+    int8_t isReady() const {
+        return this->mReady;
+    }
+
+    /**
+     * @brief Resolve a code to its table index.
+     * @param code 24-bit Resource or Signal code
+     * @return int32_t:\n
+     *            - Index (>= 0) stored for the code
+     *            - -1: If the code is not present
+     *            - DIRECT_INDEX_FALLBACK: If the table cannot answer for this code
+     */
+    int32_t lookup(uint32_t code) const {
+        if(!this->mReady) return DIRECT_INDEX_FALLBACK;
+        if(code >> 24) return -1;
+
+        uint32_t major = code >> 16;
+        uint32_t minor = (code & 0xffff) - this->mMinorBase[major];
+
+        // Note: minor wraps around for keys below the base, and fails this check as well.
+        if(minor >= this->mMinorSpan[major]) {
+            return this->mOverflow[major] ? DIRECT_INDEX_FALLBACK : -1;
+        }
+
+        return this->mSlots[this->mOffset[major] + minor];
+    }
+};
+
+#endif
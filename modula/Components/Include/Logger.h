@@ -10,14 +10,32 @@
 #include <fstream>
 #include <cstdarg>
 #include <sstream>
+#include <cstdint>
 #include <syslog.h>
 
-#define LOGD(tag, message) Logger::log(LOG_DEBUG, tag, __func__, message)
-#define LOGI(tag, message) Logger::log(LOG_INFO, tag, __func__, message)
-#define LOGE(tag, message) Logger::log(LOG_ERR, tag, __func__, message)
-#define LOGW(tag, message) Logger::log(LOG_WARNING, tag, __func__, message)
-#define TYPELOGV(type, args...) Logger::typeLog(type, __func__, args)
-#define TYPELOGD(type) Logger::typeLog(type, __func__)
+// Least severe level compiled in, statements below it are discarded at compile time.
+// Set via the LOG_MIN_LEVEL build option.
+#ifndef URM_LOG_COMPILED_LEVEL
+#define URM_LOG_COMPILED_LEVEL LOG_DEBUG
+#endif
+
+// The level is checked before the statement (and hence any of the message arguments)
+// is evaluated, so that disabled log statements cost just a branch.
+#define URM_LOG_IF(level, statement)                                                  \
+    do {                                                                              \
+        if((level) <= URM_LOG_COMPILED_LEVEL && Logger::isLevelEnabled(level)) {     \
+            statement;                                                                \
+        }                                                                             \
+    } while(0)
+
+#define LOGD(tag, message) URM_LOG_IF(LOG_DEBUG, Logger::log(LOG_DEBUG, tag, __func__, message))
+#define LOGI(tag, message) URM_LOG_IF(LOG_INFO, Logger::log(LOG_INFO, tag, __func__, message))
+#define LOGE(tag, message) URM_LOG_IF(LOG_ERR, Logger::log(LOG_ERR, tag, __func__, message))
+#define LOGW(tag, message) URM_LOG_IF(LOG_WARNING, Logger::log(LOG_WARNING, tag, __func__, message))
+#define TYPELOGV(type, args...) \
+    URM_LOG_IF(Logger::getTypeLogLevel(type), Logger::typeLog(type, __func__, args))
+#define TYPELOGD(type) \
+    URM_LOG_IF(Logger::getTypeLogLevel(type), Logger::typeLog(type, __func__))
 
 enum RedirectOptions {
     LOG_TOFILE,
@@ -122,6 +140,10 @@ enum CommonMessageTypes {
  *          1. Debug - For almost all non-essential debug statements.
  *          2. Info - For essential statements.
  *          3. Error - Statements if printed, shows errors.
+ *          For File output, Messages are formatted on the calling thread and handed to a
+ *          lock-free ring buffer, which is drained into a persistent fd by a background thread.
+ *          Under overload, Messages are dropped (and counted) instead of blocking the caller.
+ *          Ftrace output is written directly by the calling thread, one trace event per Message.
  */
 class Logger {
 private:
@@ -156,6 +178,66 @@ public:
     static void log(int32_t level, const std::string& tag, const std::string& funcName, const char* message);
     static void log(int32_t level, const std::string& tag, const std::string& funcName, const std::string& message);
     static void typeLog(CommonMessageTypes type, const std::string& funcName, ...);
+
+    static inline int8_t isLevelEnabled(int32_t level) {
+        if(mLevelSpecificLogging) {
+            return level == mLowestLogLevel;
+        }
+        return level <= mLowestLogLevel;
+    }
+
+    /**
+     * @brief Level at which a CommonMessageTypes Message is logged by typeLog.
+     * @details Used by the TYPELOGV and TYPELOGD macros to filter Messages before their arguments
+     *          are evaluated. Must be kept in sync with typeLog, any type not listed here is
+     *          treated as an error, so that it is never filtered out by mistake.
+     */
+    static constexpr int32_t getTypeLogLevel(CommonMessageTypes type) {
+        switch(type) {
+            case NOTIFY_COCO_TABLE_INSERT_START:
+            case NOTIFY_COCO_TABLE_INSERT_SUCCESS:
+            case NOTIFY_COCO_TABLE_UPDATE_START:
+            case NOTIFY_COCO_TABLE_REMOVAL_START:
+            case NOTIFY_COCO_TABLE_REQUEST_EXPIRY:
+            case NOTIFY_COCO_TABLE_WRITE:
+            case NOTIFY_CLASSIFIER_PROC_EVENT:
+            case NOTIFY_CLASSIFIER_PROC_IGNORE:
+                return LOG_DEBUG;
+
+            case NOTIFY_MODULE_ENABLED:
+            case LISTENER_THREAD_CREATION_SUCCESS:
+            case NOTIFY_RESOURCE_TUNER_INIT_START:
+            case NOTIFY_CURRENT_TARGET_NAME:
+            case NOTIFY_EXTENSIONS_LIB_NOT_PRESENT:
+            case NOTIFY_EXTENSIONS_LIB_LOADED_SUCCESS:
+            case VERIFIER_REQUEST_VALIDATED:
+            case NOTIFY_NODE_WRITE:
+            case NOTIFY_NODE_WRITE_S:
+            case NOTIFY_NODE_RESET:
+            case RATE_LIMITER_RATE_LIMITED:
+            case NOTIFY_PARSING_START:
+            case NOTIFY_PARSING_SUCCESS:
+            case NOTIFY_PARSER_FILE_NOT_FOUND:
+            case LOGICAL_TO_PHYSICAL_MAPPING_GEN_SUCCESS:
+            case NOTIFY_MODEL_PREDICTION:
+                return LOG_INFO;
+
+            default:
+                return LOG_ERR;
+        }
+    }
+
+    /**
+     * @brief Block until all the Messages logged so far have been written out.
+     * @details File output is written asynchronously, by a background flusher thread
+     *          draining a bounded ring buffer. Syslog and Ftrace outputs are not affected.
+     */
+    static void flush();
+
+    /**
+     * @brief Number of Messages dropped so far, since the ring buffer was full.
+     */
+    static uint64_t getDroppedCount();
 };
 
 #endif
@@ -1,9 +1,298 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "Logger.h"
 
 #define LOGFILE "/tmp/urm.log"
+#define FTRACE_MARKER "/sys/kernel/debug/tracing/trace_marker"
+
+// Ring Buffer Geometry, both need to be a power of 2.
+#define LOG_RING_SLOTS 512
+#define LOG_RING_SLOT_SIZE 512
+
+// Max time the flusher sleeps for, if a wakeup is missed.
+#define LOG_FLUSH_INTERVAL_MS 50
+
+/**
+ * @brief Bounded multi-producer, single-consumer ring of formatted log lines.
+ * @details Each slot carries a sequence number, producers claim a slot by a CAS on the
+ *          enqueue position and publish it by advancing the slot's sequence, hence no lock
+ *          is taken on the logging path. If the ring is full, the line is dropped and counted.
+ *          A background flusher thread drains the ring in batches into a persistent fd.
+ *          Only used for file output, refer writeTraceMarker for ftrace.
+ */
+typedef struct {
+    std::atomic<uint64_t> mSequence;
+    uint32_t mLength;
+    char mData[LOG_RING_SLOT_SIZE];
+} LogSlot;
+
+class LogRing {
+private:
+    LogSlot mSlots[LOG_RING_SLOTS];
+    std::atomic<uint64_t> mEnqueuePos;
+    uint64_t mDequeuePos;
+
+    std::atomic<uint64_t> mDroppedCount;
+    uint64_t mReportedDropCount;
+
+    std::atomic<int32_t> mFd;
+    std::atomic<int8_t> mRunning;
+    std::atomic<uint64_t> mFlushedPos;
+    std::thread mFlusher;
+    std::once_flag mFlusherStarted;
+    std::mutex mWakeupMutex;
+    std::condition_variable mWakeup;
+    std::condition_variable mDrained;
+
+    void drain();
+    void flusherLoop();
+    void writeAll(const char* data, size_t length);
+
+public:
+    LogRing();
+    ~LogRing();
+
+    void setTarget(const char* path);
+    void closeTarget();
+    void push(const char* line, size_t length);
+    void flush();
+
+    uint64_t getDroppedCount() {
+        return this->mDroppedCount.load(std::memory_order_relaxed);
+    }
+};
+
+LogRing::LogRing() {
+    for(uint64_t i = 0; i < LOG_RING_SLOTS; i++) {
+        this->mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+        this->mSlots[i].mLength = 0;
+    }
+
+    this->mEnqueuePos.store(0);
+    this->mDequeuePos = 0;
+    this->mFlushedPos.store(0);
+    this->mDroppedCount.store(0);
+    this->mReportedDropCount = 0;
+    this->mFd.store(-1);
+    this->mRunning.store(false);
+}
+
+void LogRing::setTarget(const char* path) {
+    int32_t fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    int32_t prevFd = this->mFd.exchange(fd);
+
+    if(prevFd >= 0) {
+        // Lines already in the ring, will end up in the new target.
+        close(prevFd);
+    }
+}
+
+void LogRing::closeTarget() {
+    // Lines already in the ring belong to the file, write them out before letting go.
+    this->flush();
+
+    int32_t prevFd = this->mFd.exchange(-1);
+    if(prevFd >= 0) {
+        close(prevFd);
+    }
+}
+
+void LogRing::push(const char* line, size_t length) {
+    std::call_once(this->mFlusherStarted, [this]() {
+        this->mRunning.store(true);
+        try {
+            this->mFlusher = std::thread(&LogRing::flusherLoop, this);
+        } catch(const std::system_error& e) {
+            this->mRunning.store(false);
+        }
+    });
+
+    if(!this->mRunning.load(std::memory_order_acquire)) {
+        // No flusher (creation failed, or process is exiting), write synchronously.
+        this->writeAll(line, length);
+        return;
+    }
+
+    if(length > LOG_RING_SLOT_SIZE) {
+        // Does not fit a slot, written directly once the lines queued ahead of it are out.
+        this->flush();
+        this->writeAll(line, length);
+        return;
+    }
+
+    uint64_t pos = this->mEnqueuePos.load(std::memory_order_relaxed);
+    LogSlot* slot = nullptr;
+
+    for(;;) {
+        slot = &this->mSlots[pos & (LOG_RING_SLOTS - 1)];
+        uint64_t seq = slot->mSequence.load(std::memory_order_acquire);
+        int64_t diff = (int64_t)seq - (int64_t)pos;
+
+        if(diff == 0) {
+            if(this->mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if(diff < 0) {
+            // Ring is full, drop the line rather than blocking the caller.
+            this->mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+            this->mWakeup.notify_one();
+            return;
+        } else {
+            pos = this->mEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    memcpy(slot->mData, line, length);
+    slot->mLength = (uint32_t)length;
+    slot->mSequence.store(pos + 1, std::memory_order_release);
+    this->mWakeup.notify_one();
+}
+
+void LogRing::writeAll(const char* data, size_t length) {
+    int32_t fd = this->mFd.load(std::memory_order_relaxed);
+    if(fd < 0) return;
+
+    while(length > 0) {
+        ssize_t written = write(fd, data, length);
+        if(written < 0) {
+            if(errno == EINTR) continue;
+            return;
+        }
+
+        data += written;
+        length -= written;
+    }
+}
+
+// Only called from the flusher thread (or at exit, once the flusher has been joined).
+void LogRing::drain() {
+    char batch[LOG_RING_SLOT_SIZE * 8];
+    size_t batchLength = 0;
+
+    for(;;) {
+        LogSlot* slot = &this->mSlots[this->mDequeuePos & (LOG_RING_SLOTS - 1)];
+        uint64_t seq = slot->mSequence.load(std::memory_order_acquire);
+        if(seq != this->mDequeuePos + 1) {
+            break;
+        }
+
+        if(batchLength + slot->mLength > sizeof(batch)) {
+            this->writeAll(batch, batchLength);
+            batchLength = 0;
+        }
+
+        memcpy(batch + batchLength, slot->mData, slot->mLength);
+        batchLength += slot->mLength;
+
+        // Release the slot, for the producer one lap ahead.
+        slot->mSequence.store(this->mDequeuePos + LOG_RING_SLOTS, std::memory_order_release);
+        this->mDequeuePos++;
+    }
+
+    if(batchLength > 0) {
+        this->writeAll(batch, batchLength);
+    }
+
+    uint64_t droppedCount = this->mDroppedCount.load(std::memory_order_relaxed);
+    if(droppedCount != this->mReportedDropCount) {
+        int32_t len = snprintf(batch, sizeof(batch),
+                               "[LOGGER] %lu log messages dropped, ring buffer full\n",
+                               (unsigned long)(droppedCount - this->mReportedDropCount));
+        if(len > 0) {
+            this->writeAll(batch, len);
+        }
+        this->mReportedDropCount = droppedCount;
+    }
+
+    this->mFlushedPos.store(this->mDequeuePos, std::memory_order_release);
+}
+
+void LogRing::flusherLoop() {
+    while(this->mRunning.load(std::memory_order_acquire)) {
+        this->drain();
+        this->mDrained.notify_all();
+
+        std::unique_lock<std::mutex> lock(this->mWakeupMutex);
+        this->mWakeup.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS));
+    }
+}
+
+void LogRing::flush() {
+    if(!this->mRunning.load(std::memory_order_acquire)) return;
+
+    uint64_t target = this->mEnqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(this->mWakeupMutex);
+    while(this->mFlushedPos.load(std::memory_order_acquire) < target &&
+          this->mRunning.load(std::memory_order_acquire)) {
+        this->mWakeup.notify_one();
+        this->mDrained.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS));
+    }
+}
+
+LogRing::~LogRing() {
+    if(this->mRunning.exchange(false)) {
+        this->mWakeup.notify_one();
+        if(this->mFlusher.joinable()) {
+            this->mFlusher.join();
+        }
+    }
+
+    // Flush any remaining lines, subsequent logs (if any) are written synchronously.
+    this->drain();
+}
+
+static LogRing logRing;
+
+// Every write to trace_marker is recorded as a separate trace event, timestamped at the
+// time of the write. Hence ftrace output bypasses the ring, each line is written directly
+// by the logging thread, so that it lands in the trace in place.
+static std::atomic<int32_t> ftraceFd(-1);
+
+static void setFtraceTarget(int8_t enable) {
+    int32_t fd = enable ? open(FTRACE_MARKER, O_WRONLY | O_CLOEXEC) : -1;
+    int32_t prevFd = ftraceFd.exchange(fd);
+
+    if(prevFd >= 0) {
+        close(prevFd);
+    }
+}
+
+static void writeTraceMarker(const char* line, size_t length) {
+    int32_t fd = ftraceFd.load(std::memory_order_relaxed);
+    if(fd < 0) return;
+
+    // Single write, a partial one would otherwise be split across two events.
+    ssize_t written;
+    do {
+        written = write(fd, line, length);
+    } while(written < 0 && errno == EINTR);
+}
+
+// localtime and strftime are only invoked once per second per thread, the formatted
+// timestamp is reused for all the lines logged within the same second.
+static const char* getCachedTimestamp() {
+    static thread_local time_t cachedSecond = 0;
+    static thread_local char cachedTimestamp[32] = {0};
+
+    time_t now = time(nullptr);
+    if(now != cachedSecond) {
+        tm localTm;
+        localtime_r(&now, &localTm);
+        strftime(cachedTimestamp, sizeof(cachedTimestamp), "%Y-%m-%d %H:%M:%S", &localTm);
+        cachedSecond = now;
+    }
+
+    return cachedTimestamp;
+}
 
 int32_t Logger::mLowestLogLevel = LOG_DEBUG;
 int8_t Logger::mLevelSpecificLogging = false;
@@ -13,16 +302,18 @@ void Logger::configure(int32_t level, int8_t levelSpecificLogging, RedirectOptio
     mLowestLogLevel = level;
     mLevelSpecificLogging = levelSpecificLogging;
     mRedirectOutputTo = redirectOutputTo;
+
+    if(redirectOutputTo == RedirectOptions::LOG_TOFILE) {
+        logRing.setTarget(LOGFILE);
+    } else {
+        logRing.closeTarget();
+    }
+
+    setFtraceTarget(redirectOutputTo == RedirectOptions::LOG_TOFTRACE);
 }
 
 std::string Logger::getTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    time_t now_c = std::chrono::system_clock::to_time_t(now);
-    tm local_tm = *localtime(&now_c);
-
-    char buffer[64];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_tm);
-    return std::string(buffer);
+    return std::string(getCachedTimestamp());
 }
 
 const char* Logger::levelToString(int32_t level) {
@@ -51,7 +342,6 @@ void Logger::log(int32_t level,
         if(level > mLowestLogLevel) return;
     }
 
-    std::string timestamp = getTimestamp();
     const char* levelStr = levelToString(level);
 
     switch(mRedirectOutputTo) {
@@ -60,20 +350,32 @@ void Logger::log(int32_t level,
             break;
         }
 
-        case RedirectOptions::LOG_TOFTRACE: {
-            std::ofstream logFile("/sys/kernel/debug/tracing/trace_marker", std::ios::app);
-            if(logFile.is_open()) {
-                logFile<<"["<<timestamp<<"] ["<<tag<<"] ["<<levelStr<<"] "<<funcName<<": "<<message<<std::endl;
-                logFile.close();
+        case RedirectOptions::LOG_TOFTRACE:
+        case RedirectOptions::LOG_TOFILE: {
+            // Format on the calling thread, for files the actual write is deferred to the flusher.
+            char line[LOG_RING_SLOT_SIZE];
+            int32_t length = snprintf(line, sizeof(line), "[%s] [%s] [%s] %s: %s\n",
+                                      getCachedTimestamp(), tag.c_str(), levelStr,
+                                      funcName.c_str(), message);
+            if(length >= (int32_t)sizeof(line)) {
+                // Too long for a ring slot, format it in full, it is written out directly.
+                std::string longLine(length, '\0');
+                snprintf(&longLine[0], length + 1, "[%s] [%s] [%s] %s: %s\n",
+                         getCachedTimestamp(), tag.c_str(), levelStr, funcName.c_str(), message);
+                if(mRedirectOutputTo == RedirectOptions::LOG_TOFTRACE) {
+                    writeTraceMarker(longLine.data(), longLine.length());
+                } else {
+                    logRing.push(longLine.data(), longLine.length());
+                }
+                break;
             }
-            break;
-        }
 
-        case RedirectOptions::LOG_TOFILE: {
-            std::ofstream logFile(LOGFILE, std::ios::app);
-            if(logFile.is_open()) {
-                logFile<<"["<<timestamp<<"] ["<<tag<<"] ["<<levelStr<<"] "<<funcName<<": "<<message<<std::endl;
-                logFile.close();
+            if(length > 0) {
+                if(mRedirectOutputTo == RedirectOptions::LOG_TOFTRACE) {
+                    writeTraceMarker(line, length);
+                } else {
+                    logRing.push(line, length);
+                }
             }
             break;
         }
@@ -87,43 +389,15 @@ void Logger::log(int32_t level,
                  const std::string& tag,
                  const std::string& funcName,
                  const std::string& message) {
+    Logger::log(level, tag, funcName, message.c_str());
+}
 
-    if(mLevelSpecificLogging) {
-        if(level != mLowestLogLevel) return;
-    } else {
-        if(level > mLowestLogLevel) return;
-    }
-
-    std::string timestamp = getTimestamp();
-    const char* levelStr = levelToString(level);
-
-    switch(mRedirectOutputTo) {
-        case RedirectOptions::LOG_TOSYSLOG: {
-            syslog(level, "[%s] [%s] %s: %s", tag.c_str(), levelStr, funcName.c_str(), message.c_str());
-            break;
-        }
-
-        case RedirectOptions::LOG_TOFTRACE: {
-            std::ofstream logFile("/sys/kernel/debug/tracing/trace_marker", std::ios::app);
-            if(logFile.is_open()) {
-                logFile<<"["<<timestamp<<"] ["<<tag<<"] ["<<levelStr<<"] "<<funcName<<": "<<message<<std::endl;
-                logFile.close();
-            }
-            break;
-        }
-
-        case RedirectOptions::LOG_TOFILE: {
-            std::ofstream logFile(LOGFILE, std::ios::app);
-            if(logFile.is_open()) {
-                logFile<<"["<<timestamp<<"] ["<<tag<<"] ["<<levelStr<<"] "<<funcName<<": "<<message<<std::endl;
-                logFile.close();
-            }
-            break;
-        }
+void Logger::flush() {
+    logRing.flush();
+}
 
-        default:
-            break;
-    }
+uint64_t Logger::getDroppedCount() {
+    return logRing.getDroppedCount();
 }
 
 void Logger::typeLog(CommonMessageTypes type, const std::string& funcName, ...) {
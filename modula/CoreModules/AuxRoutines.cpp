@@ -1,28 +1,197 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <cstdlib>
+#include <charconv>
+#include <fcntl.h>
+
 #include "AuxRoutines.h"
 
+#define FAST_READ_INITIAL_BUFFER_SIZE 4096
+
 std::mutex AuxRoutines::handleGenLock {};
 
+static int32_t openDirFd(const char* dirPath) {
+    return open(dirPath, O_PATH | O_DIRECTORY | O_CLOEXEC);
+}
+
+static int32_t getProcDirFd() {
+    static const int32_t procDirFd = openDirFd("/proc");
+    return procDirFd;
+}
+
+static int32_t getSysDirFd() {
+    static const int32_t sysDirFd = openDirFd("/sys");
+    return sysDirFd;
+}
+
+// Reads the whole file into the calling thread's buffer.
+static int8_t readFd(int32_t fd, std::string_view& contents) {
+    thread_local std::vector<char> buffer(FAST_READ_INITIAL_BUFFER_SIZE);
+
+    size_t length = 0;
+    while(true) {
+        if(length == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+
+        ssize_t bytesRead = read(fd, buffer.data() + length, buffer.size() - length);
+        if(bytesRead < 0) {
+            if(errno == EINTR) continue;
+            return false;
+        }
+        if(bytesRead == 0) {
+            break;
+        }
+        length += bytesRead;
+    }
+
+    contents = std::string_view(buffer.data(), length);
+    return true;
+}
+
+static int8_t readAt(int32_t dirFd, const char* relPath, std::string_view& contents) {
+    int32_t fd = openat(dirFd, relPath, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        return false;
+    }
+
+    int8_t status = readFd(fd, contents);
+    int32_t savedErrno = errno;
+    close(fd);
+    errno = savedErrno;
+    return status;
+}
+
+int8_t AuxRoutines::readFileFast(const std::string& filePath, std::string_view& contents) {
+    static const std::string procPrefix = "/proc/";
+    static const std::string sysPrefix = "/sys/";
+
+    if(filePath.compare(0, procPrefix.length(), procPrefix) == 0 && getProcDirFd() >= 0) {
+        return readAt(getProcDirFd(), filePath.c_str() + procPrefix.length(), contents);
+    }
+    if(filePath.compare(0, sysPrefix.length(), sysPrefix) == 0 && getSysDirFd() >= 0) {
+        return readAt(getSysDirFd(), filePath.c_str() + sysPrefix.length(), contents);
+    }
+    return readAt(AT_FDCWD, filePath.c_str(), contents);
+}
+
+int8_t AuxRoutines::readProcFile(pid_t pid, const char* fileName, std::string_view& contents) {
+    char relPath[64];
+    int32_t len = snprintf(relPath, sizeof(relPath), "%d/%s", pid, fileName);
+    if(len < 0 || len >= (int32_t)sizeof(relPath)) {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+
+    if(getProcDirFd() >= 0) {
+        return readAt(getProcDirFd(), relPath, contents);
+    }
+    return readFileFast("/proc/" + std::string(relPath), contents);
+}
+
+std::string_view AuxRoutines::firstLine(std::string_view contents) {
+    size_t end = contents.find('\n');
+    return (end == std::string_view::npos) ? contents : contents.substr(0, end);
+}
+
+std::string_view AuxRoutines::trimView(std::string_view str) {
+    size_t first = str.find_first_not_of(" \t\n\r");
+    if(first == std::string_view::npos) {
+        return std::string_view();
+    }
+    size_t last = str.find_last_not_of(" \t\n\r");
+    return str.substr(first, (last - first + 1));
+}
+
+int8_t AuxRoutines::parseInt64(std::string_view str, int64_t& value) {
+    str = trimView(str);
+    if(str.empty()) {
+        return false;
+    }
+
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return result.ec == std::errc();
+}
+
+int8_t AuxRoutines::getStatField(std::string_view stat, int32_t fieldNumber, int64_t& value) {
+    if(fieldNumber == 1) {
+        return parseInt64(stat.substr(0, stat.find(' ')), value);
+    }
+
+    // Fields after comm start at 3, comm is enclosed in parentheses and may contain ')'.
+    size_t pos = stat.rfind(')');
+    if(fieldNumber < 3 || pos == std::string_view::npos) {
+        return false;
+    }
+    pos++;
+
+    for(int32_t field = 3; pos < stat.size(); field++) {
+        size_t start = stat.find_first_not_of(' ', pos);
+        if(start == std::string_view::npos) {
+            return false;
+        }
+        size_t end = stat.find(' ', start);
+        if(end == std::string_view::npos) {
+            end = stat.size();
+        }
+
+        if(field == fieldNumber) {
+            std::string_view token = stat.substr(start, end - start);
+            if(fieldNumber == 3) {
+                // State, a single character
+                value = token.empty() ? 0 : token[0];
+                return !token.empty();
+            }
+            return parseInt64(token, value);
+        }
+        pos = end;
+    }
+    return false;
+}
+
+int8_t AuxRoutines::getTaskStartTime(pid_t pid, pid_t tid, int64_t& startTime) {
+    std::string statFile = "task/" + std::to_string(tid) + "/stat";
+    std::string_view stat;
+    if(!readProcFile(pid, statFile.c_str(), stat)) {
+        return false;
+    }
+    return getStatField(stat, 22, startTime);
+}
+
+int8_t AuxRoutines::getStatusField(std::string_view status, std::string_view key, std::string_view& value) {
+    size_t pos = 0;
+    while(pos < status.size()) {
+        size_t end = status.find('\n', pos);
+        if(end == std::string_view::npos) {
+            end = status.size();
+        }
+
+        std::string_view line = status.substr(pos, end - pos);
+        if(line.size() > key.size() && line.compare(0, key.size(), key) == 0 && line[key.size()] == ':') {
+            value = trimView(line.substr(key.size() + 1));
+            return true;
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
 std::string AuxRoutines::readFromFile(const std::string& fileName) {
     if(fileName.length() == 0) return "";
 
-    std::ifstream fileStream(fileName, std::ios::in);
-    std::string value = "";
-
-    if(!fileStream.is_open()) {
-        LOGW("URM_AUX_ROUTINE", "Failed to open file: " + fileName + " Error: " + strerror(errno));
+    std::string_view contents;
+    if(!AuxRoutines::readFileFast(fileName, contents)) {
+        LOGW("URM_AUX_ROUTINE", "Failed to read from file: " + fileName + " Error: " + strerror(errno));
         return "";
     }
 
-    if(!getline(fileStream, value)) {
-        LOGW("URM_AUX_ROUTINE", "Failed to read from file: " + fileName + " Error: " + strerror(errno));
+    if(contents.empty()) {
+        LOGW("URM_AUX_ROUTINE", "Failed to read from file: " + fileName + " Error: empty file");
         return "";
     }
 
-    fileStream.close();
-    return value;
+    return std::string(AuxRoutines::firstLine(contents));
 }
 
 void AuxRoutines::writeToFile(const std::string& fileName, const std::string& value) {
@@ -44,43 +213,6 @@ void AuxRoutines::writeToFile(const std::string& fileName, const std::string& va
     fileStream.close();
 }
 
-void AuxRoutines::writeSysFsDefaults() {
-    // Write Defaults
-    std::ifstream file;
-
-    file.open(UrmSettings::mPersistenceFile);
-    if(!file.is_open()) {
-        LOGE("RESTUNE_SERVER_INIT",
-             "Failed to open sysfs original values file: " + UrmSettings::mPersistenceFile);
-        return;
-    }
-
-    std::string line;
-    while(std::getline(file, line)) {
-        std::stringstream lineStream(line);
-        std::string token;
-
-        int8_t index = 0;
-        std::string sysfsNodePath = "";
-        int32_t sysfsNodeDefaultValue = -1;
-
-        while(std::getline(lineStream, token, ',')) {
-            if(index == 0) {
-                sysfsNodePath = token;
-            } else if(index == 1) {
-                try {
-                    sysfsNodeDefaultValue = std::stoi(token);
-                } catch(const std::exception& e) {}
-            }
-            index++;
-        }
-
-        if(sysfsNodePath.length() > 0 && sysfsNodeDefaultValue != -1) {
-            AuxRoutines::writeToFile(sysfsNodePath, std::to_string(sysfsNodeDefaultValue));
-        }
-    }
-}
-
 void AuxRoutines::deleteFile(const std::string& fileName) {
     remove(fileName.c_str());
 }
@@ -111,18 +243,14 @@ pid_t AuxRoutines::fetchPid(const std::string& process_name) {
     }
 
     struct dirent* entry;
+    std::string_view comm;
     while ((entry = readdir(proc_dir)) != nullptr) {
         if (entry->d_type == DT_DIR && isNumericString(entry->d_name)) {
-            std::string pid_str = entry->d_name;
-            std::string comm_path = COMM_S(pid_str);
-            std::ifstream comm_file(comm_path);
-            std::string comm;
-            if (comm_file) {
-                std::getline(comm_file, comm);
-                if (comm.find(process_name) != std::string::npos) {
-                    closedir(proc_dir);
-                    return static_cast<pid_t>(std::stoi(pid_str));
-                }
+            pid_t pid = static_cast<pid_t>(std::strtol(entry->d_name, nullptr, 10));
+            if (readProcFile(pid, "comm", comm) &&
+                firstLine(comm).find(process_name) != std::string_view::npos) {
+                closedir(proc_dir);
+                return pid;
             }
         }
     }
@@ -132,42 +260,28 @@ pid_t AuxRoutines::fetchPid(const std::string& process_name) {
 }
 
 int8_t AuxRoutines::getProcName(pid_t pid, std::string& procName) {
-    std::string cmdlinePath = "/proc/" + std::to_string(pid) + "/cmdline";
-    std::ifstream cmdlineFile(cmdlinePath);
-    
-    if(cmdlineFile.is_open()) {
-        std::string cmdline;
-        std::getline(cmdlineFile, cmdline, '\0');
-        
+    std::string_view contents;
+
+    if(readProcFile(pid, "cmdline", contents)) {
+        // argv[0]
+        std::string_view cmdline = contents.substr(0, contents.find('\0'));
+
         if(!cmdline.empty()) {
             size_t lastSlash = cmdline.find_last_of('/');
-            if(lastSlash != std::string::npos) {
-                procName = cmdline.substr(lastSlash + 1);
-            } else {
-                procName = cmdline;
-            }
-            
-            size_t first = procName.find_first_not_of(" \t\n\r");
-            if(first != std::string::npos) {
-                size_t last = procName.find_last_not_of(" \t\n\r");
-                procName = procName.substr(first, (last - first + 1));
+            if(lastSlash != std::string_view::npos) {
+                cmdline = cmdline.substr(lastSlash + 1);
             }
-            
+
+            std::string_view trimmed = trimView(cmdline);
+            procName = std::string(trimmed.empty() ? cmdline : trimmed);
             return true;
         }
     }
 
-    std::string commPath = "/proc/" + std::to_string(pid) + "/comm";
-    std::ifstream commFile(commPath);
-    
-    if(commFile.is_open()) {
-        std::string processName;
-        std::getline(commFile, processName);
-
-        size_t first = processName.find_first_not_of(" \t\n\r");
-        if(first != std::string::npos) {
-            size_t last = processName.find_last_not_of(" \t\n\r");
-            procName = processName.substr(first, (last - first + 1));
+    if(readProcFile(pid, "comm", contents)) {
+        std::string_view processName = trimView(firstLine(contents));
+        if(!processName.empty()) {
+            procName = std::string(processName);
             return true;
         }
     }
@@ -176,22 +290,12 @@ int8_t AuxRoutines::getProcName(pid_t pid, std::string& procName) {
 }
 
 int32_t AuxRoutines::fetchComm(pid_t pid, std::string &comm) {
-    std::string proc_path = "/proc/" + std::to_string(pid);
-    if(!AuxRoutines::fileExists(proc_path)) {
+    std::string_view contents;
+    if(!readProcFile(pid, "comm", contents)) {
         return -1;
     }
 
-    std::string comm_path = COMM(pid);
-    std::ifstream comm_file(comm_path);
-    if (comm_file.is_open()) {
-        std::getline(comm_file, comm);
-        // Trim
-        size_t first = comm.find_first_not_of(" \t\n\r");
-        if (first != std::string::npos) {
-            size_t last = comm.find_last_not_of(" \t\n\r");
-            comm = comm.substr(first, (last - first + 1));
-        }
-    }
+    comm = std::string(trimView(firstLine(contents)));
     return 0;
 }
 
@@ -249,10 +353,11 @@ int8_t FlatBuffEncoder::isBufSane() {
     return true;
 }
 
+static int64_t handleGenerator = 0;
+
 int64_t AuxRoutines::generateUniqueHandle() {
     const std::lock_guard<std::mutex> lock(handleGenLock);
 
-    static int64_t handleGenerator = 0;
     OperationStatus opStatus;
     int64_t nextHandle = Add(handleGenerator, (int64_t)1, opStatus);
     if(opStatus == SUCCESS) {
@@ -263,11 +368,22 @@ int64_t AuxRoutines::generateUniqueHandle() {
     return -1;
 }
 
+void AuxRoutines::reserveHandle(int64_t handle) {
+    const std::lock_guard<std::mutex> lock(handleGenLock);
+    handleGenerator = std::max(handleGenerator, handle);
+}
+
 int64_t AuxRoutines::getCurrentTimeInMilliseconds() {
     auto now = std::chrono::system_clock::now();
     return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
 }
 
+// Not affected by wall-clock adjustments, use for measuring intervals.
+int64_t AuxRoutines::getMonotonicTimeInMilliseconds() {
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+}
+
 MinLRUCache::MinLRUCache(int32_t maxSize) {
     this->mMaxSize = maxSize;
     this->mDataSet.reserve(this->mMaxSize);
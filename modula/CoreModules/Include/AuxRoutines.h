@@ -10,6 +10,7 @@
 #include <string>
 #include <cstring>
 #include <sstream>
+#include <string_view>
 #include <fstream>
 #include <unistd.h>
 #include <getopt.h>
@@ -30,7 +31,6 @@ public:
     static std::string readFromFile(const std::string& fileName);
     static void writeToFile(const std::string& fileName, const std::string& value);
     static void deleteFile(const std::string& fileName);
-    static void writeSysFsDefaults();
     static int8_t fileExists(const std::string& filePath);
     static int8_t fileWritable(const std::string& filePath);
     static std::string getMachineName();
@@ -40,8 +40,39 @@ public:
     static int32_t fetchComm(pid_t pid, std::string &comm);
     static int8_t getProcName(pid_t pid, std::string& procName);
 
+    /**
+     * @brief Fast readers for /proc and sysfs files.
+     * @details Files under /proc and /sys are opened relative to directory fds which are opened
+     *          once (openat), and read straight into a per-thread buffer which is reused across
+     *          calls, i.e. no allocations are made once the buffer has grown to fit.\n
+     *          contents is a view into that buffer, it stays valid only until the next read
+     *          on the same thread, copy out whatever needs to be kept.
+     * @return int8_t:\n
+     *            - true: If the file was read (possibly empty)\n
+     *            - false: Otherwise, errno is left set
+     */
+    static int8_t readFileFast(const std::string& filePath, std::string_view& contents);
+    // Reads /proc/<pid>/<fileName>
+    static int8_t readProcFile(pid_t pid, const char* fileName, std::string_view& contents);
+
+    // Allocation-free field parsing, for the contents returned by the readers above.
+    static std::string_view firstLine(std::string_view contents);
+    static std::string_view trimView(std::string_view str);
+    static int8_t parseInt64(std::string_view str, int64_t& value);
+    // Field of /proc/<pid>/stat, numbered as in proc(5), i.e. pid is 1 and state is 3.
+    // The comm field (2) may contain spaces, hence it can't be fetched via this routine.
+    static int8_t getStatField(std::string_view stat, int32_t fieldNumber, int64_t& value);
+    // Value (after the "<key>:" prefix) of a line in /proc/<pid>/status.
+    static int8_t getStatusField(std::string_view status, std::string_view key, std::string_view& value);
+    // Start time (field 22 of /proc/<pid>/task/<tid>/stat, in clock ticks since boot), which
+    // together with the tid identifies a thread across pid reuse.
+    static int8_t getTaskStartTime(pid_t pid, pid_t tid, int64_t& startTime);
+
     static int64_t generateUniqueHandle();
+    // Ensure that handles up to (and including) the given one are never generated.
+    static void reserveHandle(int64_t handle);
     static int64_t getCurrentTimeInMilliseconds();
+    static int64_t getMonotonicTimeInMilliseconds();
     static std::string toLowerCase(const std::string& str);
 };
 
@@ -76,7 +76,14 @@ public:
     static const std::string focusedCgroup;
     static const std::string mDeviceNamePath;
     static const std::string mBaseCGroupPath;
+    // Persistent state (caches), created by systemd (StateDirectory) or at init.
+    static const std::string mStateDir;
+    // State which must not outlive a reboot (the original node values are only valid
+    // for the current boot), created by systemd (RuntimeDirectory) or at init.
+    static const std::string mRuntimeDir;
     static const std::string mPersistenceFile;
+    static const std::string mRequestJournalPath;
+    static const std::string mConfigSnapshotPath;
 
     // Target Information Stores
     static MetaConfigs metaConfigs;
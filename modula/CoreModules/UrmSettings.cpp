@@ -59,8 +59,16 @@ const std::string UrmSettings::mBaseCGroupPath =
 const std::string UrmSettings::focusedCgroup =
                                     "urm.slice/focused.apps";
 
+const std::string UrmSettings::mStateDir =
+                                    "/var/lib/urm";
+const std::string UrmSettings::mRuntimeDir =
+                                    "/run/urm";
 const std::string UrmSettings::mPersistenceFile =
-                                    "/etc/urm/data/resource_original_values.txt";
+                                    "/run/urm/resource_original_values.journal";
+const std::string UrmSettings::mRequestJournalPath =
+                                    "/run/urm_active_requests.journal";
+const std::string UrmSettings::mConfigSnapshotPath =
+                                    "/var/lib/urm/config_snapshot.bin";
 
 int32_t UrmSettings::isServerOnline() {
     return serverOnlineStatus;
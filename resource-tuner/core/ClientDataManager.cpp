@@ -1,31 +1,45 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <cmath>
+
+#include "AuxRoutines.h"
 #include "ClientDataManager.h"
 
-static int8_t isRootProcess(pid_t pid) {
-    std::string statusFile = "/proc/" + std::to_string(pid) + "/status";
-    std::ifstream file(statusFile);
-    std::string line;
+static int32_t openPidFd(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return (int32_t)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
 
-    if(!file.is_open()) {
-        LOGE("RESTUNE_CLIENT_DATA_MANAGER", "Failed to open file: " + statusFile + ", Error: " + strerror(errno));
+static int8_t isRootProcess(pid_t pid) {
+    std::string_view status;
+    if(!AuxRoutines::readProcFile(pid, "status", status)) {
+        LOGE("RESTUNE_CLIENT_DATA_MANAGER",
+             "Failed to read file: /proc/" + std::to_string(pid) + "/status, Error: " + strerror(errno));
         return -1;
     }
 
-    while(std::getline(file, line)) {
-        if(line.rfind("Uid:", 0) == 0) {
-            // Format: Uid: real effective saved fs
-            std::istringstream iss(line);
-            std::string label;
-            int32_t real, effective, saved, fs;
-            iss >> label >> real >> effective >> saved >> fs;
-
-            if(effective == 0) {
-                return PERMISSION_SYSTEM;
-            } else {
-                return PERMISSION_THIRD_PARTY;
-            }
+    // Format: Uid: real effective saved fs
+    std::string_view uids;
+    if(AuxRoutines::getStatusField(status, "Uid", uids)) {
+        size_t start = uids.find_first_of(" \t");
+        int64_t effective = -1;
+        if(start != std::string_view::npos) {
+            std::string_view rest = AuxRoutines::trimView(uids.substr(start));
+            AuxRoutines::parseInt64(rest.substr(0, rest.find_first_of(" \t")), effective);
+        }
+
+        if(effective == 0) {
+            return PERMISSION_SYSTEM;
+        } else {
+            return PERMISSION_THIRD_PARTY;
         }
     }
     return PERMISSION_THIRD_PARTY;
@@ -33,71 +47,131 @@ static int8_t isRootProcess(pid_t pid) {
 
 std::mutex ClientDataManager::instanceProtectionLock {};
 std::shared_ptr<ClientDataManager> ClientDataManager::mClientDataManagerInstance = nullptr;
-ClientDataManager::ClientDataManager() {}
+ClientDataManager::ClientDataManager() {
+    this->mPidFdSupported = false;
+    this->mLivenessEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    if(this->mLivenessEpollFd < 0) {
+        TYPELOGV(ERRNO_LOG, "epoll_create1", strerror(errno));
+        return;
+    }
+
+    // Probe for pidfd support, using our own PID.
+    int32_t probeFd = openPidFd(getpid());
+    if(probeFd >= 0) {
+        this->mPidFdSupported = true;
+        close(probeFd);
+    } else {
+        LOGI("RESTUNE_CLIENT_DATA_MANAGER",
+             "pidfd not supported, client liveness will be polled. Error: " + std::string(strerror(errno)));
+    }
+}
+
+void ClientDataManager::watchClient(pid_t clientPID, ClientInfo* clientInfo) {
+    if(!this->mPidFdSupported) return;
+
+    int32_t pidFd = openPidFd(clientPID);
+    if(pidFd < 0) {
+        // Client will be covered by the periodic /proc scan instead.
+        TYPELOGV(ERRNO_LOG, "pidfd_open", strerror(errno));
+        return;
+    }
+
+    // One-shot: a terminated client is reported only once, even if its
+    // cleanup is deferred.
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u32 = (uint32_t)clientPID;
+
+    if(epoll_ctl(this->mLivenessEpollFd, EPOLL_CTL_ADD, pidFd, &event) < 0) {
+        TYPELOGV(ERRNO_LOG, "epoll_ctl", strerror(errno));
+        close(pidFd);
+        return;
+    }
+
+    clientInfo->mPidFd = pidFd;
+}
+
+void ClientDataManager::unwatchClient(ClientInfo* clientInfo) {
+    if(clientInfo->mPidFd < 0) return;
+
+    // Closing the fd also drops it from the epoll set, remove it explicitly
+    // regardless to avoid any stale events.
+    epoll_ctl(this->mLivenessEpollFd, EPOLL_CTL_DEL, clientInfo->mPidFd, nullptr);
+    close(clientInfo->mPidFd);
+    clientInfo->mPidFd = -1;
+}
 
 int8_t ClientDataManager::clientExists(pid_t clientPID, pid_t clientTID) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientShard& clientShard = this->getClientShard(clientPID);
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+
+    // Check that an entry corresponding to the client PID exists in the PID table, and
+    // An entry for the client TID exists in the TID table.
+    clientShard.mShardMutex.lock_shared();
+    int8_t clientCheck = (clientShard.mClientRepo.find(clientPID) != clientShard.mClientRepo.end());
+    clientShard.mShardMutex.unlock_shared();
 
-    // Check that an entry corresponding to the client PID exists in the mClientRepo table, and
-    // An entry for the client TID exists in the mClientTidRepo table.
-    int8_t clientCheck = (this->mClientRepo.find(clientPID) != this->mClientRepo.end()) &&
-                         (this->mClientTidRepo.find(clientTID) != this->mClientTidRepo.end());
+    if(!clientCheck) {
+        return false;
+    }
+
+    clientTidShard.mShardMutex.lock_shared();
+    clientCheck = (clientTidShard.mClientTidRepo.find(clientTID) != clientTidShard.mClientTidRepo.end());
+    clientTidShard.mShardMutex.unlock_shared();
 
-    this->mGlobalTableMutex.unlock_shared();
     return clientCheck;
 }
 
 int8_t ClientDataManager::createNewClient(pid_t clientPID, pid_t clientTID) {
-    this->mGlobalTableMutex.lock();
-    // First create an entry in the mClientTidRepo table
+    ClientShard& clientShard = this->getClientShard(clientPID);
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
 
-    int8_t clientCheck = (this->mClientRepo.find(clientPID) != this->mClientRepo.end()) &&
-                         (this->mClientTidRepo.find(clientTID) != this->mClientTidRepo.end());
+    // Lock Order: PID shard, followed by the TID shard.
+    std::unique_lock<std::shared_timed_mutex> clientLock(clientShard.mShardMutex);
+    std::unique_lock<std::shared_timed_mutex> clientTidLock(clientTidShard.mShardMutex);
 
-    if(clientCheck) {
+    // First create an entry in the TID table
+    int8_t clientPIDExists = (clientShard.mClientRepo.find(clientPID) != clientShard.mClientRepo.end());
+    int8_t clientTIDExists =
+        (clientTidShard.mClientTidRepo.find(clientTID) != clientTidShard.mClientTidRepo.end());
+
+    if(clientPIDExists && clientTIDExists) {
         // Edge Case, control should not reach here since it is expected that createNewClient
         // Routine is used in conjunction with the clientExists Routine
-        this->mGlobalTableMutex.unlock();
         return true;
     }
 
     ClientTidData* clientData = nullptr;
     try {
         clientData = MPLACED(ClientTidData);
-        clientData->mLastRequestTimestamp = 0;
-        clientData->mHealth = 100.0;
+        clientData->mRateLimitState.store(PACK_RATE_LIMIT_STATE(0, RATE_LIMIT_MAX_TOKENS));
         clientData->mClientHandles = MPLACED(std::unordered_set<int64_t>);
 
     } catch(const std::bad_alloc& e) {
         TYPELOGV(CLIENT_ALLOCATION_FAILURE, clientPID, clientTID, e.what());
-
-        this->mGlobalTableMutex.unlock();
         return false;
 
     } catch(const std::exception& e) {
         TYPELOGV(CLIENT_ALLOCATION_FAILURE, clientPID, clientTID, e.what());
-
-        this->mGlobalTableMutex.unlock();
         return false;
     }
 
-    // Check if a client PID entry exists
-    int8_t clientPIDExists = (this->mClientRepo.find(clientPID) != this->mClientRepo.end());
-    this->mClientTidRepo[clientTID] = clientData;
+    clientTidShard.mClientTidRepo[clientTID] = clientData;
 
     if(clientPIDExists) {
         // If it does, then add the client TID to the list of TIDs for that client PID
-        int32_t curTIDCount = this->mClientRepo[clientPID]->mCurClientThreads;
+        ClientInfo* clientInfo = clientShard.mClientRepo[clientPID];
+        int32_t curTIDCount = clientInfo->mCurClientThreads;
         if(curTIDCount < PER_CLIENT_TID_CAP) {
-            this->mClientRepo[clientPID]->mClientTIDs[curTIDCount] = clientTID;
+            clientInfo->mClientTIDs[curTIDCount] = clientTID;
             curTIDCount++;
-            this->mClientRepo[clientPID]->mCurClientThreads = curTIDCount;
+            clientInfo->mCurClientThreads = curTIDCount;
         } else {
-            this->mGlobalTableMutex.unlock();
             return false;
         }
     } else {
-        // If it doesn't, then create a new entry in the mClientRepo table
+        // If it doesn't, then create a new entry in the PID table
         try {
             ClientInfo* clientInfo = MPLACED(ClientInfo);
 
@@ -107,184 +181,301 @@ int8_t ClientDataManager::createNewClient(pid_t clientPID, pid_t clientTID) {
             clientInfo->mCurClientThreads = curTIDCount;
 
             clientInfo->mClientType = isRootProcess(clientPID);
-            this->mClientRepo[clientPID] = clientInfo;
+            this->watchClient(clientPID, clientInfo);
+            clientShard.mClientRepo[clientPID] = clientInfo;
 
         } catch(const std::bad_alloc& e) {
             TYPELOGV(CLIENT_ALLOCATION_FAILURE, clientPID, clientTID, e.what());
-
-            this->mGlobalTableMutex.unlock();
             return false;
 
         } catch(const std::exception& e) {
             TYPELOGV(CLIENT_ALLOCATION_FAILURE, clientPID, clientTID, e.what());
-
-            this->mGlobalTableMutex.unlock();
             return false;
         }
     }
 
-    this->mGlobalTableMutex.unlock();
     return true;
 }
 
 std::unordered_set<int64_t>* ClientDataManager::getRequestsByClientID(pid_t clientTID) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    clientTidShard.mShardMutex.lock_shared();
 
-    if(this->mClientTidRepo[clientTID] == nullptr || this->mClientTidRepo.size() == 0) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end() || it->second == nullptr) {
+        clientTidShard.mShardMutex.unlock_shared();
         return nullptr;
     }
 
-    std::unordered_set<int64_t>* clientHandlesPtr = this->mClientTidRepo[clientTID]->mClientHandles;
-    this->mGlobalTableMutex.unlock_shared();
+    std::unordered_set<int64_t>* clientHandlesPtr = it->second->mClientHandles;
+    clientTidShard.mShardMutex.unlock_shared();
 
     return clientHandlesPtr;
 }
 
+// Note: Handle insertions and deletions are already serialized by the RequestManager's map lock.
 void ClientDataManager::insertRequestByClientId(pid_t clientTID, int64_t requestHandle) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    clientTidShard.mShardMutex.lock_shared();
 
-    if(this->mClientTidRepo[clientTID] == nullptr || this->mClientTidRepo.size() == 0) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end() || it->second == nullptr) {
+        clientTidShard.mShardMutex.unlock_shared();
         return;
     }
 
-    this->mClientTidRepo[clientTID]->mClientHandles->insert(requestHandle);
-    this->mGlobalTableMutex.unlock_shared();
+    it->second->mClientHandles->insert(requestHandle);
+    clientTidShard.mShardMutex.unlock_shared();
 }
 
 void ClientDataManager::deleteRequestByClientId(pid_t clientTID, int64_t requestHandle) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    clientTidShard.mShardMutex.lock_shared();
 
-    if(this->mClientTidRepo.find(clientTID) == this->mClientTidRepo.end()) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end()) {
+        clientTidShard.mShardMutex.unlock_shared();
         return;
     }
 
-    this->mClientTidRepo[clientTID]->mClientHandles->erase(requestHandle);
-    this->mGlobalTableMutex.unlock_shared();
+    it->second->mClientHandles->erase(requestHandle);
+    clientTidShard.mShardMutex.unlock_shared();
 }
 
 int8_t ClientDataManager::getClientLevelByID(pid_t clientPID) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientShard& clientShard = this->getClientShard(clientPID);
+    clientShard.mShardMutex.lock_shared();
 
-    if(this->mClientRepo.find(clientPID) == this->mClientRepo.end()) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientShard.mClientRepo.find(clientPID);
+    if(it == clientShard.mClientRepo.end()) {
+        clientShard.mShardMutex.unlock_shared();
         return -1;
     }
 
-    int8_t clientLevel = this->mClientRepo[clientPID]->mClientType;
-    this->mGlobalTableMutex.unlock_shared();
+    int8_t clientLevel = it->second->mClientType;
+    clientShard.mShardMutex.unlock_shared();
 
     return clientLevel;
 }
 
 void ClientDataManager::getThreadsByClientId(pid_t clientPID, std::vector<pid_t>& threadIDs) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientShard& clientShard = this->getClientShard(clientPID);
+    clientShard.mShardMutex.lock_shared();
 
-    if(this->mClientRepo.find(clientPID) == this->mClientRepo.end()) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientShard.mClientRepo.find(clientPID);
+    if(it == clientShard.mClientRepo.end()) {
+        clientShard.mShardMutex.unlock_shared();
         return;
     }
 
-    for(int32_t i = 0; i < this->mClientRepo[clientPID]->mCurClientThreads; i++) {
-        threadIDs.push_back(this->mClientRepo[clientPID]->mClientTIDs[i]);
+    for(int32_t i = 0; i < it->second->mCurClientThreads; i++) {
+        threadIDs.push_back(it->second->mClientTIDs[i]);
+    }
+
+    clientShard.mShardMutex.unlock_shared();
+}
+
+// The Health and Timestamp accessors only need the shared shard lock, to keep the entry alive.
+// Both are stored in the packed token bucket, and are updated via CAS so that a concurrent
+// admission by the RateLimiter is never lost.
+static void setRateLimitFields(std::atomic<uint64_t>& rateLimitState,
+                               int64_t timestamp,
+                               int64_t tokens) {
+    uint64_t state = rateLimitState.load();
+    uint64_t newState;
+    do {
+        int64_t newTimestamp = (timestamp >= 0) ? timestamp : RATE_LIMIT_STATE_TIMESTAMP(state);
+        int64_t newTokens = (tokens >= 0) ? tokens : RATE_LIMIT_STATE_TOKENS(state);
+        newState = PACK_RATE_LIMIT_STATE(newTimestamp, std::min(newTokens, (int64_t)RATE_LIMIT_TOKEN_MASK));
+    } while(!rateLimitState.compare_exchange_weak(state, newState));
+}
+
+int8_t ClientDataManager::updateRateLimitState(pid_t clientTID,
+                                               const std::function<uint64_t(uint64_t)>& update) {
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    // The shared lock keeps the entry alive (deleteClientTID needs the exclusive lock),
+    // while still allowing concurrent admissions for the clients in this shard.
+    clientTidShard.mShardMutex.lock_shared();
+
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end()) {
+        clientTidShard.mShardMutex.unlock_shared();
+        return false;
     }
 
-    this->mGlobalTableMutex.unlock_shared();
+    std::atomic<uint64_t>& rateLimitState = it->second->mRateLimitState;
+    uint64_t state = rateLimitState.load(std::memory_order_acquire);
+    uint64_t newState;
+    do {
+        newState = update(state);
+    } while(!rateLimitState.compare_exchange_weak(state, newState,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire));
+
+    clientTidShard.mShardMutex.unlock_shared();
+    return true;
 }
 
 double ClientDataManager::getHealthByClientID(pid_t clientTID) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    clientTidShard.mShardMutex.lock_shared();
 
-    if(this->mClientTidRepo.find(clientTID) == this->mClientTidRepo.end()) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end()) {
+        clientTidShard.mShardMutex.unlock_shared();
         return -1;
     }
 
-    double health = this->mClientTidRepo[clientTID]->mHealth;
-    this->mGlobalTableMutex.unlock_shared();
+    uint64_t state = it->second->mRateLimitState.load();
+    clientTidShard.mShardMutex.unlock_shared();
 
-    return health;
+    return RATE_LIMIT_STATE_TOKENS(state) / RATE_LIMIT_TOKEN_SCALE;
 }
 
 int64_t ClientDataManager::getLastRequestTimestampByClientID(pid_t clientTID) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    clientTidShard.mShardMutex.lock_shared();
 
-    if(this->mClientTidRepo.find(clientTID) == this->mClientTidRepo.end()) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end()) {
+        clientTidShard.mShardMutex.unlock_shared();
         return 0;
     }
 
-    int64_t lastRequestTimestamp = this->mClientTidRepo[clientTID]->mLastRequestTimestamp;
-    this->mGlobalTableMutex.unlock_shared();
+    uint64_t state = it->second->mRateLimitState.load();
+    clientTidShard.mShardMutex.unlock_shared();
 
-    return lastRequestTimestamp;
+    return RATE_LIMIT_STATE_TIMESTAMP(state);
 }
 
 void ClientDataManager::updateHealthByClientID(int32_t clientTID, double health) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    clientTidShard.mShardMutex.lock_shared();
 
-    if(this->mClientTidRepo.find(clientTID) == this->mClientTidRepo.end()) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end()) {
+        clientTidShard.mShardMutex.unlock_shared();
         return;
     }
 
-    this->mClientTidRepo[clientTID]->mHealth = health;
-    this->mGlobalTableMutex.unlock_shared();
+    int64_t tokens = std::llround(std::max(0.0, health) * RATE_LIMIT_TOKEN_SCALE);
+    setRateLimitFields(it->second->mRateLimitState, -1, tokens);
+    clientTidShard.mShardMutex.unlock_shared();
 }
 
 void ClientDataManager::updateLastRequestTimestampByClientID(int32_t clientTID, int64_t currentMillis) {
-    this->mGlobalTableMutex.lock_shared();
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    clientTidShard.mShardMutex.lock_shared();
 
-    if(this->mClientTidRepo.find(clientTID) == this->mClientTidRepo.end()) {
-        this->mGlobalTableMutex.unlock_shared();
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end()) {
+        clientTidShard.mShardMutex.unlock_shared();
         return;
     }
 
-    this->mClientTidRepo[clientTID]->mLastRequestTimestamp = currentMillis;
-    this->mGlobalTableMutex.unlock_shared();
+    setRateLimitFields(it->second->mRateLimitState, std::max((int64_t)0, currentMillis), -1);
+    clientTidShard.mShardMutex.unlock_shared();
 }
 
 void ClientDataManager::getActiveClientList(std::vector<int32_t>& clientList) {
-    this->mGlobalTableMutex.lock_shared();
+    for(int32_t i = 0; i < CLIENT_TABLE_SHARDS; i++) {
+        ClientShard& clientShard = this->mClientShards[i];
+        clientShard.mShardMutex.lock_shared();
+
+        for(std::pair<pid_t, ClientInfo*> clientInfo : clientShard.mClientRepo) {
+            clientList.push_back(clientInfo.first);
+        }
+
+        clientShard.mShardMutex.unlock_shared();
+    }
+}
+
+void ClientDataManager::getUnwatchedClientList(std::vector<pid_t>& clientList) {
+    for(int32_t i = 0; i < CLIENT_TABLE_SHARDS; i++) {
+        ClientShard& clientShard = this->mClientShards[i];
+        clientShard.mShardMutex.lock_shared();
+
+        for(std::pair<pid_t, ClientInfo*> clientInfo : clientShard.mClientRepo) {
+            if(clientInfo.second->mPidFd < 0) {
+                clientList.push_back(clientInfo.first);
+            }
+        }
+
+        clientShard.mShardMutex.unlock_shared();
+    }
+}
+
+int8_t ClientDataManager::isLivenessTrackingSupported() {
+    return this->mPidFdSupported;
+}
+
+int32_t ClientDataManager::waitForClientExits(std::vector<pid_t>& deadClients, int32_t timeoutMs) {
+    if(!this->mPidFdSupported) return -1;
+
+    const int32_t maxEvents = 16;
+    struct epoll_event events[maxEvents];
 
-    for(std::pair<pid_t, ClientInfo*> clientInfo : this->mClientRepo) {
-        clientList.push_back(clientInfo.first);
+    int32_t eventCount = epoll_wait(this->mLivenessEpollFd, events, maxEvents, timeoutMs);
+    if(eventCount < 0) {
+        if(errno == EINTR) return 0;
+        TYPELOGV(ERRNO_LOG, "epoll_wait", strerror(errno));
+        return -1;
+    }
+
+    for(int32_t i = 0; i < eventCount; i++) {
+        deadClients.push_back((pid_t)events[i].data.u32);
     }
 
-    this->mGlobalTableMutex.unlock_shared();
+    return eventCount;
 }
 
 void ClientDataManager::deleteClientPID(pid_t clientPID) {
-    this->mGlobalTableMutex.lock();
+    ClientShard& clientShard = this->getClientShard(clientPID);
+    clientShard.mShardMutex.lock();
 
-    if(this->mClientRepo.find(clientPID) == this->mClientRepo.end()) {
-        this->mGlobalTableMutex.unlock();
+    auto it = clientShard.mClientRepo.find(clientPID);
+    if(it == clientShard.mClientRepo.end()) {
+        clientShard.mShardMutex.unlock();
         return;
     }
 
-    ClientInfo* clientInfo = this->mClientRepo[clientPID];
+    ClientInfo* clientInfo = it->second;
+    this->unwatchClient(clientInfo);
     FreeBlock<ClientInfo>(static_cast<void*>(clientInfo));
 
-    this->mClientRepo.erase(clientPID);
-    this->mGlobalTableMutex.unlock();
+    clientShard.mClientRepo.erase(it);
+    clientShard.mShardMutex.unlock();
 }
 
 void ClientDataManager::deleteClientTID(pid_t clientTID) {
-    this->mGlobalTableMutex.lock();
+    ClientTidShard& clientTidShard = this->getClientTidShard(clientTID);
+    clientTidShard.mShardMutex.lock();
 
-    if(this->mClientTidRepo.find(clientTID) == this->mClientTidRepo.end()) {
-        this->mGlobalTableMutex.unlock();
+    auto it = clientTidShard.mClientTidRepo.find(clientTID);
+    if(it == clientTidShard.mClientTidRepo.end()) {
+        clientTidShard.mShardMutex.unlock();
         return;
     }
 
-    ClientTidData* clientData = this->mClientTidRepo[clientTID];
-    this->mClientTidRepo.erase(clientTID);
+    ClientTidData* clientData = it->second;
+    clientTidShard.mClientTidRepo.erase(it);
 
     FreeBlock<std::unordered_set<int64_t>>
             (static_cast<void*>(clientData->mClientHandles));
     FreeBlock<ClientTidData>(static_cast<void*>(clientData));
 
-    this->mGlobalTableMutex.unlock();
+    clientTidShard.mShardMutex.unlock();
+}
+
+ClientDataManager::~ClientDataManager() {
+    for(int32_t i = 0; i < CLIENT_TABLE_SHARDS; i++) {
+        for(std::pair<pid_t, ClientInfo*> clientInfo : this->mClientShards[i].mClientRepo) {
+            this->unwatchClient(clientInfo.second);
+        }
+    }
+
+    if(this->mLivenessEpollFd >= 0) {
+        close(this->mLivenessEpollFd);
+        this->mLivenessEpollFd = -1;
+    }
 }
@@ -38,38 +38,38 @@ void ClientGarbageCollector::performCleanup() {
             continue;
         }
 
-        // Issue Untune Requests, to remove the corresponding Tune Requests from the CocoTable
-        // Delete this Request from RequestManager's activeList and tracker.
-        std::vector<int64_t> handlesToRemove;
-        for(int64_t handle: *clientHandles) {
-            handlesToRemove.push_back(handle);
+        if(clientHandles->size() == 0) {
+            ClientDataManager::getInstance()->deleteClientTID(clientTID);
+            continue;
         }
 
-        ClientDataManager::getInstance()->deleteClientTID(clientTID);
-
-        for(int64_t handle: handlesToRemove) {
-            RequestInfo reqInfo = RequestManager::getInstance()->getRequestFromMap(handle);
-            Request* request = reqInfo.first;
-            if(request == nullptr) continue;
+        // Issue a single Teardown Request for this client thread, instead of one Untune
+        // Request per handle. This removes all the corresponding Tune Requests from the
+        // CocoTable and RequestManager in one pass. The client's handles are looked up
+        // while processing it, hence the client entry is deleted only after that.
+        Request* teardownRequest = nullptr;
 
-            Request* untuneRequest = nullptr;
+        try {
+            teardownRequest = MPLACED(Request);
 
-            try {
-                untuneRequest = MPLACED(Request);
-                request->populateUntuneRequest(untuneRequest);
-
-            } catch(const std::bad_alloc& e) {
-                LOGI("RESTUNE_CLIENT_GARBAGE_COLLECTOR",
-                     "Failed to Allocate Memory for Untune Request. Error: " + std::string(e.what()));
-            }
+        } catch(const std::bad_alloc& e) {
+            LOGI("RESTUNE_CLIENT_GARBAGE_COLLECTOR",
+                 "Failed to Allocate Memory for Teardown Request. Error: " + std::string(e.what()));
+        }
 
-            // Keep the Untune Request's Priority as: "high"
-            // So that most of (if not all) the existing Requests are untuned before
-            // more new Requests are Added.
-            if(untuneRequest != nullptr) {
-                untuneRequest->setPriority(REQ_PRIORITY_HIGH);
-                RequestQueue::getInstance()->addAndWakeup(untuneRequest);
-            }
+        // Keep the Teardown Request's Priority as: "high"
+        // So that the existing Requests are untuned before more new Requests are Added.
+        if(teardownRequest != nullptr) {
+            teardownRequest->setRequestType(REQ_CLIENT_TEARDOWN);
+            teardownRequest->setHandle(-1);
+            teardownRequest->setDuration(-1);
+            teardownRequest->setProperties(0);
+            teardownRequest->setClientPID(-1);
+            teardownRequest->setClientTID(clientTID);
+            teardownRequest->setPriority(REQ_PRIORITY_HIGH);
+            RequestQueue::getInstance()->addAndWakeup(teardownRequest);
+        } else {
+            ClientDataManager::getInstance()->deleteClientTID(clientTID);
         }
     }
 }
@@ -153,6 +153,7 @@ void CocoTable::applyAction(ResIterable* currNode, int32_t index, int8_t priorit
             // Note for resources with multiple values, the BU will need to provide a custom applier, which provides
             // the aggregation / selection logic.
             if(resourceConfig->mResourceApplierCallback != nullptr) {
+                this->mResourceRegistry->captureDefaults(resource->getResCode());
                 resourceConfig->mResourceApplierCallback(resource);
             }
             this->mCurrentlyAppliedPriority[index] = priority;
@@ -169,6 +170,7 @@ void CocoTable::fastPathApply(Resource* resource) {
         // Note for resources with multiple values, the BU will need to provide a custom applier, which provides
         // the aggregation / selection logic.
         if(rConf->mResourceApplierCallback != nullptr) {
+            this->mResourceRegistry->captureDefaults(resource->getResCode());
             rConf->mResourceApplierCallback(resource);
         }
     }
@@ -508,6 +510,128 @@ int8_t CocoTable::removeRequest(Request* request) {
     return 0;
 }
 
+// Bookkeeping for a CocoTable slot (i.e. a Resource, or a core / cluster / cgroup of a Resource)
+// touched as part of a bulk removal.
+typedef struct {
+    int32_t mPrimaryIndex;
+    int32_t mBaseIndex;
+    DLRootNode* mAppliedNode;
+    Resource* mResource;
+} TouchedSlot;
+
+// Index of the SYSTEM_HIGH list for the Resource's core / cluster / cgroup.
+int32_t CocoTable::getCocoTableBaseIndex(Resource* resource) {
+    ResConfInfo* resourceConfig = this->mResourceRegistry->getResConf(resource->getResCode());
+    if(resourceConfig == nullptr) return -1;
+
+    if(resourceConfig->mApplyType == ResourceApplyType::APPLY_CORE ||
+       resourceConfig->mApplyType == ResourceApplyType::APPLY_CLUSTER ||
+       resourceConfig->mApplyType == ResourceApplyType::APPLY_CGROUP) {
+        return this->getCocoTableSecondaryIndex(resource, SYSTEM_HIGH);
+    }
+
+    return 0;
+}
+
+// The node currently in effect for a slot, i.e. the head of the highest priority non-empty list.
+DLRootNode* CocoTable::getAppliedNode(int32_t primaryIndex, int32_t baseIndex, int8_t& priority) {
+    for(int32_t prioLevel = 0; prioLevel < TOTAL_PRIORITIES; prioLevel++) {
+        DLManager* dlm = this->mCocoTable[primaryIndex][prioLevel + baseIndex];
+        if(dlm != nullptr && dlm->mHead != nullptr) {
+            priority = prioLevel;
+            return dlm->mHead;
+        }
+    }
+
+    priority = -1;
+    return nullptr;
+}
+
+// Bulk variant of removeRequest, used when all the Requests of a client need to be dropped.
+// Phase 1:
+// Unlink the CocoNodes for all the Requests, while recording for every touched slot, the node
+// which was in effect before any of the nodes were unlinked.
+// Phase 2:
+// Re-evaluate each touched slot once. If the node in effect has changed, apply the new one,
+// or reset the Resource if the slot is now empty.
+int8_t CocoTable::removeRequests(const std::vector<Request*>& requests) {
+    std::vector<TouchedSlot> touchedSlots;
+    std::unordered_map<int64_t, int32_t> touchedSlotIndex;
+
+    for(Request* request: requests) {
+        if(request == nullptr || request->getResDlMgr() == nullptr) continue;
+        TYPELOGV(NOTIFY_COCO_TABLE_REMOVAL_START, request->getHandle());
+
+        DL_ITERATE(request->getResDlMgr()) {
+            if(iter == nullptr) continue;
+
+            ResIterable* resIter = (ResIterable*) iter;
+            if(resIter == nullptr || resIter->mData == nullptr) continue;
+
+            Resource* resource = (Resource*) resIter->mData;
+
+            int8_t priority = request->getPriority();
+            int32_t primaryIndex = this->getCocoTablePrimaryIndex(resource->getResCode());
+            int32_t secondaryIndex = this->getCocoTableSecondaryIndex(resource, priority);
+
+            if(primaryIndex < 0 || secondaryIndex < 0 ||
+               primaryIndex >= (int32_t)this->mCocoTable.size() ||
+               secondaryIndex >= (int32_t)this->mCocoTable[primaryIndex].size()) {
+                continue;
+            }
+
+            DLManager* dlm = this->mCocoTable[primaryIndex][secondaryIndex];
+            if(dlm == nullptr) continue;
+
+            ResConfInfo* resourceConfig = this->mResourceRegistry->getResConf(resource->getResCode());
+            if(!this->needsAllocation(resource)) {
+                if(resourceConfig->mPolicy == Policy::PASS_THROUGH) {
+                    if(--dlm->mRank == 0) {
+                        this->fastPathReset(resource);
+                    }
+                } else {
+                    this->fastPathReset(resource);
+                }
+                continue;
+            }
+
+            int32_t baseIndex = this->getCocoTableBaseIndex(resource);
+            if(baseIndex < 0) continue;
+
+            int64_t slotKey = ((int64_t)primaryIndex << 32) | (uint32_t)baseIndex;
+            if(touchedSlotIndex.find(slotKey) == touchedSlotIndex.end()) {
+                int8_t appliedPriority = -1;
+                touchedSlotIndex[slotKey] = touchedSlots.size();
+                touchedSlots.push_back({
+                    primaryIndex,
+                    baseIndex,
+                    this->getAppliedNode(primaryIndex, baseIndex, appliedPriority),
+                    resource
+                });
+            }
+
+            dlm->deleteNode(iter);
+        }
+    }
+
+    for(TouchedSlot& slot: touchedSlots) {
+        int8_t priority = -1;
+        DLRootNode* appliedNode = this->getAppliedNode(slot.mPrimaryIndex, slot.mBaseIndex, priority);
+
+        // The node in effect was not part of the removed Requests, no action needed.
+        if(appliedNode == slot.mAppliedNode) continue;
+
+        if(appliedNode == nullptr) {
+            this->removeAction(slot.mPrimaryIndex, slot.mResource);
+        } else {
+            this->mCurrentlyAppliedPriority[slot.mPrimaryIndex] = priority;
+            this->applyAction(static_cast<ResIterable*>(appliedNode), slot.mPrimaryIndex, priority);
+        }
+    }
+
+    return true;
+}
+
 void CocoTable::timerExpired(Request* request) {
     TYPELOGV(NOTIFY_COCO_TABLE_REQUEST_EXPIRY, request->getHandle());
 
@@ -0,0 +1,265 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <unordered_set>
+
+#include "DefaultsJournal.h"
+#include "Logger.h"
+
+#define DEFAULTS_JOURNAL_MAGIC 0x4a4d5255 // "URMJ"
+#define DEFAULTS_JOURNAL_VERSION 1
+
+typedef struct {
+    uint32_t mMagic;
+    uint32_t mVersion;
+} JournalHeader;
+
+// Record Layout: [u32 payload length][u32 payload checksum][payload]
+// Payload Layout: [u16 node path length][node path][u16 value length][value]
+typedef struct {
+    uint32_t mPayloadSize;
+    uint32_t mChecksum;
+} RecordHeader;
+
+static uint32_t checksum(const uint8_t* data, size_t size) {
+    // FNV-1a (32-bit)
+    uint32_t hash = 0x811c9dc5U;
+    for(size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x01000193U;
+    }
+    return hash;
+}
+
+static int8_t writeFully(int32_t fd, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    while(size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if(written < 0) {
+            if(errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+DefaultsJournal::DefaultsJournal() {
+    this->mFd = -1;
+    this->mSyncPending = false;
+    this->mStopSync.store(false);
+}
+
+ErrCode DefaultsJournal::open(const std::string& journalPath) {
+    if(this->isOpen()) {
+        this->close();
+    }
+
+    int32_t fd = ::open(journalPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if(fd < 0) {
+        TYPELOGV(ERRNO_LOG, "open", strerror(errno));
+        return RC_FILE_NOT_FOUND;
+    }
+
+    JournalHeader header;
+    header.mMagic = DEFAULTS_JOURNAL_MAGIC;
+    header.mVersion = DEFAULTS_JOURNAL_VERSION;
+    if(!writeFully(fd, &header, sizeof(header)) || fdatasync(fd) < 0) {
+        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+        ::close(fd);
+        return RC_INVALID_VALUE;
+    }
+
+    this->mFd = fd;
+    this->mSyncPending = false;
+    this->mStopSync.store(false);
+
+    try {
+        this->mSyncThread = std::thread(&DefaultsJournal::syncRoutine, this);
+    } catch(const std::system_error& e) {
+        TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "defaults-journal", e.what());
+        ::close(this->mFd);
+        this->mFd = -1;
+        return RC_MODULE_INIT_FAILURE;
+    }
+
+    return RC_SUCCESS;
+}
+
+ErrCode DefaultsJournal::append(const std::string& nodePath, const std::string& value) {
+    if(nodePath.length() > UINT16_MAX || value.length() > UINT16_MAX) {
+        return RC_INVALID_VALUE;
+    }
+
+    uint16_t pathLen = nodePath.length();
+    uint16_t valueLen = value.length();
+
+    // Encode the whole record upfront, so that it is appended with a single write.
+    std::vector<uint8_t> record(sizeof(RecordHeader) + 2 * sizeof(uint16_t) + pathLen + valueLen);
+    uint8_t* payload = record.data() + sizeof(RecordHeader);
+    uint8_t* cursor = payload;
+
+    memcpy(cursor, &pathLen, sizeof(pathLen));
+    cursor += sizeof(pathLen);
+    memcpy(cursor, nodePath.data(), pathLen);
+    cursor += pathLen;
+    memcpy(cursor, &valueLen, sizeof(valueLen));
+    cursor += sizeof(valueLen);
+    memcpy(cursor, value.data(), valueLen);
+    cursor += valueLen;
+
+    RecordHeader header;
+    header.mPayloadSize = cursor - payload;
+    header.mChecksum = checksum(payload, header.mPayloadSize);
+    memcpy(record.data(), &header, sizeof(header));
+
+    const std::lock_guard<std::mutex> lock(this->mJournalMutex);
+    if(this->mFd < 0) {
+        return RC_INVALID_VALUE;
+    }
+
+    if(!writeFully(this->mFd, record.data(), record.size())) {
+        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+        return RC_INVALID_VALUE;
+    }
+
+    if(!this->mSyncPending) {
+        this->mSyncPending = true;
+        this->mSyncCond.notify_one();
+    }
+
+    return RC_SUCCESS;
+}
+
+void DefaultsJournal::syncRoutine() {
+    std::unique_lock<std::mutex> lock(this->mJournalMutex);
+    while(true) {
+        this->mSyncCond.wait(lock, [this] {
+            return this->mSyncPending || this->mStopSync.load();
+        });
+
+        if(this->mStopSync.load()) {
+            break;
+        }
+
+        // Let the appends accumulate, all of them are then committed together.
+        this->mSyncCond.wait_for(lock,
+                                 std::chrono::milliseconds(DEFAULTS_JOURNAL_COMMIT_INTERVAL_MS),
+                                 [this] {return this->mStopSync.load();});
+
+        this->mSyncPending = false;
+        int32_t fd = this->mFd;
+
+        lock.unlock();
+        if(fdatasync(fd) < 0) {
+            TYPELOGV(ERRNO_LOG, "fdatasync", strerror(errno));
+        }
+        lock.lock();
+    }
+}
+
+void DefaultsJournal::close() {
+    {
+        const std::lock_guard<std::mutex> lock(this->mJournalMutex);
+        this->mStopSync.store(true);
+        this->mSyncCond.notify_one();
+    }
+
+    if(this->mSyncThread.joinable()) {
+        this->mSyncThread.join();
+    }
+
+    const std::lock_guard<std::mutex> lock(this->mJournalMutex);
+    if(this->mFd >= 0) {
+        fdatasync(this->mFd);
+        ::close(this->mFd);
+        this->mFd = -1;
+    }
+}
+
+int8_t DefaultsJournal::isOpen() {
+    const std::lock_guard<std::mutex> lock(this->mJournalMutex);
+    return this->mFd >= 0;
+}
+
+ErrCode DefaultsJournal::replay(const std::string& journalPath,
+                                std::vector<std::pair<std::string, std::string>>& entries) {
+    std::ifstream journal(journalPath, std::ios::binary);
+    if(!journal.is_open()) {
+        return RC_FILE_NOT_FOUND;
+    }
+
+    std::vector<uint8_t> contents((std::istreambuf_iterator<char>(journal)),
+                                  std::istreambuf_iterator<char>());
+
+    JournalHeader header;
+    if(contents.size() < sizeof(header)) {
+        return RC_INVALID_VALUE;
+    }
+
+    memcpy(&header, contents.data(), sizeof(header));
+    if(header.mMagic != DEFAULTS_JOURNAL_MAGIC || header.mVersion != DEFAULTS_JOURNAL_VERSION) {
+        return RC_INVALID_VALUE;
+    }
+
+    std::unordered_set<std::string> seenNodes;
+    size_t offset = sizeof(header);
+
+    while(offset + sizeof(RecordHeader) <= contents.size()) {
+        RecordHeader record;
+        memcpy(&record, contents.data() + offset, sizeof(record));
+        offset += sizeof(record);
+
+        if(record.mPayloadSize > contents.size() - offset) {
+            LOGW("RESTUNE_DEFAULTS_JOURNAL", "Dropping truncated journal tail");
+            break;
+        }
+
+        const uint8_t* payload = contents.data() + offset;
+        if(checksum(payload, record.mPayloadSize) != record.mChecksum) {
+            LOGW("RESTUNE_DEFAULTS_JOURNAL", "Dropping corrupt journal tail");
+            break;
+        }
+        offset += record.mPayloadSize;
+
+        // The checksum matched, but still validate the inner lengths before use.
+        uint16_t pathLen = 0;
+        uint16_t valueLen = 0;
+        size_t remaining = record.mPayloadSize;
+
+        if(remaining < sizeof(pathLen)) break;
+        memcpy(&pathLen, payload, sizeof(pathLen));
+        payload += sizeof(pathLen);
+        remaining -= sizeof(pathLen);
+
+        if(remaining < (size_t)pathLen + sizeof(valueLen)) break;
+        std::string nodePath((const char*)payload, pathLen);
+        payload += pathLen;
+        remaining -= pathLen;
+
+        memcpy(&valueLen, payload, sizeof(valueLen));
+        payload += sizeof(valueLen);
+        remaining -= sizeof(valueLen);
+
+        if(remaining != valueLen) break;
+        std::string value((const char*)payload, valueLen);
+
+        if(seenNodes.insert(nodePath).second) {
+            entries.push_back({nodePath, value});
+        }
+    }
+
+    return RC_SUCCESS;
+}
+
+DefaultsJournal::~DefaultsJournal() {
+    this->close();
+}
@@ -10,6 +10,8 @@
 #include <shared_mutex>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <functional>
 #include "string.h"
 #include "unistd.h"
 #include "fstream"
@@ -24,20 +26,47 @@
 
 #define PER_CLIENT_TID_CAP 32
 
+// Number of stripes the client tables are split into, entries are assigned by PID / TID.
+#define CLIENT_TABLE_SHARDS 16
+
+// Per-client RateLimiter token bucket, packed into a single 64-bit word so that it can be
+// updated with one CAS: [63:22] Timestamp of the last admitted request (monotonic ms),
+// [21:0] Tokens (i.e. client health) in units of 1/100th.
+#define RATE_LIMIT_TOKEN_BITS 22
+#define RATE_LIMIT_TOKEN_MASK ((1ULL << RATE_LIMIT_TOKEN_BITS) - 1)
+#define RATE_LIMIT_TOKEN_SCALE 100.0
+#define RATE_LIMIT_MAX_TOKENS 10000
+
+#define PACK_RATE_LIMIT_STATE(timestamp, tokens) \
+    (((uint64_t)(timestamp) << RATE_LIMIT_TOKEN_BITS) | ((uint64_t)(tokens) & RATE_LIMIT_TOKEN_MASK))
+#define RATE_LIMIT_STATE_TIMESTAMP(state) ((int64_t)((state) >> RATE_LIMIT_TOKEN_BITS))
+#define RATE_LIMIT_STATE_TOKENS(state) ((int64_t)((state) & RATE_LIMIT_TOKEN_MASK))
+
 typedef struct _client_info {
     uint8_t mClientType;
     int32_t mCurClientThreads;
     int32_t mClientTIDs[PER_CLIENT_TID_CAP];
+    int32_t mPidFd; //!< pidfd used for liveness tracking, -1 if the client is not watched.
 
-    _client_info(): mCurClientThreads(0) {}
+    _client_info(): mCurClientThreads(0), mPidFd(-1) {}
 } ClientInfo;
 
 typedef struct {
     std::unordered_set<int64_t>* mClientHandles;
-    int64_t mLastRequestTimestamp;
-    double mHealth;
+    // Updated by the RateLimiter without any table lock held, hence atomic.
+    std::atomic<uint64_t> mRateLimitState;
 } ClientTidData;
 
+typedef struct {
+    std::unordered_map<pid_t, ClientInfo*> mClientRepo; //!< Client Info for the PIDs mapped to this shard
+    std::shared_timed_mutex mShardMutex;
+} ClientShard;
+
+typedef struct {
+    std::unordered_map<pid_t, ClientTidData*> mClientTidRepo; //!< Client Info for the TIDs mapped to this shard
+    std::shared_timed_mutex mShardMutex;
+} ClientTidShard;
+
 /**
  * @details Stores and Maintains Client Tracking Data for all the Active Clients (i.e. clients with
  *          outstanding Requests). The Data Tracked for each Client includes:
@@ -47,17 +76,34 @@ typedef struct {
  *          - Health and Timestamp of Last Request (Used by RateLimiter)
  *          - Essentially ClientDataManager is a central storage for Client Data, and other Components
  *            like RateLimiter, PulseMonitor and RequestManager are clients of the ClientDataManager.
+ *
+ *          Both the PID and TID tables are striped into CLIENT_TABLE_SHARDS shards, each with its own
+ *          lock, so that operations on different clients do not contend with each other. Where both
+ *          are needed, the PID shard lock is always acquired before the TID shard lock.
  */
 class ClientDataManager {
 private:
     static std::shared_ptr<ClientDataManager> mClientDataManagerInstance;
     static std::mutex instanceProtectionLock;
-    std::unordered_map<pid_t, ClientInfo*> mClientRepo; //!< Maintains Client Info indexed by PID
-    std::unordered_map<pid_t, ClientTidData*> mClientTidRepo; //!< Maintains Client Info indexed by TID
-    std::shared_timed_mutex mGlobalTableMutex;
+    ClientShard mClientShards[CLIENT_TABLE_SHARDS]; //!< Maintains Client Info indexed by PID
+    ClientTidShard mClientTidShards[CLIENT_TABLE_SHARDS]; //!< Maintains Client Info indexed by TID
+
+    int32_t mLivenessEpollFd; //!< epoll set holding the pidfds of all the watched clients
+    int8_t mPidFdSupported;
 
     ClientDataManager();
 
+    ClientShard& getClientShard(pid_t clientPID) {
+        return this->mClientShards[(uint32_t)clientPID % CLIENT_TABLE_SHARDS];
+    }
+
+    ClientTidShard& getClientTidShard(pid_t clientTID) {
+        return this->mClientTidShards[(uint32_t)clientTID % CLIENT_TABLE_SHARDS];
+    }
+
+    void watchClient(pid_t clientPID, ClientInfo* clientInfo);
+    void unwatchClient(ClientInfo* clientInfo);
+
 public:
     /**
      * @brief Checks if the client with the given ID exists in the Client Data Table.
@@ -104,6 +150,20 @@ public:
      */
     void deleteRequestByClientId(pid_t clientTID, int64_t requestHandle);
 
+    /**
+     * @brief Atomically update the RateLimiter token bucket for the given client.
+     * @details update is called with the current packed state (use the RATE_LIMIT_STATE_*
+     *          macros to decode it) and returns the new state. It is retried if the bucket is
+     *          concurrently modified, hence it must not have side effects other than on its
+     *          own captures. The client entry is kept alive for the duration of the update.
+     * @param clientTID TID of the client
+     * @param update Computes the new bucket state from the current one
+     * @return int8_t:\n
+     *            - true: If the client exists and the bucket was updated.\n
+     *            - false: Otherwise.
+     */
+    int8_t updateRateLimitState(pid_t clientTID, const std::function<uint64_t(uint64_t)>& update);
+
     /**
      * @brief This method is called by the RateLimiter to fetch the current health for a given
      *        client in the Client Data Table.
@@ -118,7 +178,7 @@ public:
      *        client in the Client Data Table.
      * @param clientTID TID of the client
      * @return int64_t:\n
-     *             - Timestamp of Last Request (A value of 0, indicates no prior Requests).
+     *             - Monotonic Timestamp of Last Request (A value of 0, indicates no prior Requests).
      */
     int64_t getLastRequestTimestampByClientID(pid_t clientTID);
 
@@ -157,6 +217,34 @@ public:
      */
     void getActiveClientList(std::vector<pid_t>& clientList);
 
+    /**
+     * @brief Fetch the list of active clients, which are not being watched via a pidfd.
+     * @details Liveness of these clients can only be determined by polling /proc. On kernels
+     *          without pidfd support, this is the complete list of active clients.
+     * @param clientList An IN/OUT parameter to store the list of unwatched clients.
+     */
+    void getUnwatchedClientList(std::vector<pid_t>& clientList);
+
+    /**
+     * @brief Checks if client liveness can be tracked via pidfds on this kernel.
+     * @return int8_t:\n
+     *            - 1: If pidfd based liveness tracking is supported\n
+     *            - 0: otherwise
+     */
+    int8_t isLivenessTrackingSupported();
+
+    /**
+     * @brief Blocks until one or more of the watched clients terminate, or the timeout expires.
+     * @details Each termination is reported exactly once, the client's pidfd is released
+     *          when the client PID entry is deleted.
+     * @param deadClients An IN/OUT parameter to store the PIDs of the terminated clients.
+     * @param timeoutMs Max time to wait for (in milliseconds).
+     * @return int32_t:\n
+     *            - Number of terminated clients reported\n
+     *            - -1: If the wait failed
+     */
+    int32_t waitForClientExits(std::vector<pid_t>& deadClients, int32_t timeoutMs);
+
     /**
      * @brief Delete a client PID Entry from the Client Table.
      * @param clientPID Process ID of the client
@@ -169,6 +257,8 @@ public:
      */
     void deleteClientTID(pid_t clientTID);
 
+    ~ClientDataManager();
+
     static std::shared_ptr<ClientDataManager> getInstance() {
         if(mClientDataManagerInstance == nullptr) {
             instanceProtectionLock.lock();
@@ -14,7 +14,8 @@
  * \details Runs as a Daemon Thread and Periodically (Every 83 seconds) and performs cleanup for
  *          a pre-defined max number of clients found in the Garbage Collector Queue (added by the Pulse Monitor).\n
  *          As part of the cleanup:\n\n
- *          1) All the active Requests from the client (if any) are untuned.\n\n
+ *          1) All the active Requests from the client (if any) are untuned, via a single
+ *             Teardown Request per client thread, so that each affected Resource is re-evaluated once.\n\n
  *          2) The Request Manager is updated, so that these requests are no longer tracked
  *             as active Requests.\n\n
  *          3) The Client tracking entries maintained by the ClientDataManager for this client PID are cleared.\n\n
@@ -50,11 +51,16 @@ private:
 
     ClientGarbageCollector();
 
-    void performCleanup();
-
 public:
     ~ClientGarbageCollector();
 
+    /**
+     * @brief Clean up the next batch of clients in the queue, run periodically by the daemon.
+     * @details Client threads with active Requests are handed to the RequestQueue as a Teardown
+     *          Request, their ClientDataManager entries are deleted once it is processed.
+     */
+    void performCleanup();
+
     /**
      * @brief Starts the Client Garbage Collector
      * @details To start the Client Garbage Collector a recurring timer is created by using a
@@ -128,6 +128,9 @@ private:
     void fastPathReset(Resource* resource);
     int8_t needsAllocation(Resource* res);
 
+    int32_t getCocoTableBaseIndex(Resource* resource);
+    DLRootNode* getAppliedNode(int32_t primaryIndex, int32_t baseIndex, int8_t& priority);
+
 public:
     ~CocoTable();
 
@@ -157,6 +160,21 @@ public:
      */
     int8_t removeRequest(Request* req);
 
+    /**
+     * @brief Used to untune a batch of previously issued Tune Requests, in a single pass.
+     * @details This routine is used for client teardown. First, the CocoNodes of all the
+     *          Requests are unlinked from the Resource Level Linked Lists. Then, every affected
+     *          Resource (or core / cluster / cgroup of a Resource) is re-evaluated exactly once:
+     *          the new head is applied, or the Resource is reset if no Requests are left for it.
+     *          Note, the Request Timers are not killed, and the Requests are not freed.
+     *
+     * @param requests List of Requests to be removed
+     * @return int8_t:\n
+     *            - 1: If the Requests were Removed successfully from the CocoTable
+     *            - 0: Otherwise
+     */
+    int8_t removeRequests(const std::vector<Request*>& requests);
+
     /**
      * @brief Used to update the duration of an Active Request
      * @details This routine is invoked when a retune request is received, to modify the
@@ -0,0 +1,85 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef DEFAULTS_JOURNAL_H
+#define DEFAULTS_JOURNAL_H
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <condition_variable>
+
+#include "ErrCodes.h"
+
+/**
+ * @brief Appends within this window are made durable by a single fdatasync.
+ */
+#define DEFAULTS_JOURNAL_COMMIT_INTERVAL_MS 20
+
+/**
+ * @brief DefaultsJournal
+ * @details Append-only journal of the original values of the nodes modified by Resource Tuner,
+ *          used to restore them if the Server goes down without a clean teardown.\n
+ *          Each node is journaled once, when its default is captured (i.e. before it is first
+ *          written). Records are length-prefixed and individually checksummed, so a torn or
+ *          corrupt tail left behind by a crash is detected and dropped on replay, without
+ *          affecting the records preceding it.\n
+ *          Appends only write to the page cache, which already survives a Server crash.
+ *          Durability against a system crash is provided by a background thread, which
+ *          batches all the appends made within DEFAULTS_JOURNAL_COMMIT_INTERVAL_MS into a
+ *          single fdatasync (group commit), keeping the sync off the Request path.
+ */
+class DefaultsJournal {
+private:
+    int32_t mFd;
+    std::mutex mJournalMutex;
+    std::condition_variable mSyncCond;
+    int8_t mSyncPending;
+    std::atomic<int8_t> mStopSync;
+    std::thread mSyncThread;
+
+    void syncRoutine();
+
+public:
+    DefaultsJournal();
+    ~DefaultsJournal();
+
+    /**
+     * @brief Create a fresh journal at the given path, replacing any existing one.
+     * @return ErrCode:\n
+     *            - RC_SUCCESS: If the journal was created and the sync thread started
+     *            - Enum Code indicating error: Otherwise.
+     */
+    ErrCode open(const std::string& journalPath);
+
+    /**
+     * @brief Record the original value of a node. Non-blocking with respect to disk I/O.
+     */
+    ErrCode append(const std::string& nodePath, const std::string& value);
+
+    /**
+     * @brief Flush all the pending appends to disk, stop the sync thread and close the journal.
+     */
+    void close();
+
+    int8_t isOpen();
+
+    /**
+     * @brief Read back the valid records from a journal.
+     * @details Replay stops at the first truncated or corrupt record. If a node was
+     *          journaled more than once, only its first (i.e. original) value is returned.
+     * @param journalPath Path to the journal.
+     * @param entries Filled with the (node, original value) pairs, in journal order.
+     * @return ErrCode:\n
+     *            - RC_SUCCESS: If the journal was read (possibly with a dropped tail)
+     *            - RC_FILE_NOT_FOUND: If the journal is absent
+     *            - RC_INVALID_VALUE: If the journal header is not recognized
+     */
+    static ErrCode replay(const std::string& journalPath,
+                          std::vector<std::pair<std::string, std::string>>& entries);
+};
+
+#endif
@@ -7,12 +7,15 @@
 #include <unordered_map>
 #include <string>
 #include <system_error>
+#include <new>
 #include <memory>
 #include <shared_mutex>
 
 /**
  * @brief PropertiesRegistry
  * @details Stores and manages all the properties parsed from the Properties Config files.
+ *          On a Config reload, a new generation is built off to the side via createGeneration,
+ *          and then published. Callers holding the previous generation keep it alive until done.
  */
 class PropertiesRegistry {
 private:
@@ -64,12 +67,39 @@ public:
 
     int32_t getPropertiesCount();
 
+    /**
+     * @brief Create a new, empty Registry generation, which is not visible to readers until published.
+     */
+    static std::shared_ptr<PropertiesRegistry> createGeneration() {
+        try {
+            return std::shared_ptr<PropertiesRegistry>(new PropertiesRegistry());
+        } catch(const std::bad_alloc& e) {
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief Atomically make the given generation the one returned by getInstance.
+     */
+    static void publish(std::shared_ptr<PropertiesRegistry> generation) {
+        std::atomic_store(&propRegistryInstance, generation);
+    }
+
     static std::shared_ptr<PropertiesRegistry> getInstance() {
-        if(propRegistryInstance == nullptr) {
-            std::shared_ptr<PropertiesRegistry> localpropRegistryInstance(new PropertiesRegistry());
-            localpropRegistryInstance.swap(propRegistryInstance);
+        std::shared_ptr<PropertiesRegistry> instance = std::atomic_load(&propRegistryInstance);
+        if(instance == nullptr) {
+            std::shared_ptr<PropertiesRegistry> generation = createGeneration();
+            if(generation == nullptr) {
+                return nullptr;
+            }
+
+            // Lost the race, use the instance created by the other thread.
+            if(!std::atomic_compare_exchange_strong(&propRegistryInstance, &instance, generation)) {
+                return instance;
+            }
+            instance = generation;
         }
-        return propRegistryInstance;
+        return instance;
     }
 };
 
@@ -8,16 +8,19 @@
 /*!
  * \ingroup  PULSE_MONITOR
  * \defgroup PULSE_MONITOR Pulse Monitor
- * \details Runs as a Daemon Thread and Periodically (Every 60 seconds) checks if any of the Clients with
- *          Active or Pending Requests with the Resource Tuner Server have died or terminated.
+ * \details Runs as a Daemon Thread and tracks if any of the Clients with Active or Pending Requests
+ *          with the Resource Tuner Server have died or terminated.
  *          When such a Client is Found it is added to the Garbage Collector Queue, so that it
  *          can be cleaned up.
  *
  *          Pulse Monitor Flow:\n\n
- *          1) The Pulse Monitor, retrieves the list of Clients (i.e. clients with Outstanding Requests)
- *             from the ClientDataManager.\n\n
- *          2) Next, it checks if the /proc/<pid>/status file exists for this Process or not. If it does
- *             not exist, it indicates that the Process has been terminated.\n\n
+ *          1) Every new client is watched via a pidfd, registered by the ClientDataManager in an
+ *             epoll set. A dedicated watcher thread waits on this set, so client termination is
+ *             observed as soon as it happens.\n\n
+ *          2) As a fallback (for kernels without pidfd support, or if the pidfd could not be opened),
+ *             the Pulse Monitor periodically (Every 60 seconds) retrieves the list of unwatched Clients
+ *             from the ClientDataManager, and checks if the /proc/<pid>/comm file exists for these
+ *             Processes or not. If it does not exist, it indicates that the Process has been terminated.\n\n
  *          3) If it detects a Dead Client, the Pulse Monitor adds it to the Garbage Collector Queue,
  *             for further cleanup (Refer ClientGarbageCollector for more details regarding Cleanup).\n\n
  *
@@ -28,6 +31,8 @@
 #define PULSE_MONITOR_H
 
 #include <mutex>
+#include <thread>
+#include <atomic>
 #include <dirent.h>
 
 #include "Timer.h"
@@ -49,10 +54,14 @@ private:
     static std::shared_ptr<PulseMonitor> mPulseMonitorInstance;
     Timer* mTimer;
     uint32_t mPulseDuration;
+    std::thread mLivenessWatcher;
+    std::atomic<int8_t> mStopWatcher;
 
     PulseMonitor();
 
     int8_t checkForDeadClients();
+    void watchClientLiveness();
+    void handleDeadClient(pid_t pid);
 
 public:
     ~PulseMonitor();
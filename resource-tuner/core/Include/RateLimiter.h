@@ -15,7 +15,11 @@
  *          health and a reward result in an increment in health (upto 100 max).
  *          If the client health drops to a value <= 0, then the client shall be dropped, i.e. any
  *          further requests sent by the client will be dropped without any further processing.\n\n
- *          How are Punishment and Rewards Defined: RateLimiter provides a time interval “delta”, say 5 ms. If a client sends 2 requests within a time interval smaller than delta, then we punish the client. If consecutive client requests are suitably spaced out, we reward the client for good behavior.
+ *          How are Punishment and Rewards Defined: RateLimiter provides a time interval “delta”, say 5 ms. If a client sends 2 requests within a time interval smaller than delta, then we punish the client. If consecutive client requests are suitably spaced out, we reward the client for good behavior.\n\n
+ *          The health is tracked as a per-client token bucket, stored inline in the client's
+ *          ClientDataManager entry together with the timestamp of the last admitted request.
+ *          Both are packed into a single 64-bit word and updated with a CAS, against a monotonic
+ *          clock. Hence admission requires no global lock, and is not affected by wall-clock jumps.
  *
  * @{
  */
@@ -24,7 +28,7 @@
 #define RATE_LIMITER_H
 
 #include <mutex>
-#include <shared_mutex>
+#include <atomic>
 #include <memory>
 
 #include "RequestManager.h"
@@ -39,12 +43,11 @@ class RateLimiter {
 private:
     static std::shared_ptr<RateLimiter> mRateLimiterInstance;
     static std::mutex instanceProtectionLock;
-    std::shared_timed_mutex mRateLimiterMutex;
 
     uint32_t mDelta;
-    double mPenaltyFactor;
-    double mRewardFactor;
-    int8_t shouldBeProcessed(pid_t clientPID);
+    int64_t mPenaltyTokens;
+    int64_t mRewardTokens;
+    int8_t shouldBeProcessed(pid_t clientTID, int64_t currentMillis);
 
     RateLimiter();
 
@@ -62,6 +65,12 @@ public:
      */
     int8_t isRateLimitHonored(pid_t clientTID);
 
+    /**
+     * @brief Same as above, but against the given monotonic timestamp (in ms) instead of the
+     *        current time. Meant for deterministic evaluation of the policy.
+     */
+    int8_t isRateLimitHonored(pid_t clientTID, int64_t currentMillis);
+
     /**
      * @brief Checks if the Global Rate Limit is honored.
      * @details Resource Tuner sets a cap on the number of Active Requests which can be
@@ -0,0 +1,99 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef REQUEST_JOURNAL_H
+#define REQUEST_JOURNAL_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ErrCodes.h"
+
+/**
+ * @brief The journal is compacted once the stale records outnumber the live ones by this margin.
+ */
+#define REQUEST_JOURNAL_COMPACTION_SLACK 64
+
+typedef struct {
+    int64_t mHandle;
+    /**
+     * @brief Monotonic time (in ms) at which the Request expires, -1 for infinite Requests.
+     */
+    int64_t mExpiry;
+    /**
+     * @brief Start time of the client thread (refer AuxRoutines::getTaskStartTime), -1 if unknown.
+     * @details Tells the client apart from a thread which has since been given the same tid.
+     */
+    int64_t mClientStartTime;
+    /**
+     * @brief The Tune Request, in the wire format accepted by Request::deserialize.
+     */
+    std::vector<char> mRequestData;
+} JournaledRequest;
+
+/**
+ * @brief RequestJournal
+ * @details On-disk record of the Requests currently applied via the CocoTable, used to re-apply
+ *          them with their original handles if the Server is restarted.\n
+ *          The journal is append-only: every applied or retuned Request appends an ADD record
+ *          carrying the Request and its absolute expiry, and every removal appends a REMOVE
+ *          record. Records are length-prefixed and checksummed, a torn tail is dropped on replay.
+ *          Once the stale records dominate, the live set is rewritten to a fresh file which is
+ *          atomically renamed into place.\n
+ *          Expiries are tracked against the monotonic clock, hence the journal is expected to
+ *          live on a tmpfs (under /run), so that it never outlives a reboot.
+ */
+class RequestJournal {
+private:
+    std::string mJournalPath;
+    int32_t mFd;
+    int64_t mStaleRecords;
+    uint64_t mNextSequence;
+    // Handle -> (Order in which the Request was first applied, Encoded ADD record)
+    std::unordered_map<int64_t, std::pair<uint64_t, std::vector<char>>> mLiveRecords;
+    std::mutex mJournalMutex;
+
+    ErrCode appendRecord(const std::vector<char>& record);
+    void compact();
+
+public:
+    RequestJournal();
+    ~RequestJournal();
+
+    /**
+     * @brief Create a fresh (empty) journal at the given path, replacing any existing one.
+     */
+    ErrCode open(const std::string& journalPath);
+    void close();
+
+    /**
+     * @brief Record a Request which was applied (or retuned).
+     * @param handle Request Handle.
+     * @param expiry Monotonic expiry time in ms, or -1 for infinite Requests.
+     * @param clientStartTime Start time of the client thread, or -1 if unknown.
+     * @param requestData Request, as encoded by Request::serialize.
+     * @param size Number of bytes in requestData.
+     */
+    ErrCode recordAdd(int64_t handle, int64_t expiry, int64_t clientStartTime,
+                      const char* requestData, int32_t size);
+
+    /**
+     * @brief Record the removal of a Request, i.e. untune, expiry or client teardown.
+     */
+    ErrCode recordRemove(int64_t handle);
+
+    /**
+     * @brief Read back the Requests which were live when the journal was last written.
+     * @param journalPath Path to the journal.
+     * @param requests Filled with the live Requests, in the order they were first applied.
+     * @return ErrCode:\n
+     *            - RC_SUCCESS: If the journal was read (possibly with a dropped tail)
+     *            - RC_FILE_NOT_FOUND: If the journal is absent
+     *            - RC_INVALID_VALUE: If the journal header is not recognized
+     */
+    static ErrCode replay(const std::string& journalPath, std::vector<JournaledRequest>& requests);
+};
+
+#endif
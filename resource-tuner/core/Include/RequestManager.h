@@ -11,6 +11,7 @@
 #include "Request.h"
 #include "CocoTable.h"
 #include "ClientDataManager.h"
+#include "RequestJournal.h"
 
 typedef std::pair<Request*, int8_t> RequestInfo;
 
@@ -43,9 +44,12 @@ private:
     std::unordered_map<int64_t, RequestInfo> mActiveRequests;
     MinLRUCache mUntuneCache;
     std::shared_timed_mutex mRequestMapMutex;
+    RequestJournal mRequestJournal;
 
     RequestManager();
 
+    void journalRequest(Request* request);
+
     int8_t checkOwnership(Request* request, Request* targetRequest);
     int8_t isSane(Request* request);
     int8_t requestMatch(Request* request);
@@ -86,6 +90,17 @@ public:
      */
     void removeRequest(Request* request);
 
+    /**
+     * @brief Remove all the Requests issued by the given client thread from the RequestMap
+     * @details Requests which have already been inserted into the CocoTable are removed from
+     *          the map and returned to the caller, which is responsible for untuning and freeing them.
+     *          Requests still waiting in the RequestQueue are marked as cancelled instead, so that
+     *          they are dropped when dequeued.
+     * @param clientTID Thread ID of the client
+     * @param removedRequests List to be populated with the removed Requests
+     */
+    void removeRequestsByClientID(int32_t clientTID, std::vector<Request*>& removedRequests);
+
     /**
      * @brief Retrieve the Request with the given Handle.
      * @param handle Request Handle
@@ -113,8 +128,26 @@ public:
      */
     int8_t disableRequestProcessing(int64_t handle);
 
+    /**
+     * @brief Mark the Request as inserted into the CocoTable.
+     * @details From this point on, the Request is tracked in the Request Journal (if open),
+     *          until it is removed from the RequestMap.
+     */
     void markRequestAsComplete(int64_t handle);
 
+    /**
+     * @brief Refresh the journaled copy of a Request, after its duration has been updated.
+     */
+    void updateJournaledRequest(Request* request);
+
+    /**
+     * @brief Start journaling the active Requests, refer RequestJournal.
+     * @details Any journal left behind at the given path is replaced, hence it should be
+     *          replayed before this routine is called.
+     */
+    ErrCode openRequestJournal(const std::string& journalPath);
+    void closeRequestJournal();
+
     int8_t getRequestProcessingStatus(int64_t handle);
 
     std::vector<Request*> getPendingList();
@@ -4,6 +4,7 @@
 #ifndef RESOURCE_REGISTRY_H
 #define RESOURCE_REGISTRY_H
 
+#include <mutex>
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -11,6 +12,8 @@
 #include "UrmPlatformAL.h"
 #include "Resource.h"
 #include "Extensions.h"
+#include "DirectIndexTable.h"
+#include "DefaultsJournal.h"
 #include "Logger.h"
 #include "Utils.h"
 
@@ -101,13 +104,22 @@ private:
 
     std::vector<ResConfInfo*> mResourceConfigs;
     std::unordered_map<uint32_t, int32_t> mSILMap;
+    DirectIndexTable mResourceLookup;
+    // Guards mDefaultValueStore and mDefaultsCaptured, which are accessed from the
+    // Request handler, the Resource callbacks and the teardown path.
+    std::mutex mDefaultValueMutex;
     std::unordered_map<std::string, std::string> mDefaultValueStore;
+    // Indexed by Resource Table Index, whether the defaults have been captured.
+    std::vector<int8_t> mDefaultsCaptured;
+    DefaultsJournal mDefaultsJournal;
 
     ResourceRegistry();
 
     int8_t isResourceConfigMalformed(ResConfInfo* resourceConfigInfo);
     void setLifeCycleCallbacks(ResConfInfo* resourceConfigInfo);
+    void getNodePaths(ResConfInfo* resourceConfigInfo, std::vector<std::string>& nodePaths);
     void fetchAndStoreDefaults(ResConfInfo* resourceConfigInfo);
+    void storeNodeDefault(const std::string& nodePath);
 
 public:
     ~ResourceRegistry();
@@ -133,11 +145,54 @@ public:
 
     int32_t getResourceTableIndex(uint32_t resourceId);
     int32_t getTotalResourcesCount();
+
+    /**
+     * @brief Build the direct-indexed lookup table over all the registered Resources.
+     * @details Should be called once Config parsing is complete. Until then (or if any
+     *          further Resource is registered), lookups are served via mSILMap.
+     */
+    void buildLookupTable();
+
+    /**
+     * @brief Capture the default values of all the nodes backing the given Resource.
+     * @details Defaults are not read at registration, instead they are captured lazily,
+     *          right before the Resource is first applied. This is a no-op for all the
+     *          subsequent calls, so the value read is the one in place before any
+     *          modification by Resource Tuner. Nodes of Resources which are never applied
+     *          are never read, and need no restoration.
+     * @param resourceId An unsigned 32 bit integer, representing the Resource ID.
+     */
+    void captureDefaults(uint32_t resourceId);
+
+    /**
+     * @brief Get the captured default value for the given node.
+     * @return std::string:\n
+     *          - The default value, if captured.
+     *          - Empty string, otherwise.
+     */
     std::string getDefaultValue(const std::string& fileName);
 
+    /**
+     * @brief Checks whether the given path is the node of a registered Resource, i.e. its
+     *        path with the core / cluster / cgroup filled in.
+     * @param filePath The path to check.
+     * @return int8_t:\n
+     *            - 1: If the path is a Resource node.\n
+     *            - 0: otherwise
+     */
+    int8_t isResourceNodePath(const std::string& filePath);
+
     void addDefaultValue(const std::string& key, const std::string& value);
     void deleteDefaultValue(const std::string& filePath);
     void restoreResourcesToDefaultValues();
+
+    /**
+     * @brief Start journaling the captured node defaults, refer DefaultsJournal.
+     * @details Should be called before any Resource is applied, and after any journal left
+     *          behind by a previous run has been replayed, since the journal is recreated afresh.
+     */
+    ErrCode openDefaultsJournal(const std::string& journalPath);
+    void closeDefaultsJournal();
     void displayResources();
 
     // Merge the Changes provided by the BU with the existing ResourceTable.
@@ -31,6 +31,17 @@ void submitResProvisionReqMsg(void* request);
 
 void submitResProvisionRequest(Request* request, int8_t isVerified);
 
+/**
+ * @brief Re-submit a Request which was applied by an earlier Server instance (refer RequestJournal).
+ * @details The Request (already translated) is re-verified against the current configs and
+ *          client permissions, and dropped if it no longer passes.
+ * @param request The Request, as deserialized from the journal.
+ * @return int8_t:\n
+ *            - true: If the Request passed verification and was submitted.\n
+ *            - false: If it was dropped.
+ */
+int8_t resubmitResProvisionRequest(Request* request);
+
 /**
  * @brief Gets a property from the Config Store.
  * @details Note: This API is meant to be used internally, i.e. by other Resource Tuner modules like Signals
@@ -142,6 +142,17 @@ public:
 
     ClusterInfo* getClusterInfo(int32_t physicalClusterID);
 
+    /**
+     * @brief Check that already translated physical IDs still exist on the target.
+     * @details Used to re-verify Requests which were translated by an earlier Server instance.
+     * @param physicalClusterId The Physical Cluster ID.
+     * @param physicalCoreId The Physical Core ID, 0 if the value applies to all the cores of the Cluster.
+     * @return int8_t:\n
+     *            - true: If the Cluster (and the Core, as part of it) exist.\n
+     *            - false: otherwise
+     */
+    int8_t isValidPhysicalId(int32_t physicalClusterId, int32_t physicalCoreId);
+
     /**
      * @brief Called during Server Init, to read and Parse the Logical To Physical Core / Cluster Mappings.
      * @details This routine will extract the physical Core IDs and the list of CPU cores part of each Physical Cluster
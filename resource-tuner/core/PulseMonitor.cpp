@@ -5,33 +5,66 @@
 
 std::shared_ptr<PulseMonitor> PulseMonitor::mPulseMonitorInstance = nullptr;
 
+// Upper bound on how long the watcher thread blocks, before checking for a stop request.
+#define LIVENESS_WAIT_TIMEOUT_MS 1000
+
 PulseMonitor::PulseMonitor() {
     this->mTimer = nullptr;
     this->mPulseDuration = UrmSettings::metaConfigs.mPulseDuration;
+    this->mStopWatcher.store(false);
+}
+
+void PulseMonitor::handleDeadClient(pid_t pid) {
+    // Client is dead, Schedule it for deletion.
+    LOGD("RESTUNE_PULSE_MONITOR", "Client with PID: " + std::to_string(pid) + " is dead.");
+    ClientGarbageCollector::getInstance()->submitClientForCleanup(pid);
+    ClientDataManager::getInstance()->deleteClientPID(pid);
 }
 
-// Check for optimizations
+// Fallback path, only covers the clients which are not watched via a pidfd.
 int8_t PulseMonitor::checkForDeadClients() {
     // stores pid of all the running process right now
     std::vector<int32_t> clientList;
 
     // This method will internally acquire a shared lock on the table.
-    ClientDataManager::getInstance()->getActiveClientList(clientList);
+    ClientDataManager::getInstance()->getUnwatchedClientList(clientList);
 
     // Delete the clients if they are dead.
     for(int32_t pid: clientList) {
         if(!AuxRoutines::fileExists(COMM(pid))) {
-            // Client is dead, Schedule it for deletion.
-            LOGD("RESTUNE_PULSE_MONITOR", "Client with PID: " + std::to_string(pid) + " is dead.");
-            ClientGarbageCollector::getInstance()->submitClientForCleanup(pid);
-            ClientDataManager::getInstance()->deleteClientPID(pid);
+            this->handleDeadClient(pid);
         }
     }
 
     return 0;
 }
 
+void PulseMonitor::watchClientLiveness() {
+    std::shared_ptr<ClientDataManager> clientDataManager = ClientDataManager::getInstance();
+    std::vector<pid_t> deadClients;
+
+    while(!this->mStopWatcher.load()) {
+        deadClients.clear();
+        if(clientDataManager->waitForClientExits(deadClients, LIVENESS_WAIT_TIMEOUT_MS) < 0) {
+            break;
+        }
+
+        for(pid_t pid: deadClients) {
+            this->handleDeadClient(pid);
+        }
+    }
+}
+
 ErrCode PulseMonitor::startPulseMonitorDaemon() {
+    if(ClientDataManager::getInstance()->isLivenessTrackingSupported()) {
+        try {
+            this->mLivenessWatcher = std::thread(&PulseMonitor::watchClientLiveness, this);
+        } catch(const std::system_error& e) {
+            TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "pulse-monitor", e.what());
+            return RC_MODULE_INIT_FAILURE;
+        }
+    }
+
     try {
         this->mTimer = MPLACEV(Timer, std::bind(&PulseMonitor::checkForDeadClients, this), true);
 
@@ -51,6 +84,11 @@ ErrCode PulseMonitor::startPulseMonitorDaemon() {
 }
 
 void PulseMonitor::stopPulseMonitorDaemon() {
+    this->mStopWatcher.store(true);
+    if(this->mLivenessWatcher.joinable()) {
+        this->mLivenessWatcher.join();
+    }
+
     if(this->mTimer != nullptr) {
         this->mTimer->killTimer();
     }
@@ -1,6 +1,8 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <cmath>
+
 #include "RateLimiter.h"
 
 std::shared_ptr<RateLimiter> RateLimiter::mRateLimiterInstance = nullptr;
@@ -8,50 +10,48 @@ std::mutex RateLimiter::instanceProtectionLock{};
 
 RateLimiter::RateLimiter() {
     this->mDelta = UrmSettings::metaConfigs.mDelta;
-    this->mPenaltyFactor = UrmSettings::metaConfigs.mPenaltyFactor;
-    this->mRewardFactor = UrmSettings::metaConfigs.mRewardFactor;
+    this->mPenaltyTokens = std::llround(UrmSettings::metaConfigs.mPenaltyFactor * RATE_LIMIT_TOKEN_SCALE);
+    this->mRewardTokens = std::llround(UrmSettings::metaConfigs.mRewardFactor * RATE_LIMIT_TOKEN_SCALE);
 }
 
-int8_t RateLimiter::shouldBeProcessed(pid_t clientTID) {
-    this->mRateLimiterMutex.lock();
-
-    double health = ClientDataManager::getInstance()->getHealthByClientID(clientTID);
-    if(health <= 0) {
-        // Repeat offender, total block
-        this->mRateLimiterMutex.unlock();
-        return false;
-    }
+int8_t RateLimiter::shouldBeProcessed(pid_t clientTID, int64_t currentMillis) {
+    int64_t tokens = 0;
 
-    int64_t currentMillis = AuxRoutines::getCurrentTimeInMilliseconds();
-    // If this is the First Request, don't update the Health
-    if(ClientDataManager::getInstance()->getLastRequestTimestampByClientID(clientTID) != 0) {
-        int64_t requestDelta = currentMillis - ClientDataManager::getInstance()->getLastRequestTimestampByClientID(clientTID);
-
-        if(requestDelta < mDelta) {
-            health -= mPenaltyFactor;
-        } else {
-            // Increase in health
-            health = std::min(100.0, health + this->mRewardFactor);
+    int8_t clientFound = ClientDataManager::getInstance()->updateRateLimitState(clientTID,
+                                                                               [&](uint64_t state) -> uint64_t {
+        tokens = RATE_LIMIT_STATE_TOKENS(state);
+        if(tokens <= 0) {
+            // Repeat offender, total block
+            return state;
         }
-    }
-
-    ClientDataManager::getInstance()->updateHealthByClientID(clientTID, health);
 
-    // Check if client health is positive
-    if(health <= 0) {
-        this->mRateLimiterMutex.unlock();
-        return false;
-    }
+        int64_t lastRequestMillis = RATE_LIMIT_STATE_TIMESTAMP(state);
+        // If this is the First Request, don't update the Health
+        if(lastRequestMillis != 0) {
+            if(currentMillis - lastRequestMillis < this->mDelta) {
+                tokens -= this->mPenaltyTokens;
+            } else {
+                // Increase in health
+                tokens = std::min((int64_t)RATE_LIMIT_MAX_TOKENS, tokens + this->mRewardTokens);
+            }
+        }
 
-    // Request can be accepted
-    ClientDataManager::getInstance()->updateLastRequestTimestampByClientID(clientTID, currentMillis);
-    this->mRateLimiterMutex.unlock();
+        if(tokens <= 0) {
+            // Request will be dropped, the last request timestamp stays unchanged.
+            return PACK_RATE_LIMIT_STATE(lastRequestMillis, 0);
+        }
+        return PACK_RATE_LIMIT_STATE(currentMillis, tokens);
+    });
 
-    return true;
+    return (clientFound && tokens > 0);
 }
 
 int8_t RateLimiter::isRateLimitHonored(pid_t clientTID) {
-    return shouldBeProcessed(clientTID);
+    return shouldBeProcessed(clientTID, AuxRoutines::getMonotonicTimeInMilliseconds());
+}
+
+int8_t RateLimiter::isRateLimitHonored(pid_t clientTID, int64_t currentMillis) {
+    return shouldBeProcessed(clientTID, currentMillis);
 }
 
 int8_t RateLimiter::isGlobalRateLimitHonored() {
@@ -216,6 +216,98 @@ static int8_t VerifyIncomingRequest(Request* req) {
     return true;
 }
 
+/**
+ * @brief Verifies a Request which was journaled by an earlier Server instance.
+ * @details Such a Request was verified and translated when first submitted, hence it carries
+ *          the granted priority and physical IDs. These are checked against the current
+ *          registries and client permissions, since the configs may have changed across the restart.
+ *
+ * @param req Pointer to the Request object.
+ * @return int8_t:\n
+ *            - 1: if the request is still valid.\n
+ *            - 0: otherwise.
+ */
+static int8_t VerifyReplayedRequest(Request* req) {
+    if(req->getDuration() < -1 || req->getDuration() == 0) return false;
+
+    if(UrmSettings::targetConfigs.currMode != MODE_RESUME) {
+        TYPELOGV(VERIFIER_INVALID_DEVICE_MODE, req->getHandle());
+        return false;
+    }
+
+    int8_t clientPermissions =
+        ClientDataManager::getInstance()->getClientLevelByID(req->getClientPID());
+    if(clientPermissions == -1) {
+        TYPELOGV(VERIFIER_INVALID_PERMISSION, req->getClientPID(), req->getClientTID());
+        return false;
+    }
+
+    // The granted priority, it must still be allowed for the client.
+    int8_t priority = req->getPriority();
+    if(priority < SYSTEM_HIGH || priority >= TOTAL_PRIORITIES) {
+        TYPELOGV(VERIFIER_INVALID_PRIORITY, priority);
+        return false;
+    }
+    if((priority == SYSTEM_HIGH || priority == SYSTEM_LOW) && clientPermissions != PERMISSION_SYSTEM) {
+        TYPELOGV(VERIFIER_INVALID_PRIORITY, priority);
+        return false;
+    }
+
+    if(req->getResDlMgr() == nullptr) {
+        return false;
+    }
+
+    std::shared_ptr<TargetRegistry> targetRegistry = TargetRegistry::getInstance();
+    DL_ITERATE(req->getResDlMgr()) {
+        ResIterable* resIter = (ResIterable*) iter;
+        if(resIter == nullptr || resIter->mData == nullptr) return false;
+
+        Resource* resource = (Resource*) resIter->mData;
+        ResConfInfo* resourceConfig = ResourceRegistry::getInstance()->getResConf(resource->getResCode());
+        if(resourceConfig == nullptr) {
+            TYPELOGV(VERIFIER_INVALID_OPCODE, resource->getResCode());
+            return false;
+        }
+
+        if(resource->getValuesCount() == 1) {
+            int32_t configValue = resource->getValueAt(0);
+            int32_t lowThreshold = resourceConfig->mLowThreshold;
+            int32_t highThreshold = resourceConfig->mHighThreshold;
+
+            if((lowThreshold != -1 && highThreshold != -1) &&
+                (configValue < lowThreshold || configValue > highThreshold)) {
+                TYPELOGV(VERIFIER_VALUE_OUT_OF_BOUNDS, configValue, resource->getResCode());
+                return false;
+            }
+        }
+
+        if(resourceConfig->mPermissions == PERMISSION_SYSTEM && clientPermissions == PERMISSION_THIRD_PARTY) {
+            TYPELOGV(VERIFIER_NOT_SUFFICIENT_PERMISSION, resource->getResCode());
+            return false;
+        }
+
+        int32_t coreValue = -1;
+        switch(resourceConfig->mApplyType) {
+            case ResourceApplyType::APPLY_CORE:
+                coreValue = resource->getCoreValue();
+                break;
+            case ResourceApplyType::APPLY_CLUSTER:
+                coreValue = 0;
+                break;
+            default:
+                break;
+        }
+
+        if(coreValue != -1 && (targetRegistry == nullptr ||
+           !targetRegistry->isValidPhysicalId(resource->getClusterValue(), coreValue))) {
+            TYPELOGV(VERIFIER_LOGICAL_TO_PHYSICAL_MAPPING_FAILED, resource->getResCode());
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static int8_t addToRequestManager(Request* request) {
     std::shared_ptr<RequestManager> requestManager = RequestManager::getInstance();
 
@@ -345,6 +437,29 @@ void submitResProvisionRequest(Request* request, int8_t isValidated) {
     processIncomingRequest(request, isValidated);
 }
 
+int8_t resubmitResProvisionRequest(Request* request) {
+    if(request == nullptr) return false;
+
+    // Replay runs before any client has connected, the permission level is
+    // only known once the client entry is created.
+    std::shared_ptr<ClientDataManager> clientDataManager = ClientDataManager::getInstance();
+    if(!clientDataManager->clientExists(request->getClientPID(), request->getClientTID()) &&
+       !clientDataManager->createNewClient(request->getClientPID(), request->getClientTID())) {
+        TYPELOGV(CLIENT_ENTRY_CREATION_FAILURE, request->getHandle());
+        Request::cleanUpRequest(request);
+        return false;
+    }
+
+    if(!VerifyReplayedRequest(request)) {
+        TYPELOGV(VERIFIER_STATUS_FAILURE, request->getHandle());
+        Request::cleanUpRequest(request);
+        return false;
+    }
+
+    processIncomingRequest(request, true);
+    return true;
+}
+
 void submitResProvisionReqMsg(void* msg) {
     if(msg == nullptr) return;
 
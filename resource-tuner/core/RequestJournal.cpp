@@ -0,0 +1,326 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "RequestJournal.h"
+#include "Logger.h"
+
+#define REQUEST_JOURNAL_MAGIC 0x514d5255 // "URMQ"
+#define REQUEST_JOURNAL_VERSION 2
+
+enum JournalRecordKind : uint8_t {
+    RECORD_ADD = 1,
+    RECORD_REMOVE = 2,
+};
+
+typedef struct {
+    uint32_t mMagic;
+    uint32_t mVersion;
+} JournalHeader;
+
+// Record Layout: [u32 payload length][u32 payload checksum][payload]
+// Payload Layout: [u8 kind][i64 handle][i64 expiry][i64 client start time][Request data (ADD only)]
+typedef struct {
+    uint32_t mPayloadSize;
+    uint32_t mChecksum;
+} RecordHeader;
+
+static const size_t payloadFixedSize = sizeof(uint8_t) + 3 * sizeof(int64_t);
+
+static uint32_t checksum(const char* data, size_t size) {
+    // FNV-1a (32-bit)
+    uint32_t hash = 0x811c9dc5U;
+    for(size_t i = 0; i < size; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x01000193U;
+    }
+    return hash;
+}
+
+static int8_t writeFully(int32_t fd, const char* data, size_t size) {
+    while(size > 0) {
+        ssize_t written = write(fd, data, size);
+        if(written < 0) {
+            if(errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static std::vector<char> encodeRecord(uint8_t kind, int64_t handle, int64_t expiry,
+                                      int64_t clientStartTime, const char* requestData,
+                                      int32_t size) {
+    std::vector<char> record(sizeof(RecordHeader) + payloadFixedSize + size);
+    char* payload = record.data() + sizeof(RecordHeader);
+    char* cursor = payload;
+
+    memcpy(cursor, &kind, sizeof(kind));
+    cursor += sizeof(kind);
+    memcpy(cursor, &handle, sizeof(handle));
+    cursor += sizeof(handle);
+    memcpy(cursor, &expiry, sizeof(expiry));
+    cursor += sizeof(expiry);
+    memcpy(cursor, &clientStartTime, sizeof(clientStartTime));
+    cursor += sizeof(clientStartTime);
+    if(size > 0) {
+        memcpy(cursor, requestData, size);
+        cursor += size;
+    }
+
+    RecordHeader header;
+    header.mPayloadSize = cursor - payload;
+    header.mChecksum = checksum(payload, header.mPayloadSize);
+    memcpy(record.data(), &header, sizeof(header));
+
+    return record;
+}
+
+static int32_t createJournalFile(const std::string& filePath) {
+    int32_t fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0600);
+    if(fd < 0) {
+        TYPELOGV(ERRNO_LOG, "open", strerror(errno));
+        return -1;
+    }
+
+    JournalHeader header;
+    header.mMagic = REQUEST_JOURNAL_MAGIC;
+    header.mVersion = REQUEST_JOURNAL_VERSION;
+    if(!writeFully(fd, (const char*)&header, sizeof(header))) {
+        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+RequestJournal::RequestJournal() {
+    this->mFd = -1;
+    this->mStaleRecords = 0;
+    this->mNextSequence = 0;
+}
+
+ErrCode RequestJournal::open(const std::string& journalPath) {
+    const std::lock_guard<std::mutex> lock(this->mJournalMutex);
+    if(this->mFd >= 0) {
+        ::close(this->mFd);
+    }
+
+    this->mJournalPath = journalPath;
+    this->mStaleRecords = 0;
+    this->mLiveRecords.clear();
+
+    this->mFd = createJournalFile(journalPath);
+    if(this->mFd < 0) {
+        return RC_FILE_NOT_FOUND;
+    }
+
+    return RC_SUCCESS;
+}
+
+void RequestJournal::close() {
+    const std::lock_guard<std::mutex> lock(this->mJournalMutex);
+    if(this->mFd >= 0) {
+        ::close(this->mFd);
+        this->mFd = -1;
+    }
+    this->mLiveRecords.clear();
+}
+
+// Expects mJournalMutex to be held.
+ErrCode RequestJournal::appendRecord(const std::vector<char>& record) {
+    if(this->mFd < 0) {
+        return RC_INVALID_VALUE;
+    }
+
+    if(!writeFully(this->mFd, record.data(), record.size())) {
+        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_SUCCESS;
+}
+
+// Expects mJournalMutex to be held.
+void RequestJournal::compact() {
+    std::vector<const std::pair<uint64_t, std::vector<char>>*> liveRecords;
+    liveRecords.reserve(this->mLiveRecords.size());
+    for(const auto& entry: this->mLiveRecords) {
+        liveRecords.push_back(&entry.second);
+    }
+
+    // Preserve the order in which the Requests were applied.
+    std::sort(liveRecords.begin(), liveRecords.end(), [](const auto* a, const auto* b) {
+        return a->first < b->first;
+    });
+
+    std::string tmpPath = this->mJournalPath + ".tmp";
+    int32_t fd = createJournalFile(tmpPath);
+    if(fd < 0) {
+        return;
+    }
+
+    for(const auto* record: liveRecords) {
+        if(!writeFully(fd, record->second.data(), record->second.size())) {
+            TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+            ::close(fd);
+            unlink(tmpPath.c_str());
+            return;
+        }
+    }
+
+    if(rename(tmpPath.c_str(), this->mJournalPath.c_str()) < 0) {
+        TYPELOGV(ERRNO_LOG, "rename", strerror(errno));
+        ::close(fd);
+        unlink(tmpPath.c_str());
+        return;
+    }
+
+    ::close(this->mFd);
+    this->mFd = fd;
+    this->mStaleRecords = 0;
+}
+
+ErrCode RequestJournal::recordAdd(int64_t handle, int64_t expiry, int64_t clientStartTime,
+                                  const char* requestData, int32_t size) {
+    if(requestData == nullptr || size <= 0) {
+        return RC_INVALID_VALUE;
+    }
+
+    std::vector<char> record = encodeRecord(RECORD_ADD, handle, expiry, clientStartTime,
+                                              requestData, size);
+
+    const std::lock_guard<std::mutex> lock(this->mJournalMutex);
+    ErrCode opStatus = this->appendRecord(record);
+    if(RC_IS_NOTOK(opStatus)) {
+        return opStatus;
+    }
+
+    auto it = this->mLiveRecords.find(handle);
+    if(it != this->mLiveRecords.end()) {
+        // Retuned, the earlier record is superseded.
+        it->second.second = std::move(record);
+        this->mStaleRecords++;
+    } else {
+        this->mLiveRecords[handle] = {this->mNextSequence++, std::move(record)};
+    }
+
+    return RC_SUCCESS;
+}
+
+ErrCode RequestJournal::recordRemove(int64_t handle) {
+    const std::lock_guard<std::mutex> lock(this->mJournalMutex);
+    if(this->mLiveRecords.erase(handle) == 0) {
+        // Never journaled (for ex. removed before it was applied).
+        return RC_SUCCESS;
+    }
+
+    ErrCode opStatus = this->appendRecord(encodeRecord(RECORD_REMOVE, handle, 0, 0, nullptr, 0));
+    if(RC_IS_NOTOK(opStatus)) {
+        return opStatus;
+    }
+
+    // Both the ADD and REMOVE records for this handle are now stale.
+    this->mStaleRecords += 2;
+    if(this->mStaleRecords > (int64_t)this->mLiveRecords.size() + REQUEST_JOURNAL_COMPACTION_SLACK) {
+        this->compact();
+    }
+
+    return RC_SUCCESS;
+}
+
+ErrCode RequestJournal::replay(const std::string& journalPath, std::vector<JournaledRequest>& requests) {
+    std::ifstream journal(journalPath, std::ios::binary);
+    if(!journal.is_open()) {
+        return RC_FILE_NOT_FOUND;
+    }
+
+    std::vector<char> contents((std::istreambuf_iterator<char>(journal)),
+                               std::istreambuf_iterator<char>());
+
+    JournalHeader header;
+    if(contents.size() < sizeof(header)) {
+        return RC_INVALID_VALUE;
+    }
+
+    memcpy(&header, contents.data(), sizeof(header));
+    if(header.mMagic != REQUEST_JOURNAL_MAGIC || header.mVersion != REQUEST_JOURNAL_VERSION) {
+        return RC_INVALID_VALUE;
+    }
+
+    // Handle -> Index in requests, entries which get removed are left empty and skipped below.
+    std::unordered_map<int64_t, size_t> liveIndex;
+    std::vector<JournaledRequest> entries;
+    size_t offset = sizeof(header);
+
+    while(offset + sizeof(RecordHeader) <= contents.size()) {
+        RecordHeader record;
+        memcpy(&record, contents.data() + offset, sizeof(record));
+        offset += sizeof(record);
+
+        if(record.mPayloadSize > contents.size() - offset || record.mPayloadSize < payloadFixedSize) {
+            LOGW("RESTUNE_REQUEST_JOURNAL", "Dropping truncated journal tail");
+            break;
+        }
+
+        const char* payload = contents.data() + offset;
+        if(checksum(payload, record.mPayloadSize) != record.mChecksum) {
+            LOGW("RESTUNE_REQUEST_JOURNAL", "Dropping corrupt journal tail");
+            break;
+        }
+        offset += record.mPayloadSize;
+
+        uint8_t kind = 0;
+        int64_t handle = 0;
+        int64_t expiry = 0;
+        int64_t clientStartTime = 0;
+        const char* cursor = payload;
+        memcpy(&kind, cursor, sizeof(kind));
+        cursor += sizeof(kind);
+        memcpy(&handle, cursor, sizeof(handle));
+        cursor += sizeof(handle);
+        memcpy(&expiry, cursor, sizeof(expiry));
+        cursor += sizeof(expiry);
+        memcpy(&clientStartTime, cursor, sizeof(clientStartTime));
+
+        auto it = liveIndex.find(handle);
+        if(kind == RECORD_ADD) {
+            const char* requestData = payload + payloadFixedSize;
+            std::vector<char> data(requestData, requestData + (record.mPayloadSize - payloadFixedSize));
+
+            if(it != liveIndex.end()) {
+                entries[it->second].mExpiry = expiry;
+                entries[it->second].mClientStartTime = clientStartTime;
+                entries[it->second].mRequestData = std::move(data);
+            } else {
+                liveIndex[handle] = entries.size();
+                entries.push_back({handle, expiry, clientStartTime, std::move(data)});
+            }
+
+        } else if(kind == RECORD_REMOVE && it != liveIndex.end()) {
+            entries[it->second].mRequestData.clear();
+            liveIndex.erase(it);
+        }
+    }
+
+    for(JournaledRequest& entry: entries) {
+        if(entry.mRequestData.size() > 0) {
+            requests.push_back(std::move(entry));
+        }
+    }
+
+    return RC_SUCCESS;
+}
+
+RequestJournal::~RequestJournal() {
+    this->close();
+}
@@ -192,12 +192,48 @@ void RequestManager::removeRequest(Request* request) {
     int64_t handle = request->getHandle();
 
     ClientDataManager::getInstance()->deleteRequestByClientId(clientTID, handle);
+    this->mRequestJournal.recordRemove(handle);
 
     // Remove the handle from the list of active requests
     this->mActiveRequests.erase(handle);
     this->mRequestMapMutex.unlock();
 }
 
+void RequestManager::removeRequestsByClientID(int32_t clientTID, std::vector<Request*>& removedRequests) {
+    this->mRequestMapMutex.lock();
+
+    // The client's handles are only added / removed with the map lock held. A copy is
+    // walked, since the handles are removed from the set along the way.
+    std::unordered_set<int64_t>* clientHandles =
+        ClientDataManager::getInstance()->getRequestsByClientID(clientTID);
+    if(clientHandles == nullptr) {
+        this->mRequestMapMutex.unlock();
+        return;
+    }
+    std::vector<int64_t> handles(clientHandles->begin(), clientHandles->end());
+
+    for(int64_t handle: handles) {
+        auto it = this->mActiveRequests.find(handle);
+        if(it == this->mActiveRequests.end()) continue;
+
+        Request* request = it->second.first;
+        if(request == nullptr || request->getClientTID() != clientTID) continue;
+
+        if((it->second.second & REQ_COMPLETED) == 0) {
+            // Not yet in the CocoTable, let the RequestQueue drop it.
+            it->second.second |= REQ_CANCELLED;
+            continue;
+        }
+
+        ClientDataManager::getInstance()->deleteRequestByClientId(clientTID, handle);
+        this->mRequestJournal.recordRemove(handle);
+        removedRequests.push_back(request);
+        this->mActiveRequests.erase(it);
+    }
+
+    this->mRequestMapMutex.unlock();
+}
+
 std::vector<Request*> RequestManager::getPendingList() {
     this->mRequestMapMutex.lock_shared();
     std::vector<Request*> pendingList;
@@ -233,11 +269,65 @@ int64_t RequestManager::getActiveReqeustsCount() {
 }
 
 void RequestManager::markRequestAsComplete(int64_t handle) {
+    Request* request = nullptr;
+
     this->mRequestMapMutex.lock();
-    if(this->mActiveRequests.find(handle) != this->mActiveRequests.end()) {
-        this->mActiveRequests[handle].second |= REQ_COMPLETED;
+    auto it = this->mActiveRequests.find(handle);
+    if(it != this->mActiveRequests.end()) {
+        it->second.second |= REQ_COMPLETED;
+        request = it->second.first;
     }
     this->mRequestMapMutex.unlock();
+
+    // The journal write (and /proc read) is kept out of the map lock. The Request can't go away
+    // meanwhile: removals are processed by the RequestQueue thread (the caller), and its expiry
+    // timer is only started once it is inserted into the CocoTable.
+    this->journalRequest(request);
+}
+
+// The Request is journaled along with its absolute expiry, so that on replay
+// only the remaining duration is applied. Called without the map lock held.
+void RequestManager::journalRequest(Request* request) {
+    if(request == nullptr) return;
+
+    char requestData[REQ_BUFFER_SIZE];
+    int32_t size = request->serialize(requestData, sizeof(requestData));
+    if(size <= 0) {
+        return;
+    }
+
+    int64_t expiry = -1;
+    if(request->getDuration() != -1) {
+        expiry = AuxRoutines::getMonotonicTimeInMilliseconds() + request->getDuration();
+    }
+
+    // Lets the replay tell whether the client is still around, or its tid was reused.
+    int64_t clientStartTime = -1;
+    if(!AuxRoutines::getTaskStartTime(request->getClientPID(), request->getClientTID(), clientStartTime)) {
+        clientStartTime = -1;
+    }
+
+    this->mRequestJournal.recordAdd(request->getHandle(), expiry, clientStartTime, requestData, size);
+}
+
+void RequestManager::updateJournaledRequest(Request* request) {
+    if(request == nullptr) return;
+    this->mRequestMapMutex.lock_shared();
+    int8_t isActive = (this->mActiveRequests.find(request->getHandle()) != this->mActiveRequests.end());
+    this->mRequestMapMutex.unlock_shared();
+
+    // Same as markRequestAsComplete, retunes are processed by the RequestQueue thread.
+    if(isActive) {
+        this->journalRequest(request);
+    }
+}
+
+ErrCode RequestManager::openRequestJournal(const std::string& journalPath) {
+    return this->mRequestJournal.open(journalPath);
+}
+
+void RequestManager::closeRequestJournal() {
+    this->mRequestJournal.close();
 }
 
 int8_t RequestManager::getRequestProcessingStatus(int64_t handle) {
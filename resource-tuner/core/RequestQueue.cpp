@@ -49,6 +49,22 @@ void RequestQueue::orderedQueueConsumerHook() {
                 continue;
             }
 
+        } else if(req->getRequestType() == REQ_CLIENT_TEARDOWN) {
+            // Drop all the Requests from this client, each affected Resource is re-evaluated only once.
+            std::vector<Request*> clientRequests;
+            requestManager->removeRequestsByClientID(req->getClientTID(), clientRequests);
+            cocoTable->removeRequests(clientRequests);
+
+            for(Request* clientRequest: clientRequests) {
+                Request::cleanUpRequest(clientRequest);
+            }
+
+            // The client's handles are no longer needed.
+            ClientDataManager::getInstance()->deleteClientTID(req->getClientTID());
+
+            // Free Up the Teardown Request
+            Request::cleanUpRequest(req);
+
         } else {
             // For Tune and Untune Requests, get the Corresponding Tune Request from the RequestManager
             RequestInfo matchingTuneReq = requestManager->getRequestFromMap(req->getHandle());
@@ -82,8 +98,8 @@ void RequestQueue::orderedQueueConsumerHook() {
                     // Request not in Coco Table yet
                     // Update the Request Duration directly.
                     matchingTuneReq.first->setDuration(newDuration);
-                } else {
-                    cocoTable->updateRequest(matchingTuneReq.first, newDuration);
+                } else if(cocoTable->updateRequest(matchingTuneReq.first, newDuration)) {
+                    requestManager->updateJournaledRequest(matchingTuneReq.first);
                 }
 
                 // Free Up the Retune Request
@@ -42,17 +42,35 @@ void ResourceRegistry::setLifeCycleCallbacks(ResConfInfo* resourceConfigInfo) {
 }
 
 void ResourceRegistry::addDefaultValue(const std::string& filePath, const std::string& value) {
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueMutex);
+
+    // Same as storeNodeDefault, defaults recorded by the appliers (incl. the plugin
+    // provided ones) need to be restored after a crash as well. Only the Resource nodes
+    // though, the other recorded defaults (for ex. a task's cgroup under /proc/<pid>)
+    // are meaningless once the Server is gone.
+    if(this->mDefaultsJournal.isOpen() &&
+       this->mDefaultValueStore.find(filePath) == this->mDefaultValueStore.end() &&
+       this->isResourceNodePath(filePath)) {
+        this->mDefaultsJournal.append(filePath, value);
+    }
+
     this->mDefaultValueStore[filePath] = value;
+}
+
+// Expects mDefaultValueMutex to be held.
+void ResourceRegistry::storeNodeDefault(const std::string& nodePath) {
+    std::string value = AuxRoutines::readFromFile(nodePath);
+
+    // Journal the node before it gets modified, so that it can be restored after a crash.
+    if(this->mDefaultsJournal.isOpen() &&
+       this->mDefaultValueStore.find(nodePath) == this->mDefaultValueStore.end()) {
+        this->mDefaultsJournal.append(nodePath, value);
+    }
 
-    // std::fstream persistenceFile(UrmSettings::mPersistenceFile, std::ios::out | std::ios::app);
-    // std::string resourceData = filePath;
-    // resourceData.push_back(',');
-    // resourceData.append(value);
-    // resourceData.push_back('\n');
-    // persistenceFile << resourceData;
+    this->mDefaultValueStore[nodePath] = value;
 }
 
-void ResourceRegistry::fetchAndStoreDefaults(ResConfInfo* resourceConfigInfo) {
+void ResourceRegistry::getNodePaths(ResConfInfo* resourceConfigInfo, std::vector<std::string>& nodePaths) {
     if(resourceConfigInfo == nullptr) return;
     switch(resourceConfigInfo->mApplyType) {
         case APPLY_CLUSTER: {
@@ -61,7 +79,7 @@ void ResourceRegistry::fetchAndStoreDefaults(ResConfInfo* resourceConfigInfo) {
             for(int32_t clusterID : clusterIDs) {
                 char filePath[128];
                 snprintf(filePath, sizeof(filePath), resourceConfigInfo->mResourcePath.c_str(), (int32_t)clusterID);
-                this->addDefaultValue(std::string(filePath), AuxRoutines::readFromFile(filePath));
+                nodePaths.push_back(std::string(filePath));
             }
             break;
         }
@@ -71,7 +89,7 @@ void ResourceRegistry::fetchAndStoreDefaults(ResConfInfo* resourceConfigInfo) {
             for(std::string cGroupName : cGroupNames) {
                 char filePath[128];
                 snprintf(filePath, sizeof(filePath), resourceConfigInfo->mResourcePath.c_str(), cGroupName.c_str());
-                this->addDefaultValue(std::string(filePath), AuxRoutines::readFromFile(filePath));
+                nodePaths.push_back(std::string(filePath));
             }
             break;
         }
@@ -80,18 +98,38 @@ void ResourceRegistry::fetchAndStoreDefaults(ResConfInfo* resourceConfigInfo) {
             for(int32_t coreID = 0; coreID < count; coreID++) {
                 char filePath[128];
                 snprintf(filePath, sizeof(filePath), resourceConfigInfo->mResourcePath.c_str(), (int32_t)coreID);
-                this->addDefaultValue(std::string(filePath), AuxRoutines::readFromFile(filePath));
+                nodePaths.push_back(std::string(filePath));
             }
             break;
         }
         case APPLY_GLOBAL: {
-            this->addDefaultValue(resourceConfigInfo->mResourcePath,
-                                  AuxRoutines::readFromFile(resourceConfigInfo->mResourcePath));
+            nodePaths.push_back(resourceConfigInfo->mResourcePath);
             break;
         }
     }
 }
 
+void ResourceRegistry::fetchAndStoreDefaults(ResConfInfo* resourceConfigInfo) {
+    std::vector<std::string> nodePaths;
+    this->getNodePaths(resourceConfigInfo, nodePaths);
+    for(const std::string& nodePath : nodePaths) {
+        this->storeNodeDefault(nodePath);
+    }
+}
+
+int8_t ResourceRegistry::isResourceNodePath(const std::string& filePath) {
+    for(ResConfInfo* resourceConfigInfo : this->mResourceConfigs) {
+        std::vector<std::string> nodePaths;
+        this->getNodePaths(resourceConfigInfo, nodePaths);
+        for(const std::string& nodePath : nodePaths) {
+            if(nodePath == filePath) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void ResourceRegistry::registerResource(ResConfInfo* resourceConfigInfo) {
     // Invalid Resource, skip.
     if(this->isResourceConfigMalformed(resourceConfigInfo)) {
@@ -107,12 +145,16 @@ void ResourceRegistry::registerResource(ResConfInfo* resourceConfigInfo) {
     resourceBitmap |= ((uint32_t)resourceConfigInfo->mResourceResID);
     resourceBitmap |= ((uint32_t)resourceConfigInfo->mResourceResType << 16);
 
+    // Any previously built lookup table is now stale.
+    this->mResourceLookup.reset();
+
     // Check for any conflict
     if(this->mSILMap.find(resourceBitmap) != this->mSILMap.end()) {
         // Resource with the specified ResType and ResCode already exists
         // Overwrite it.
         int32_t resourceTableIndex = getResourceTableIndex(resourceBitmap);
         this->mResourceConfigs[resourceTableIndex] = resourceConfigInfo;
+        this->mDefaultsCaptured[resourceTableIndex] = false;
 
         this->mSILMap.erase(resourceBitmap);
         this->mSILMap[resourceBitmap] = resourceTableIndex;
@@ -120,12 +162,28 @@ void ResourceRegistry::registerResource(ResConfInfo* resourceConfigInfo) {
     } else {
         this->mSILMap[resourceBitmap] = this->mTotalResources;
         this->mResourceConfigs.push_back(resourceConfigInfo);
+        this->mDefaultsCaptured.push_back(false);
 
         this->mTotalResources++;
     }
 
+    // Note, the defaults are captured lazily on first apply, refer captureDefaults.
     this->setLifeCycleCallbacks(resourceConfigInfo);
-    this->fetchAndStoreDefaults(resourceConfigInfo);
+}
+
+void ResourceRegistry::captureDefaults(uint32_t resourceId) {
+    int32_t resourceTableIndex = this->getResourceTableIndex(resourceId);
+    if(resourceTableIndex == -1) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueMutex);
+    if(this->mDefaultsCaptured[resourceTableIndex]) {
+        return;
+    }
+
+    this->fetchAndStoreDefaults(this->mResourceConfigs[resourceTableIndex]);
+    this->mDefaultsCaptured[resourceTableIndex] = true;
 }
 
 void ResourceRegistry::displayResources() {
@@ -148,12 +206,7 @@ std::vector<ResConfInfo*> ResourceRegistry::getRegisteredResources() {
 }
 
 ResConfInfo* ResourceRegistry::getResConf(uint32_t resourceId) {
-    if(this->mSILMap.find(resourceId) == this->mSILMap.end()) {
-        TYPELOGV(RESOURCE_REGISTRY_RESOURCE_NOT_FOUND, resourceId);
-        return nullptr;
-    }
-
-    int32_t resourceTableIndex = this->mSILMap[resourceId];
+    int32_t resourceTableIndex = this->getResourceTableIndex(resourceId);
     if(resourceTableIndex == -1) {
         TYPELOGV(RESOURCE_REGISTRY_RESOURCE_NOT_FOUND, resourceId);
         return nullptr;
@@ -162,11 +215,27 @@ ResConfInfo* ResourceRegistry::getResConf(uint32_t resourceId) {
 }
 
 int32_t ResourceRegistry::getResourceTableIndex(uint32_t resourceId) {
-    if(this->mSILMap.find(resourceId) == this->mSILMap.end()) {
+    int32_t resourceTableIndex = this->mResourceLookup.lookup(resourceId);
+    if(resourceTableIndex != DIRECT_INDEX_FALLBACK) {
+        return resourceTableIndex;
+    }
+
+    auto it = this->mSILMap.find(resourceId);
+    if(it == this->mSILMap.end()) {
         return -1;
     }
 
-    return this->mSILMap[resourceId];
+    return it->second;
+}
+
+void ResourceRegistry::buildLookupTable() {
+    std::vector<std::pair<uint32_t, int32_t>> entries;
+    entries.reserve(this->mSILMap.size());
+    for(std::pair<uint32_t, int32_t> entry: this->mSILMap) {
+        entries.push_back(entry);
+    }
+
+    this->mResourceLookup.build(entries);
 }
 
 int32_t ResourceRegistry::getTotalResourcesCount() {
@@ -174,10 +243,18 @@ int32_t ResourceRegistry::getTotalResourcesCount() {
 }
 
 std::string ResourceRegistry::getDefaultValue(const std::string& filePath) {
-    return this->mDefaultValueStore[filePath];
+    // Lookup without inserting, else restoreResourcesToDefaultValues would
+    // end up writing an empty value to nodes which were never captured.
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueMutex);
+    auto it = this->mDefaultValueStore.find(filePath);
+    if(it == this->mDefaultValueStore.end()) {
+        return "";
+    }
+    return it->second;
 }
 
 void ResourceRegistry::deleteDefaultValue(const std::string& filePath) {
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueMutex);
     this->mDefaultValueStore.erase(filePath);
 }
 
@@ -201,7 +278,13 @@ void ResourceRegistry::pluginModifications() {
 }
 
 void ResourceRegistry::restoreResourcesToDefaultValues() {
-    for(std::pair<std::string, std::string> defaultConfig: this->mDefaultValueStore) {
+    std::unordered_map<std::string, std::string> defaultValues;
+    {
+        const std::lock_guard<std::mutex> lock(this->mDefaultValueMutex);
+        defaultValues = this->mDefaultValueStore;
+    }
+
+    for(std::pair<std::string, std::string> defaultConfig: defaultValues) {
         std::string filePath = defaultConfig.first;
         std::string value = defaultConfig.second;
 
@@ -209,6 +292,15 @@ void ResourceRegistry::restoreResourcesToDefaultValues() {
     }
 }
 
+ErrCode ResourceRegistry::openDefaultsJournal(const std::string& journalPath) {
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueMutex);
+    return this->mDefaultsJournal.open(journalPath);
+}
+
+void ResourceRegistry::closeDefaultsJournal() {
+    this->mDefaultsJournal.close();
+}
+
 ResourceRegistry::~ResourceRegistry() {
     for(size_t i = 0; i < this->mResourceConfigs.size(); i++) {
         if(this->mResourceConfigs[i] != nullptr) {
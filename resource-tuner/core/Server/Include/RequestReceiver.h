@@ -43,6 +43,11 @@ public:
     }
 };
 
-void listenerThreadStartRoutine();
+/**
+ * @brief Entry point for the Listener Thread.
+ * @param serverReadyCb Invoked once, with true when the Server Endpoint is accepting
+ *                      connections, or with false if it could not be set up.
+ */
+void listenerThreadStartRoutine(ServerReadyCallback serverReadyCb);
 
 #endif
@@ -24,6 +24,8 @@
 #include "Logger.h"
 
 #define RESTUNE_SOCKET_PATH "/run/restune_sock"
+// Name under which the listening socket is kept in systemd's fd store
+#define RESTUNE_SOCKET_FD_NAME "restune_sock"
 
 static const uint32_t maxEvents = 128;
 
@@ -32,11 +34,13 @@ private:
     int32_t sockFd;
     ServerOnlineCheckCallback mServerOnlineCheckCb;
     MessageReceivedCallback mMessageRecvCb;
+    ServerReadyCallback mServerReadyCb;
 
 public:
     SocketServer(
         ServerOnlineCheckCallback mServerOnlineCheckCb,
-        MessageReceivedCallback mMessageRecvCb);
+        MessageReceivedCallback mMessageRecvCb,
+        ServerReadyCallback mServerReadyCb = nullptr);
 
     virtual ~SocketServer();
 
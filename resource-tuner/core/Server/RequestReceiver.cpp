@@ -79,14 +79,17 @@ void onMsgRecvCallback(int32_t clientSocket, MsgForwardInfo* msgForwardInfo) {
     requestReceiver->forwardMessage(clientSocket, msgForwardInfo);
 }
 
-void listenerThreadStartRoutine() {
+void listenerThreadStartRoutine(ServerReadyCallback serverReadyCb) {
     SocketServer* connection = nullptr;
 
     try {
-        connection = new SocketServer(checkServerOnlineStatus, onMsgRecvCallback);
+        connection = new SocketServer(checkServerOnlineStatus, onMsgRecvCallback, serverReadyCb);
     } catch(const std::exception& e) {
         LOGE("URM_SERVER_ENDPOINT",
              "Failed to start the Resource Tuner Listener, error: " + std::string(e.what()));
+        if(serverReadyCb != nullptr) {
+            serverReadyCb(false);
+        }
         return;
     }
 
@@ -94,6 +97,11 @@ void listenerThreadStartRoutine() {
         LOGE("URM_SERVER_ENDPOINT", "Server Socket Endpoint crashed");
     }
 
+    // No-op if the Endpoint had already reported itself as ready.
+    if(serverReadyCb != nullptr) {
+        serverReadyCb(false);
+    }
+
     if(connection != nullptr) {
         delete(connection);
     }
@@ -1,6 +1,10 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <cstddef>
+#include <cstdlib>
+#include <sys/uio.h>
+
 #include "RestuneListener.h"
 
 #ifndef UNIX_PATH_MAX
@@ -9,27 +13,146 @@
 
 SocketServer::SocketServer(
     ServerOnlineCheckCallback mServerOnlineCheckCb,
-    MessageReceivedCallback mMessageRecvCb) {
+    MessageReceivedCallback mMessageRecvCb,
+    ServerReadyCallback mServerReadyCb) {
 
     this->sockFd = -1;
     this->mServerOnlineCheckCb = mServerOnlineCheckCb;
     this->mMessageRecvCb = mMessageRecvCb;
+    this->mServerReadyCb = mServerReadyCb;
 }
 
-// Called by server, this will put the server in listening mode
-int32_t SocketServer::ListenForClientRequests() {
-    if((this->sockFd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+// First fd passed by systemd, refer sd_listen_fds(3)
+#define SD_LISTEN_FDS_START 3
+
+static int32_t parseEnvInt(const char* name) {
+    const char* value = getenv(name);
+    if(value == nullptr) return -1;
+
+    char* end = nullptr;
+    errno = 0;
+    long parsed = strtol(value, &end, 10);
+    if(errno != 0 || end == value || *end != '\0' || parsed < 0 || parsed > INT32_MAX) {
+        return -1;
+    }
+    return (int32_t)parsed;
+}
+
+static int8_t isRestuneListenSocket(int32_t fd) {
+    int32_t type = 0, listening = 0;
+    socklen_t len = sizeof(type);
+    if(getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &len) < 0 || type != SOCK_STREAM) {
+        return false;
+    }
+
+    len = sizeof(listening);
+    if(getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &len) < 0 || !listening) {
+        return false;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    len = sizeof(addr);
+    if(getsockname(fd, (sockaddr*)&addr, &len) < 0 || addr.sun_family != AF_UNIX) {
+        return false;
+    }
+
+    return strncmp(addr.sun_path, RESTUNE_SOCKET_PATH, UNIX_PATH_MAX) == 0;
+}
+
+// Pick up the listening socket passed in by systemd, either from urm.socket (socket
+// activation) or from the service's fd store, across a restart. In both cases the socket
+// was never closed, so Clients connecting in the meantime are queued in its backlog.
+// Implements the sd_listen_fds(3) protocol directly, since libsystemd is optional.
+static int32_t getInheritedSocket() {
+    int32_t listenPid = parseEnvInt("LISTEN_PID");
+    int32_t listenFds = parseEnvInt("LISTEN_FDS");
+
+    if(listenPid != getpid() || listenFds <= 0) {
+        return -1;
+    }
+
+    int32_t inheritedFd = -1;
+    for(int32_t fd = SD_LISTEN_FDS_START; fd < SD_LISTEN_FDS_START + listenFds; fd++) {
+        if(inheritedFd < 0 && isRestuneListenSocket(fd)) {
+            inheritedFd = fd;
+        }
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+    // Not to be inherited by any child processes
+    unsetenv("LISTEN_PID");
+    unsetenv("LISTEN_FDS");
+    unsetenv("LISTEN_FDNAMES");
+
+    return inheritedFd;
+}
+
+// Hand a copy of the listening socket over to systemd's fd store, so that it is passed
+// back via LISTEN_FDS (refer getInheritedSocket) if the Server is restarted.
+// Requires FileDescriptorStoreMax (and NotifyAccess) to be set for the service, the
+// notification is dropped otherwise.
+static void storeSocketWithSystemd(int32_t sockFd) {
+    const char* notifySocketPath = getenv("NOTIFY_SOCKET");
+    if(notifySocketPath == nullptr) return;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    size_t pathLen = strlen(notifySocketPath);
+    if(pathLen == 0 || pathLen >= UNIX_PATH_MAX ||
+       (notifySocketPath[0] != '/' && notifySocketPath[0] != '@')) {
+        return;
+    }
+
+    memcpy(addr.sun_path, notifySocketPath, pathLen);
+    if(addr.sun_path[0] == '@') {
+        // Abstract namespace
+        addr.sun_path[0] = '\0';
+    }
+
+    int32_t notifyFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if(notifyFd < 0) {
         TYPELOGV(ERRNO_LOG, "socket", strerror(errno));
-        LOGE("RESTUNE_SOCKET_SERVER", "Failed to initialize Server Socket");
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        return;
     }
 
-    // Make the socket Non-Blocking
-    if (fcntl(this->sockFd, F_SETFL, O_NONBLOCK) < 0) {
-        close(this->sockFd);
-        this->sockFd = -1;
-        LOGE("RESTUNE_SOCKET_SERVER", std::string("Failed to make socket non-blocking: ") + strerror(errno));
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    static const char state[] = "FDSTORE=1\nFDNAME=" RESTUNE_SOCKET_FD_NAME;
+    struct iovec iov;
+    iov.iov_base = (void*)state;
+    iov.iov_len = sizeof(state) - 1;
+
+    char control[CMSG_SPACE(sizeof(int32_t))];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addr;
+    msg.msg_namelen = offsetof(struct sockaddr_un, sun_path) + pathLen;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int32_t));
+    memcpy(CMSG_DATA(cmsg), &sockFd, sizeof(int32_t));
+
+    if(sendmsg(notifyFd, &msg, MSG_NOSIGNAL) < 0) {
+        TYPELOGV(ERRNO_LOG, "sendmsg", strerror(errno));
+    }
+    close(notifyFd);
+}
+
+static int32_t createListenSocket() {
+    int32_t sockFd = -1;
+    if((sockFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) {
+        TYPELOGV(ERRNO_LOG, "socket", strerror(errno));
+        LOGE("RESTUNE_SOCKET_SERVER", "Failed to initialize Server Socket");
+        return -1;
     }
 
     struct sockaddr_un addr;
@@ -38,34 +161,52 @@ int32_t SocketServer::ListenForClientRequests() {
     size_t written = snprintf(addr.sun_path, UNIX_PATH_MAX, RESTUNE_SOCKET_PATH);
     if(written >= UNIX_PATH_MAX) {
         LOGE("RESTUNE_SOCKET_SERVER", "Socket path too long");
-        close(this->sockFd);
-        this->sockFd = -1;
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        close(sockFd);
+        return -1;
     }
 
     // Remove old socket file
     unlink(addr.sun_path);
 
-    if(bind(this->sockFd, (const sockaddr*)&addr, sizeof(addr)) < 0) {
+    if(bind(sockFd, (const sockaddr*)&addr, sizeof(addr)) < 0) {
         TYPELOGV(ERRNO_LOG, "bind", strerror(errno));
-        close(this->sockFd);
-        this->sockFd = -1;
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        close(sockFd);
+        return -1;
     }
 
     // Set permissions for server
     mode_t perm = 0666;
     if(chmod(RESTUNE_SOCKET_PATH, perm) < 0) {
         TYPELOGV(ERRNO_LOG, "permission", strerror(errno));
-        close(this->sockFd);
-        this->sockFd = -1;
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        close(sockFd);
+        return -1;
     }
 
-    if(listen(this->sockFd, maxEvents) < 0) {
+    if(listen(sockFd, maxEvents) < 0) {
         TYPELOGV(ERRNO_LOG, "listen", strerror(errno));
+        close(sockFd);
+        return -1;
+    }
+
+    storeSocketWithSystemd(sockFd);
+    return sockFd;
+}
+
+// Called by server, this will put the server in listening mode
+int32_t SocketServer::ListenForClientRequests() {
+    this->sockFd = getInheritedSocket();
+    if(this->sockFd >= 0) {
+        LOGI("RESTUNE_SOCKET_SERVER", "Using the listening socket passed in by systemd");
+    } else if((this->sockFd = createListenSocket()) < 0) {
+        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    }
+
+    // Make the socket Non-Blocking
+    int32_t flags = fcntl(this->sockFd, F_GETFL);
+    if(flags < 0 || fcntl(this->sockFd, F_SETFL, flags | O_NONBLOCK) < 0) {
         close(this->sockFd);
         this->sockFd = -1;
+        LOGE("RESTUNE_SOCKET_SERVER", std::string("Failed to make socket non-blocking: ") + strerror(errno));
         return RC_SOCKET_CONN_NOT_INITIALIZED;
     }
 
@@ -88,6 +229,11 @@ int32_t SocketServer::ListenForClientRequests() {
         return RC_SOCKET_CONN_NOT_INITIALIZED;
     }
 
+    // The socket is bound and listening, Clients can connect from this point onwards.
+    if(this->mServerReadyCb != nullptr) {
+        this->mServerReadyCb(true);
+    }
+
     while(this->mServerOnlineCheckCb()) {
         int32_t clientsFdCount = epoll_wait(epollFd, events, maxEvents, 1000);
 
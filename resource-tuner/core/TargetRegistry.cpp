@@ -367,6 +367,33 @@ ClusterInfo* TargetRegistry::getClusterInfo(int32_t physicalClusterID) {
     return this->mPhysicalClusters[physicalClusterID];
 }
 
+int8_t TargetRegistry::isValidPhysicalId(int32_t physicalClusterId, int32_t physicalCoreId) {
+    int8_t clusterFound = false;
+    for(const std::pair<const int32_t, int32_t>& mapping: this->mLogicalToPhysicalClusterMapping) {
+        if(mapping.second == physicalClusterId) {
+            clusterFound = true;
+            break;
+        }
+    }
+
+    if(!clusterFound) {
+        return false;
+    }
+
+    // Homogeneous system, core IDs are not translated (refer getPhysicalCoreId).
+    if(physicalCoreId == 0 || this->mPhysicalClusters.size() == 0) {
+        return true;
+    }
+
+    auto it = this->mPhysicalClusters.find(physicalClusterId);
+    if(it == this->mPhysicalClusters.end() || it->second == nullptr) {
+        return false;
+    }
+
+    return (physicalCoreId >= it->second->mStartCpu &&
+            physicalCoreId < it->second->mStartCpu + it->second->mNumCpus);
+}
+
 void TargetRegistry::getCGroupNames(std::vector<std::string>& cGroupNames) {
     for(std::pair<int32_t, CGroupConfigInfo*> cGroup: this->mCGroupMapping) {
         cGroupNames.push_back(cGroup.second->mCgroupName);
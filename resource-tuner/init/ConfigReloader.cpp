@@ -0,0 +1,291 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+#include "ConfigReloader.h"
+#include "ConfigSnapshot.h"
+#include "RestuneParser.h"
+#include "AuxRoutines.h"
+
+#define CONFIG_RELOADER_TAG "RESTUNE_CONFIG_RELOADER"
+
+std::shared_ptr<ConfigReloader> ConfigReloader::mConfigReloaderInstance = nullptr;
+
+// Written to from the SIGHUP handler (and on stop), to wake up the watcher thread.
+static int32_t reloadEventFd = -1;
+static struct sigaction prevSighupAction;
+
+static void handleSIGHUP(int32_t sig) {
+    (void)sig;
+    uint64_t event = 1;
+    if(reloadEventFd >= 0) {
+        // write is async-signal-safe
+        (void)!write(reloadEventFd, &event, sizeof(event));
+    }
+}
+
+static std::string getParentDir(const std::string& filePath) {
+    size_t pos = filePath.find_last_of('/');
+    if(pos == std::string::npos) {
+        return ".";
+    }
+    return filePath.substr(0, pos);
+}
+
+ConfigReloader::ConfigReloader() {
+    this->mRestartOnlyKey = 0;
+    this->mInotifyFd = -1;
+    this->mStopWatcher.store(false);
+}
+
+uint64_t ConfigReloader::computeRestartOnlyKey() {
+    // Only the key is of interest here, the snapshot itself is never read or written.
+    ConfigSnapshot inputs("");
+    for(const std::string& filePath: this->mPaths.mRestartOnlyPaths) {
+        inputs.addInputFile(filePath);
+    }
+    return inputs.getKey();
+}
+
+int8_t ConfigReloader::isWatchedFile(const std::string& filePath) {
+    for(const std::vector<std::string>* paths: {&this->mPaths.mSignalConfigPaths,
+                                                &this->mPaths.mAppConfigPaths,
+                                                &this->mPaths.mPropertiesConfigPaths,
+                                                &this->mPaths.mRestartOnlyPaths}) {
+        for(const std::string& watchedPath: *paths) {
+            if(watchedPath == filePath) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+ErrCode ConfigReloader::reload() {
+    const std::lock_guard<std::mutex> lock(this->mReloadMutex);
+
+    uint64_t restartOnlyKey = this->computeRestartOnlyKey();
+    if(restartOnlyKey != this->mRestartOnlyKey) {
+        this->mRestartOnlyKey = restartOnlyKey;
+        LOGW(CONFIG_RELOADER_TAG,
+             "Resource / Init / Target / ExtFeature Config changes take effect after a restart");
+    }
+
+    // Build the new generations off to the side, the published ones keep serving Requests.
+    std::shared_ptr<SignalRegistry> signalRegistry = SignalRegistry::createGeneration();
+    std::shared_ptr<AppConfigs> appConfigs = AppConfigs::createGeneration();
+    std::shared_ptr<PropertiesRegistry> propertiesRegistry = PropertiesRegistry::createGeneration();
+    if(signalRegistry == nullptr || appConfigs == nullptr || propertiesRegistry == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    RestuneParser configProcessor;
+    configProcessor.setSignalRegistry(signalRegistry);
+    configProcessor.setAppConfigs(appConfigs);
+    configProcessor.setPropertiesRegistry(propertiesRegistry);
+
+    ErrCode opStatus = RC_SUCCESS;
+    for(size_t i = 0; i < this->mPaths.mSignalConfigPaths.size(); i++) {
+        const std::string& filePath = this->mPaths.mSignalConfigPaths[i];
+
+        // Common Signal Configs are mandatory, the rest of the layers are optional.
+        if(i > 0 && (filePath.length() == 0 || !AuxRoutines::fileExists(filePath))) {
+            continue;
+        }
+
+        opStatus = configProcessor.parse(ConfigType::SIGNALS_CONFIG, filePath);
+        if(RC_IS_NOTOK(opStatus)) {
+            LOGE(CONFIG_RELOADER_TAG, "Reload aborted, failed to parse: " + filePath);
+            return opStatus;
+        }
+    }
+
+    for(const std::string& filePath: this->mPaths.mAppConfigPaths) {
+        if(filePath.length() == 0 || !AuxRoutines::fileExists(filePath)) {
+            continue;
+        }
+
+        opStatus = configProcessor.parse(ConfigType::APP_CONFIG, filePath);
+        if(RC_IS_NOTOK(opStatus)) {
+            LOGE(CONFIG_RELOADER_TAG, "Reload aborted, failed to parse: " + filePath);
+            return opStatus;
+        }
+    }
+
+    for(size_t i = 0; i < this->mPaths.mPropertiesConfigPaths.size(); i++) {
+        const std::string& filePath = this->mPaths.mPropertiesConfigPaths[i];
+
+        // Same as the Signal Configs, the Common layer is mandatory.
+        if(i > 0 && (filePath.length() == 0 || !AuxRoutines::fileExists(filePath))) {
+            continue;
+        }
+
+        opStatus = configProcessor.parse(ConfigType::PROPERTIES_CONFIG, filePath);
+        if(RC_IS_NOTOK(opStatus)) {
+            LOGE(CONFIG_RELOADER_TAG, "Reload aborted, failed to parse: " + filePath);
+            return opStatus;
+        }
+    }
+
+    signalRegistry->buildLookupTable();
+
+    // The Ext Features themselves are only loaded at startup, but the Signals they subscribe
+    // to are re-mapped against the new Signal Configs.
+    std::shared_ptr<SignalExtFeatureMapper> extFeatureMapper =
+        ExtFeaturesRegistry::getInstance()->buildSignalMappings(signalRegistry);
+    if(extFeatureMapper == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    SignalRegistry::publish(signalRegistry);
+    SignalExtFeatureMapper::publish(extFeatureMapper);
+    AppConfigs::publish(appConfigs);
+    if(!this->mPaths.mPropertiesConfigPaths.empty()) {
+        PropertiesRegistry::publish(propertiesRegistry);
+    }
+
+    LOGI(CONFIG_RELOADER_TAG,
+         "Configs reloaded, " + std::to_string(signalRegistry->getSignalsConfigCount()) + " Signals active");
+
+    return RC_SUCCESS;
+}
+
+void ConfigReloader::watchConfigs() {
+    int8_t reloadPending = false;
+    char eventBuffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    while(!this->mStopWatcher.load()) {
+        struct pollfd fds[2];
+        fds[0].fd = this->mInotifyFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = reloadEventFd;
+        fds[1].events = POLLIN;
+
+        // While a reload is pending, wait for the files to settle: every new event
+        // restarts the debounce window.
+        int32_t ret = poll(fds, 2, reloadPending ? CONFIG_RELOAD_DEBOUNCE_MS : -1);
+        if(ret < 0) {
+            if(errno == EINTR) continue;
+            TYPELOGV(ERRNO_LOG, "poll", strerror(errno));
+            return;
+        }
+
+        if(ret == 0) {
+            reloadPending = false;
+            this->reload();
+            continue;
+        }
+
+        if(fds[1].revents & POLLIN) {
+            uint64_t events = 0;
+            (void)!read(reloadEventFd, &events, sizeof(events));
+            if(this->mStopWatcher.load()) {
+                return;
+            }
+
+            // SIGHUP, reload right away.
+            reloadPending = false;
+            this->reload();
+        }
+
+        if(fds[0].revents & POLLIN) {
+            ssize_t bytesRead = read(this->mInotifyFd, eventBuffer, sizeof(eventBuffer));
+            for(ssize_t offset = 0; offset < bytesRead;) {
+                const struct inotify_event* event = (const struct inotify_event*)(eventBuffer + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+
+                if(event->len == 0) continue;
+                auto it = this->mWatchedDirs.find(event->wd);
+                if(it == this->mWatchedDirs.end()) continue;
+
+                if(this->isWatchedFile(it->second + "/" + std::string(event->name))) {
+                    reloadPending = true;
+                }
+            }
+        }
+    }
+}
+
+ErrCode ConfigReloader::startConfigReloader(const ReloadConfigPaths& paths) {
+    this->mPaths = paths;
+    this->mRestartOnlyKey = this->computeRestartOnlyKey();
+    this->mStopWatcher.store(false);
+
+    reloadEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(reloadEventFd < 0) {
+        TYPELOGV(ERRNO_LOG, "eventfd", strerror(errno));
+        return RC_MODULE_INIT_FAILURE;
+    }
+
+    this->mInotifyFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if(this->mInotifyFd < 0) {
+        TYPELOGV(ERRNO_LOG, "inotify_init1", strerror(errno));
+    } else {
+        // Watch the parent directories, so that editors which replace files
+        // via rename are picked up as well.
+        for(const std::vector<std::string>* layerPaths: {&paths.mSignalConfigPaths,
+                                                         &paths.mAppConfigPaths,
+                                                         &paths.mPropertiesConfigPaths,
+                                                         &paths.mRestartOnlyPaths}) {
+            for(const std::string& filePath: *layerPaths) {
+                if(filePath.length() == 0) continue;
+
+                std::string dirPath = getParentDir(filePath);
+                int32_t wd = inotify_add_watch(this->mInotifyFd, dirPath.c_str(),
+                                               IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE);
+                if(wd >= 0) {
+                    this->mWatchedDirs[wd] = dirPath;
+                }
+            }
+        }
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSIGHUP;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGHUP, &action, &prevSighupAction);
+
+    try {
+        this->mWatcherThread = std::thread(&ConfigReloader::watchConfigs, this);
+    } catch(const std::system_error& e) {
+        TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "config-reloader", e.what());
+        this->stopConfigReloader();
+        return RC_MODULE_INIT_FAILURE;
+    }
+
+    return RC_SUCCESS;
+}
+
+void ConfigReloader::stopConfigReloader() {
+    this->mStopWatcher.store(true);
+
+    if(this->mWatcherThread.joinable()) {
+        uint64_t event = 1;
+        (void)!write(reloadEventFd, &event, sizeof(event));
+        this->mWatcherThread.join();
+    }
+
+    if(reloadEventFd >= 0) {
+        sigaction(SIGHUP, &prevSighupAction, nullptr);
+        close(reloadEventFd);
+        reloadEventFd = -1;
+    }
+
+    if(this->mInotifyFd >= 0) {
+        close(this->mInotifyFd);
+        this->mInotifyFd = -1;
+    }
+    this->mWatchedDirs.clear();
+}
+
+ConfigReloader::~ConfigReloader() {
+    this->stopConfigReloader();
+}
@@ -0,0 +1,519 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <cstring>
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ConfigSnapshot.h"
+#include "Logger.h"
+
+#define CONFIG_SNAPSHOT_MAGIC 0x534d5255 // "URMS"
+
+static const uint64_t fnvOffsetBasis = 0xcbf29ce484222325ULL;
+static const uint64_t fnvPrime = 0x100000001b3ULL;
+
+typedef struct {
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint64_t mKey;
+    uint64_t mPayloadSize;
+    uint64_t mPayloadHash;
+    uint32_t mResourceCount;
+    uint32_t mSignalCount;
+} SnapshotHeader;
+
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for(size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= fnvPrime;
+    }
+    return hash;
+}
+
+// Map a file read-only, returns nullptr for missing / empty files.
+static const uint8_t* mapFile(const std::string& filePath, size_t& size) {
+    size = 0;
+    int32_t fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) < 0 || fileStat.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* addr = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(addr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    size = fileStat.st_size;
+    return (const uint8_t*)addr;
+}
+
+class SnapshotWriter {
+private:
+    std::string mBuffer;
+
+public:
+    void write(const void* data, size_t size) {
+        this->mBuffer.append((const char*)data, size);
+    }
+
+    template <typename T>
+    void write(T value) {
+        this->write(&value, sizeof(T));
+    }
+
+    void write(const std::string& value) {
+        this->write<uint32_t>(value.size());
+        this->write(value.data(), value.size());
+    }
+
+    const std::string& getBuffer() const {
+        return this->mBuffer;
+    }
+};
+
+// Bounds-checked cursor over the mapped payload, once a read fails all the
+// subsequent reads fail as well, so callers only need to check at the end.
+class SnapshotReader {
+private:
+    const uint8_t* mCursor;
+    const uint8_t* mEnd;
+    int8_t mFailed;
+
+public:
+    SnapshotReader(const uint8_t* data, size_t size) {
+        this->mCursor = data;
+        this->mEnd = data + size;
+        this->mFailed = false;
+    }
+
+    int8_t read(void* data, size_t size) {
+        if(this->mFailed || (size_t)(this->mEnd - this->mCursor) < size) {
+            this->mFailed = true;
+            return false;
+        }
+
+        memcpy(data, this->mCursor, size);
+        this->mCursor += size;
+        return true;
+    }
+
+    template <typename T>
+    T read() {
+        T value{};
+        this->read(&value, sizeof(T));
+        return value;
+    }
+
+    std::string readString() {
+        uint32_t length = this->read<uint32_t>();
+        if(this->mFailed || (size_t)(this->mEnd - this->mCursor) < length) {
+            this->mFailed = true;
+            return "";
+        }
+
+        std::string value((const char*)this->mCursor, length);
+        this->mCursor += length;
+        return value;
+    }
+
+    // Element counts are validated against the bytes left, so that a corrupt
+    // count can never trigger an oversized allocation.
+    int32_t readCount(size_t minElemSize) {
+        int32_t count = this->read<int32_t>();
+        if(count < -1 || (count > 0 && (size_t)(this->mEnd - this->mCursor) / minElemSize < (size_t)count)) {
+            this->mFailed = true;
+            return 0;
+        }
+        return count;
+    }
+
+    int8_t hasFailed() const {
+        return this->mFailed;
+    }
+
+    int8_t isExhausted() const {
+        return this->mCursor == this->mEnd;
+    }
+};
+
+static void encodeResource(SnapshotWriter& writer, const ResConfInfo* resConf) {
+    writer.write(resConf->mResourceName);
+    writer.write(resConf->mResourcePath);
+    writer.write<uint8_t>(resConf->mResourceResType);
+    writer.write<uint16_t>(resConf->mResourceResID);
+    writer.write<int32_t>(resConf->mHighThreshold);
+    writer.write<int32_t>(resConf->mLowThreshold);
+    writer.write<int32_t>(resConf->mPermissions);
+    writer.write<uint8_t>(resConf->mModes);
+    writer.write<int32_t>(resConf->mApplyType);
+    writer.write<int32_t>(resConf->mPolicy);
+    writer.write<int32_t>(resConf->mUnit);
+}
+
+static ResConfInfo* decodeResource(SnapshotReader& reader) {
+    ResConfInfo* resConf = new(std::nothrow) ResConfInfo;
+    if(resConf == nullptr) {
+        return nullptr;
+    }
+
+    resConf->mResourceName = reader.readString();
+    resConf->mResourcePath = reader.readString();
+    resConf->mResourceResType = reader.read<uint8_t>();
+    resConf->mResourceResID = reader.read<uint16_t>();
+    resConf->mHighThreshold = reader.read<int32_t>();
+    resConf->mLowThreshold = reader.read<int32_t>();
+    resConf->mPermissions = (enum Permissions)reader.read<int32_t>();
+    resConf->mModes = reader.read<uint8_t>();
+    resConf->mApplyType = (enum ResourceApplyType)reader.read<int32_t>();
+    resConf->mPolicy = (enum Policy)reader.read<int32_t>();
+    resConf->mUnit = (enum TranslationUnit)reader.read<int32_t>();
+
+    // Callbacks are never persisted, they are re-derived on registration
+    // and by the Extension plugins.
+    resConf->mResourceApplierCallback = nullptr;
+    resConf->mResourceTearCallback = nullptr;
+
+    return resConf;
+}
+
+static void encodeSignal(SnapshotWriter& writer, const SignalInfo* signalInfo) {
+    writer.write<uint8_t>(signalInfo->mSignalCategory);
+    writer.write<uint16_t>(signalInfo->mSignalID);
+    writer.write<uint32_t>(signalInfo->mSigType);
+    writer.write(signalInfo->mSignalName);
+    writer.write<int32_t>(signalInfo->mTimeout);
+
+    // Lists are optional, -1 marks an absent list (as opposed to an empty one).
+    if(signalInfo->mPermissions == nullptr) {
+        writer.write<int32_t>(-1);
+    } else {
+        writer.write<int32_t>(signalInfo->mPermissions->size());
+        for(enum Permissions permission: *signalInfo->mPermissions) {
+            writer.write<int32_t>(permission);
+        }
+    }
+
+    if(signalInfo->mDerivatives == nullptr) {
+        writer.write<int32_t>(-1);
+    } else {
+        writer.write<int32_t>(signalInfo->mDerivatives->size());
+        for(const std::string& derivative: *signalInfo->mDerivatives) {
+            writer.write(derivative);
+        }
+    }
+
+    if(signalInfo->mSignalResources == nullptr) {
+        writer.write<int32_t>(-1);
+    } else {
+        writer.write<int32_t>(signalInfo->mSignalResources->size());
+        for(const Resource* resource: *signalInfo->mSignalResources) {
+            writer.write<uint32_t>(resource->getResCode());
+            writer.write<int32_t>(resource->getResInfo());
+            writer.write<int32_t>(resource->getOptionalInfo());
+            writer.write<int32_t>(resource->getValuesCount());
+            for(int32_t i = 0; i < resource->getValuesCount(); i++) {
+                writer.write<int32_t>(resource->getValueAt(i));
+            }
+        }
+    }
+}
+
+static void freeSignal(SignalInfo* signalInfo) {
+    if(signalInfo == nullptr) return;
+
+    delete signalInfo->mPermissions;
+    delete signalInfo->mDerivatives;
+
+    if(signalInfo->mSignalResources != nullptr) {
+        for(Resource* resource: *signalInfo->mSignalResources) {
+            delete resource;
+        }
+        delete signalInfo->mSignalResources;
+    }
+
+    delete signalInfo;
+}
+
+static SignalInfo* decodeSignal(SnapshotReader& reader) {
+    SignalInfo* signalInfo = new(std::nothrow) SignalInfo;
+    if(signalInfo == nullptr) {
+        return nullptr;
+    }
+
+    signalInfo->mPermissions = nullptr;
+    signalInfo->mDerivatives = nullptr;
+    signalInfo->mSignalResources = nullptr;
+
+    try {
+        signalInfo->mSignalCategory = reader.read<uint8_t>();
+        signalInfo->mSignalID = reader.read<uint16_t>();
+        signalInfo->mSigType = reader.read<uint32_t>();
+        signalInfo->mSignalName = reader.readString();
+        signalInfo->mTimeout = reader.read<int32_t>();
+
+        int32_t count = reader.readCount(sizeof(int32_t));
+        if(count >= 0) {
+            signalInfo->mPermissions = new std::vector<enum Permissions>();
+            for(int32_t i = 0; i < count; i++) {
+                signalInfo->mPermissions->push_back((enum Permissions)reader.read<int32_t>());
+            }
+        }
+
+        count = reader.readCount(sizeof(uint32_t));
+        if(count >= 0) {
+            signalInfo->mDerivatives = new std::vector<std::string>();
+            for(int32_t i = 0; i < count; i++) {
+                signalInfo->mDerivatives->push_back(reader.readString());
+            }
+        }
+
+        count = reader.readCount(4 * sizeof(int32_t));
+        if(count >= 0) {
+            signalInfo->mSignalResources = new std::vector<Resource*>();
+            for(int32_t i = 0; i < count && !reader.hasFailed(); i++) {
+                Resource* resource = new Resource;
+                signalInfo->mSignalResources->push_back(resource);
+
+                resource->setResCode(reader.read<uint32_t>());
+                resource->setResInfo(reader.read<int32_t>());
+                resource->setOptionalInfo(reader.read<int32_t>());
+
+                int32_t valuesCount = reader.readCount(sizeof(int32_t));
+                if(valuesCount < 0) valuesCount = 0;
+
+                resource->setNumValues(valuesCount);
+                for(int32_t j = 0; j < valuesCount; j++) {
+                    resource->setValueAt(j, reader.read<int32_t>());
+                }
+            }
+        }
+
+    } catch(const std::bad_alloc& e) {
+        freeSignal(signalInfo);
+        return nullptr;
+    }
+
+    return signalInfo;
+}
+
+ConfigSnapshot::ConfigSnapshot(const std::string& snapshotPath) {
+    this->mSnapshotPath = snapshotPath;
+    this->mKey = fnvOffsetBasis;
+
+    uint32_t version = CONFIG_SNAPSHOT_VERSION;
+    this->mKey = hashBytes(this->mKey, &version, sizeof(version));
+}
+
+void ConfigSnapshot::addInputFile(const std::string& filePath) {
+    if(filePath.length() == 0) return;
+
+    // Hash the path as well, the same contents supplied through a different
+    // layer can lead to a different merge result.
+    this->addInputKey(filePath);
+
+    size_t size = 0;
+    const uint8_t* data = mapFile(filePath, size);
+
+    uint64_t contentHash = fnvOffsetBasis;
+    if(data != nullptr) {
+        contentHash = hashBytes(contentHash, data, size);
+        munmap((void*)data, size);
+    }
+
+    this->mKey = hashBytes(this->mKey, &size, sizeof(size));
+    this->mKey = hashBytes(this->mKey, &contentHash, sizeof(contentHash));
+}
+
+void ConfigSnapshot::addInputKey(const std::string& key) {
+    uint32_t length = key.size();
+    this->mKey = hashBytes(this->mKey, &length, sizeof(length));
+    this->mKey = hashBytes(this->mKey, key.data(), key.size());
+}
+
+void ConfigSnapshot::addInputNode(const std::string& nodePath) {
+    if(nodePath.length() == 0) return;
+
+    this->addInputKey(nodePath);
+
+    size_t wildcard = nodePath.find('*');
+    if(wildcard == std::string::npos) {
+        int8_t exists = (access(nodePath.c_str(), F_OK) == 0);
+        this->mKey = hashBytes(this->mKey, &exists, sizeof(exists));
+        return;
+    }
+
+    // Same directory as ResourceConfigInfoBuilder::setPath matches the wildcard against.
+    std::vector<std::string> entries;
+    DIR* dir = opendir(nodePath.substr(0, wildcard).c_str());
+    if(dir != nullptr) {
+        struct dirent* entry;
+        while((entry = readdir(dir)) != nullptr) {
+            entries.push_back(entry->d_name);
+        }
+        closedir(dir);
+    }
+
+    // readdir order is not stable across boots.
+    std::sort(entries.begin(), entries.end());
+    for(const std::string& entry: entries) {
+        this->addInputKey(entry);
+    }
+}
+
+uint64_t ConfigSnapshot::getKey() const {
+    return this->mKey;
+}
+
+ErrCode ConfigSnapshot::load(std::vector<ResConfInfo*>& resources, std::vector<SignalInfo*>& signals) {
+    size_t size = 0;
+    const uint8_t* data = mapFile(this->mSnapshotPath, size);
+    if(data == nullptr) {
+        return RC_FILE_NOT_FOUND;
+    }
+
+    SnapshotHeader header;
+    if(size < sizeof(header)) {
+        munmap((void*)data, size);
+        return RC_INVALID_VALUE;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    if(header.mMagic != CONFIG_SNAPSHOT_MAGIC ||
+       header.mVersion != CONFIG_SNAPSHOT_VERSION ||
+       header.mKey != this->mKey) {
+        munmap((void*)data, size);
+        return RC_FILE_NOT_FOUND;
+    }
+
+    const uint8_t* payload = data + sizeof(header);
+    size_t payloadSize = size - sizeof(header);
+    if(header.mPayloadSize != payloadSize ||
+       header.mPayloadHash != hashBytes(fnvOffsetBasis, payload, payloadSize)) {
+        munmap((void*)data, size);
+        return RC_INVALID_VALUE;
+    }
+
+    std::vector<ResConfInfo*> decodedResources;
+    std::vector<SignalInfo*> decodedSignals;
+    SnapshotReader reader(payload, payloadSize);
+
+    int8_t decodeFailed = false;
+    for(uint32_t i = 0; i < header.mResourceCount && !decodeFailed; i++) {
+        ResConfInfo* resConf = decodeResource(reader);
+        if(resConf == nullptr) {
+            decodeFailed = true;
+            break;
+        }
+        decodedResources.push_back(resConf);
+        decodeFailed = reader.hasFailed();
+    }
+
+    for(uint32_t i = 0; i < header.mSignalCount && !decodeFailed; i++) {
+        SignalInfo* signalInfo = decodeSignal(reader);
+        if(signalInfo == nullptr) {
+            decodeFailed = true;
+            break;
+        }
+        decodedSignals.push_back(signalInfo);
+        decodeFailed = reader.hasFailed();
+    }
+
+    munmap((void*)data, size);
+
+    if(decodeFailed || !reader.isExhausted()) {
+        for(ResConfInfo* resConf: decodedResources) {
+            delete resConf;
+        }
+        for(SignalInfo* signalInfo: decodedSignals) {
+            freeSignal(signalInfo);
+        }
+        return RC_INVALID_VALUE;
+    }
+
+    resources.insert(resources.end(), decodedResources.begin(), decodedResources.end());
+    signals.insert(signals.end(), decodedSignals.begin(), decodedSignals.end());
+
+    return RC_SUCCESS;
+}
+
+ErrCode ConfigSnapshot::store(const std::vector<ResConfInfo*>& resources,
+                              const std::vector<SignalInfo*>& signals) {
+    SnapshotWriter writer;
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+
+    try {
+        for(const ResConfInfo* resConf: resources) {
+            if(resConf == nullptr) continue;
+            encodeResource(writer, resConf);
+            header.mResourceCount++;
+        }
+
+        for(const SignalInfo* signalInfo: signals) {
+            if(signalInfo == nullptr) continue;
+            encodeSignal(writer, signalInfo);
+            header.mSignalCount++;
+        }
+
+    } catch(const std::bad_alloc& e) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    const std::string& payload = writer.getBuffer();
+    header.mMagic = CONFIG_SNAPSHOT_MAGIC;
+    header.mVersion = CONFIG_SNAPSHOT_VERSION;
+    header.mKey = this->mKey;
+    header.mPayloadSize = payload.size();
+    header.mPayloadHash = hashBytes(fnvOffsetBasis, payload.data(), payload.size());
+
+    std::string tmpPath = this->mSnapshotPath + ".tmp";
+    int32_t fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd < 0) {
+        TYPELOGV(ERRNO_LOG, "open", strerror(errno));
+        return RC_FILE_NOT_FOUND;
+    }
+
+    int8_t writeFailed = false;
+    if(write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+        writeFailed = true;
+    }
+
+    size_t written = 0;
+    while(!writeFailed && written < payload.size()) {
+        ssize_t ret = write(fd, payload.data() + written, payload.size() - written);
+        if(ret < 0) {
+            if(errno == EINTR) continue;
+            writeFailed = true;
+            break;
+        }
+        written += ret;
+    }
+
+    if(!writeFailed && fsync(fd) < 0) {
+        writeFailed = true;
+    }
+
+    close(fd);
+
+    if(writeFailed || rename(tmpPath.c_str(), this->mSnapshotPath.c_str()) < 0) {
+        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+        unlink(tmpPath.c_str());
+        return RC_FILE_NOT_FOUND;
+    }
+
+    return RC_SUCCESS;
+}
@@ -0,0 +1,119 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+/*!
+ * \file  ConfigReloader.h
+ */
+
+/*!
+ * \ingroup  CONFIG_RELOADER
+ * \defgroup CONFIG_RELOADER Config Reloader
+ * \details Applies Config changes to a running Server, without a restart.
+ *
+ *          Reload Flow:\n\n
+ *          1) A watcher thread tracks the Config directories via inotify. Once the watched files
+ *             have stopped changing (debounced), or on SIGHUP, a reload is triggered.\n\n
+ *          2) New generations of the SignalRegistry, AppConfigs and PropertiesRegistry are built
+ *             on the watcher thread, by parsing all the layers (Common -> Target-Specific -> Custom)
+ *             afresh. The published generations keep serving Requests in the meantime.\n\n
+ *          3) If all the layers parse successfully, the new generations are published atomically.
+ *             Readers which still hold the previous generation keep using it until they are done,
+ *             after which it is freed (RCU-style). On any failure, the current generations are
+ *             left untouched.\n\n
+ *          4) Property queries see the reloaded values right away. Properties which the Server
+ *             reads into its settings at startup (for ex. the thread pool and rate limiter
+ *             tunables) keep their startup values until a restart.\n\n
+ *          5) Resource, Init, Target and ExtFeature Configs shape the CocoTable layout, the
+ *             captured Resource defaults and the cgroup setup, hence these are not swapped at
+ *             runtime. Changes to them are detected and reported as requiring a restart. Since the
+ *             Resources never change underneath, all the active CocoTable Requests carry over
+ *             across a reload as-is.\n
+ *
+ * @{
+ */
+
+#ifndef CONFIG_RELOADER_H
+#define CONFIG_RELOADER_H
+
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ErrCodes.h"
+#include "Logger.h"
+
+#define CONFIG_RELOAD_DEBOUNCE_MS 500
+
+typedef struct {
+    /**
+     * @brief Signal Config layers, in merge order. The first entry (Common) is mandatory.
+     */
+    std::vector<std::string> mSignalConfigPaths;
+    /**
+     * @brief Per-App Config layers, in merge order. All of them are optional.
+     */
+    std::vector<std::string> mAppConfigPaths;
+    /**
+     * @brief Properties Config layers, in merge order. If given, the first entry (Common) is mandatory.
+     */
+    std::vector<std::string> mPropertiesConfigPaths;
+    /**
+     * @brief Configs which are only consumed at startup, changes to these are reported.
+     */
+    std::vector<std::string> mRestartOnlyPaths;
+} ReloadConfigPaths;
+
+class ConfigReloader {
+private:
+    static std::shared_ptr<ConfigReloader> mConfigReloaderInstance;
+
+    ReloadConfigPaths mPaths;
+    uint64_t mRestartOnlyKey;
+    int32_t mInotifyFd;
+    std::unordered_map<int32_t, std::string> mWatchedDirs;
+    std::thread mWatcherThread;
+    std::atomic<int8_t> mStopWatcher;
+    std::mutex mReloadMutex;
+
+    ConfigReloader();
+
+    void watchConfigs();
+    int8_t isWatchedFile(const std::string& filePath);
+    uint64_t computeRestartOnlyKey();
+
+public:
+    ~ConfigReloader();
+
+    /**
+     * @brief Start watching the given Configs for changes.
+     * @details Also installs a SIGHUP handler, which triggers a reload.
+     * @return ErrCode:\n
+     *            - RC_SUCCESS If the watcher was successfully started\n
+     *            - Enum Code indicating error: Otherwise.
+     */
+    ErrCode startConfigReloader(const ReloadConfigPaths& paths);
+    void stopConfigReloader();
+
+    /**
+     * @brief Rebuild and publish the reloadable Registries, synchronously.
+     * @return ErrCode:\n
+     *            - RC_SUCCESS If the new generations were published\n
+     *            - Enum Code indicating error: Otherwise, the current generations are retained.
+     */
+    ErrCode reload();
+
+    static std::shared_ptr<ConfigReloader> getInstance() {
+        if(mConfigReloaderInstance == nullptr) {
+            mConfigReloaderInstance = std::shared_ptr<ConfigReloader>(new ConfigReloader());
+        }
+        return mConfigReloaderInstance;
+    }
+};
+
+#endif
+
+/*! @} */
@@ -0,0 +1,83 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ErrCodes.h"
+#include "ResourceRegistry.h"
+#include "SignalRegistry.h"
+
+/**
+ * @brief Bump whenever the on-disk record layout changes, older snapshots are then
+ *        treated as stale and the YAML configs are parsed afresh.
+ */
+#define CONFIG_SNAPSHOT_VERSION 1
+
+/**
+ * @brief ConfigSnapshot
+ * @details Binary image of the merged Resource and Signal registries, used to skip the
+ *          YAML parsing at startup when none of the inputs have changed.\n
+ *          The snapshot is keyed by a hash over the contents of every input Config file
+ *          (including files which are absent, so that adding a new layer invalidates it),
+ *          along with any additional keys registered by the caller (for ex. the target name).
+ *          On load the file is mmap'd, the key and payload checksum are verified, and the
+ *          records are decoded in a single pass. Any mismatch or corruption is reported as
+ *          a failure, so that the caller can fall back to regular parsing.
+ */
+class ConfigSnapshot {
+private:
+    std::string mSnapshotPath;
+    uint64_t mKey;
+
+public:
+    ConfigSnapshot(const std::string& snapshotPath);
+
+    /**
+     * @brief Mix the path and contents of an input Config file into the snapshot key.
+     * @details Empty paths are ignored, missing files are recorded as such.
+     */
+    void addInputFile(const std::string& filePath);
+
+    /**
+     * @brief Mix an arbitrary string into the snapshot key.
+     */
+    void addInputKey(const std::string& key);
+
+    /**
+     * @brief Mix the presence of a Resource node into the snapshot key.
+     * @details Resources are registered based on which nodes exist on the device, hence a
+     *          node showing up later (for ex. a driver loaded after the snapshot was taken)
+     *          must invalidate it. For wildcard paths, the entries of the directory which
+     *          the wildcard is matched against are mixed in instead.
+     */
+    void addInputNode(const std::string& nodePath);
+
+    uint64_t getKey() const;
+
+    /**
+     * @brief Load the snapshot if it matches the current inputs.
+     * @details On success the decoded configs are handed over to the caller, who takes
+     *          ownership of them (typically by registering them with the Registries).
+     * @param resources Filled with the Resource configs, in registration order.
+     * @param signals Filled with the Signal configs, in registration order.
+     * @return ErrCode:\n
+     *            - RC_SUCCESS: If the snapshot was found, valid and up to date
+     *            - RC_FILE_NOT_FOUND: If the snapshot is absent or stale
+     *            - RC_INVALID_VALUE: If the snapshot is corrupt
+     */
+    ErrCode load(std::vector<ResConfInfo*>& resources, std::vector<SignalInfo*>& signals);
+
+    /**
+     * @brief Write the given configs to the snapshot, keyed by the current inputs.
+     * @details The file is written to a temporary location and renamed into place,
+     *          so a crash never leaves a partially written snapshot behind.
+     */
+    ErrCode store(const std::vector<ResConfInfo*>& resources, const std::vector<SignalInfo*>& signals);
+};
+
+#endif
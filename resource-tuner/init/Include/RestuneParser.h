@@ -308,6 +308,10 @@
  */
 class RestuneParser {
 private:
+    std::shared_ptr<SignalRegistry> mSignalRegistry;
+    std::shared_ptr<AppConfigs> mAppConfigs;
+    std::shared_ptr<PropertiesRegistry> mPropertiesRegistry;
+
     ErrCode parseResourceConfigYamlNode(const std::string& filePath);
     ErrCode parsePropertiesConfigYamlNode(const std::string& filePath);
     ErrCode parseInitConfigYamlNode(const std::string& filePath);
@@ -317,6 +321,30 @@ private:
     ErrCode parsePerAppConfigYamlNode(const std::string& filePath);
 
 public:
+    /**
+     * @brief Register the parsed Signal Configs with the given Registry generation,
+     *        instead of the currently published one.
+     */
+    void setSignalRegistry(std::shared_ptr<SignalRegistry> signalRegistry);
+
+    /**
+     * @brief Register the parsed Per-App Configs with the given generation,
+     *        instead of the currently published one.
+     */
+    void setAppConfigs(std::shared_ptr<AppConfigs> appConfigs);
+
+    /**
+     * @brief Register the parsed Properties with the given generation,
+     *        instead of the currently published one.
+     */
+    void setPropertiesRegistry(std::shared_ptr<PropertiesRegistry> propertiesRegistry);
+
+    /**
+     * @brief Collect the node paths (ResourcePath) listed in a Resource Config file.
+     * @details Whether these exist on the device decides which Resources get registered.
+     */
+    static ErrCode getResourceNodePaths(const std::string& filePath, std::vector<std::string>& nodePaths);
+
     ErrCode parseResourceConfigs(const std::string& filePath);
     ErrCode parsePropertiesConfigs(const std::string& filePath);
     ErrCode parseInitConfigs(const std::string& filePath);
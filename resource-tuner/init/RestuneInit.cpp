@@ -6,6 +6,10 @@
 #include <string>
 #include <thread>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <sys/stat.h>
+#include <sys/utsname.h>
 
 #include "Config.h"
 #include "ErrCodes.h"
@@ -21,21 +25,150 @@
 #include "UrmSettings.h"
 #include "SignalRegistry.h"
 #include "RestuneParser.h"
+#include "ConfigSnapshot.h"
+#include "ConfigReloader.h"
 
 #define MAX_EXTENSION_LIB_HANDLES 6
+#define THREAD_READINESS_TIMEOUT_MS 5000
+
 static void** extensionLibHandles = nullptr;
 
 // Request Listener and Handler Threads
 static std::thread restuneHandlerThread;
 static std::thread resourceTunerListener;
 
+// Used by the Handler and Listener Threads to report back once they are up
+typedef struct {
+    std::mutex mReadinessMutex;
+    std::condition_variable mReadinessCond;
+    int8_t mSignalled;
+    int8_t mReady;
+} ThreadReadiness;
+
+static ThreadReadiness handlerReadiness;
+static ThreadReadiness listenerReadiness;
+
+// The originals journal left behind by the previous run is kept until it has been replayed.
+static int8_t defaultsJournalReplayed = false;
+
+// Only the first report counts, so that a thread exiting after coming
+// up successfully does not overwrite its readiness.
+static void signalReadiness(ThreadReadiness& readiness, int8_t isReady) {
+    const std::lock_guard<std::mutex> lock(readiness.mReadinessMutex);
+    if(!readiness.mSignalled) {
+        readiness.mSignalled = true;
+        readiness.mReady = isReady;
+    }
+    readiness.mReadinessCond.notify_all();
+}
+
+static int8_t waitForReadiness(ThreadReadiness& readiness) {
+    std::unique_lock<std::mutex> lock(readiness.mReadinessMutex);
+    readiness.mReadinessCond.wait_for(lock,
+                                      std::chrono::milliseconds(THREAD_READINESS_TIMEOUT_MS),
+                                      [&readiness] {return readiness.mSignalled;});
+    return readiness.mSignalled && readiness.mReady;
+}
+
+static void onListenerReady(int8_t isReady) {
+    signalReadiness(listenerReadiness, isReady);
+}
+
+// Only the nodes journaled by the previous run, i.e. the ones it actually modified, are restored.
+// Needs the Resource Configs, since only the nodes of registered Resources are restored.
 static void restoreToSafeState() {
     if(AuxRoutines::fileExists(UrmSettings::mPersistenceFile)) {
-        AuxRoutines::writeSysFsDefaults();
+        std::vector<std::pair<std::string, std::string>> journaledDefaults;
+        if(RC_IS_OK(DefaultsJournal::replay(UrmSettings::mPersistenceFile, journaledDefaults))) {
+            uint32_t restoredCount = 0;
+            for(std::pair<std::string, std::string>& nodeDefault: journaledDefaults) {
+                // Skip anything which is not a Resource node (for ex. a task's cgroup
+                // under /proc/<pid>, the pid might since have been recycled).
+                if(!ResourceRegistry::getInstance()->isResourceNodePath(nodeDefault.first)) {
+                    continue;
+                }
+                AuxRoutines::writeToFile(nodeDefault.first, nodeDefault.second);
+                restoredCount++;
+            }
+
+            LOGI("RESTUNE_SERVER_INIT",
+                 "Restored " + std::to_string(restoredCount) + " nodes from the journal");
+        } else {
+            LOGE("RESTUNE_SERVER_INIT",
+                 "Failed to read sysfs original values journal: " + UrmSettings::mPersistenceFile);
+        }
 
         // Delete the Node Persistence File
         AuxRoutines::deleteFile(UrmSettings::mPersistenceFile);
     }
+    defaultsJournalReplayed = true;
+}
+
+// Re-apply the Requests which were active when the Server went down, with their original handles.
+// Requests whose client has since exited (or whose tid now belongs to another thread), whose
+// expiry has passed, or which no longer pass verification against the current configs are dropped.
+static void replayActiveRequests() {
+    std::vector<JournaledRequest> journaledRequests;
+    ErrCode opStatus = RequestJournal::replay(UrmSettings::mRequestJournalPath, journaledRequests);
+    if(RC_IS_NOTOK(opStatus) && opStatus != RC_FILE_NOT_FOUND) {
+        LOGE("RESTUNE_SERVER_INIT", "Failed to read the active Requests journal");
+    }
+
+    // Handles issued by the previous instance must not be reissued.
+    for(JournaledRequest& journaledRequest: journaledRequests) {
+        AuxRoutines::reserveHandle(journaledRequest.mHandle);
+    }
+
+    // Replaces the journal read above, the replayed Requests are journaled afresh once applied.
+    if(RC_IS_NOTOK(RequestManager::getInstance()->openRequestJournal(UrmSettings::mRequestJournalPath))) {
+        LOGW("RESTUNE_SERVER_INIT", "Failed to create the active Requests journal");
+    }
+
+    int64_t now = AuxRoutines::getMonotonicTimeInMilliseconds();
+    int32_t replayedCount = 0;
+
+    for(JournaledRequest& journaledRequest: journaledRequests) {
+        if(journaledRequest.mExpiry != -1 && journaledRequest.mExpiry <= now) {
+            continue;
+        }
+
+        Request* request = nullptr;
+        try {
+            request = MPLACED(Request);
+        } catch(const std::bad_alloc& e) {
+            TYPELOGV(REQUEST_MEMORY_ALLOCATION_FAILURE, e.what());
+            break;
+        }
+
+        if(RC_IS_NOTOK(request->deserialize(journaledRequest.mRequestData.data())) ||
+           request->getRequestType() != REQ_RESOURCE_TUNING ||
+           request->getHandle() != journaledRequest.mHandle) {
+            Request::cleanUpRequest(request);
+            continue;
+        }
+
+        int64_t clientStartTime = -1;
+        if(journaledRequest.mClientStartTime == -1 ||
+           !AuxRoutines::getTaskStartTime(request->getClientPID(), request->getClientTID(), clientStartTime) ||
+           clientStartTime != journaledRequest.mClientStartTime) {
+            Request::cleanUpRequest(request);
+            continue;
+        }
+
+        if(journaledRequest.mExpiry != -1) {
+            request->setDuration(journaledRequest.mExpiry - now);
+        }
+
+        if(resubmitResProvisionRequest(request)) {
+            replayedCount++;
+        }
+    }
+
+    if(journaledRequests.size() > 0) {
+        LOGI("RESTUNE_SERVER_INIT",
+             "Replayed " + std::to_string(replayedCount) + " of " +
+             std::to_string(journaledRequests.size()) + " journaled Requests");
+    }
 }
 
 // Load the Extensions Plugin lib if it is available
@@ -196,11 +329,11 @@ static ErrCode fetchMetaConfigs() {
 
 static ErrCode parseUtil(const std::string& filePath,
                          const std::string& desc,
-                         ConfigType configType) {
+                         ConfigType configType,
+                         RestuneParser& configProcessor) {
 
     if(filePath.length() == 0) return RC_FILE_NOT_FOUND;
     ErrCode opStatus = RC_SUCCESS;
-    RestuneParser configProcessor;
 
     TYPELOGV(NOTIFY_PARSING_START, desc.c_str(), filePath.c_str());
     opStatus = configProcessor.parse(configType, filePath);
@@ -214,6 +347,13 @@ static ErrCode parseUtil(const std::string& filePath,
     return opStatus;
 }
 
+static ErrCode parseUtil(const std::string& filePath,
+                         const std::string& desc,
+                         ConfigType configType) {
+    RestuneParser configProcessor;
+    return parseUtil(filePath, desc, configType, configProcessor);
+}
+
 static std::string getFullTargetBasedConfPath(const std::string& configFileName) {
     if(UrmSettings::targetConfigs.targetName.length() == 0) {
         return "";
@@ -373,6 +513,71 @@ static ErrCode fetchSignals() {
     return opStatus;
 }
 
+// The snapshot is keyed by every layer which can contribute Resource or Signal Configs,
+// along with the target and kernel release, since Resource paths are resolved against
+// the sysfs layout and Configs can be enabled / disabled per target.
+static void addConfigSnapshotInputs(ConfigSnapshot& configSnapshot) {
+    std::string inputPaths[10] = {
+        UrmSettings::mCommonResourcesPath,
+        UrmSettings::mDevIndexedResourcesPath,
+        getFullTargetBasedConfPath("ResourcesConfig.yaml"),
+        UrmSettings::mCustomResourcesPath,
+        Extensions::getResourceConfigFilePath(),
+        UrmSettings::mCommonSignalsPath,
+        UrmSettings::mDevIndexedSignalsPath,
+        getFullTargetBasedConfPath("SignalsConfig.yaml"),
+        UrmSettings::mCustomSignalsPath,
+        Extensions::getSignalsConfigFilePath(),
+    };
+
+    for(int32_t i = 0; i < 10; i++) {
+        configSnapshot.addInputFile(inputPaths[i]);
+    }
+
+    // Resource Config files are only registered if their nodes exist on the device.
+    for(int32_t i = 0; i < 5; i++) {
+        std::vector<std::string> nodePaths;
+        if(inputPaths[i].length() > 0 && AuxRoutines::fileExists(inputPaths[i])) {
+            RestuneParser::getResourceNodePaths(inputPaths[i], nodePaths);
+        }
+        for(const std::string& nodePath: nodePaths) {
+            configSnapshot.addInputNode(nodePath);
+        }
+    }
+
+    configSnapshot.addInputKey(UrmSettings::targetConfigs.targetName);
+
+    struct utsname unameInfo;
+    if(uname(&unameInfo) == 0) {
+        configSnapshot.addInputKey(unameInfo.release);
+    }
+}
+
+// Register the Resource and Signal Configs from the snapshot, if it is up to date.
+static ErrCode loadConfigSnapshot(ConfigSnapshot& configSnapshot) {
+    std::vector<ResConfInfo*> resources;
+    std::vector<SignalInfo*> signals;
+
+    ErrCode opStatus = configSnapshot.load(resources, signals);
+    if(RC_IS_NOTOK(opStatus)) {
+        return opStatus;
+    }
+
+    for(ResConfInfo* resConf: resources) {
+        ResourceRegistry::getInstance()->registerResource(resConf);
+    }
+
+    for(SignalInfo* signalInfo: signals) {
+        SignalRegistry::getInstance()->registerSignal(signalInfo);
+    }
+
+    LOGI("RESTUNE_CONFIG_SNAPSHOT",
+         "Loaded " + std::to_string(resources.size()) + " Resources and " +
+         std::to_string(signals.size()) + " Signals from the Config snapshot");
+
+    return RC_SUCCESS;
+}
+
 // Since this is a Custom (Optional) Config, hence if the expected Config file is
 // not found, we simply return Success.
 static ErrCode fetchExtFeatureConfigs() {
@@ -398,8 +603,17 @@ static ErrCode fetchExtFeatureConfigs() {
     return opStatus;
 }
 
+// The Per-App Configs are parsed into a new generation, which is published once complete,
+// since the Classifier may already be looking them up.
 static ErrCode fetchPerAppConfigs() {
     ErrCode opStatus = RC_SUCCESS;
+    std::shared_ptr<AppConfigs> appConfigs = AppConfigs::createGeneration();
+    if(appConfigs == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    RestuneParser configProcessor;
+    configProcessor.setAppConfigs(appConfigs);
 
     std::string customConfPaths[4] = {
         UrmSettings::mDevIndexedAppPath,
@@ -411,16 +625,129 @@ static ErrCode fetchPerAppConfigs() {
     for(int32_t i = 0; i < 4; i++) {
         std::string filePath = customConfPaths[i];
         if(filePath.length() > 0 && AuxRoutines::fileExists(filePath)) {
-            opStatus = parseUtil(filePath, "app-config-custom", ConfigType::APP_CONFIG);
+            opStatus = parseUtil(filePath, "app-config-custom", ConfigType::APP_CONFIG, configProcessor);
             if(RC_IS_NOTOK(opStatus)) {
                 return opStatus;
             }
         }
     }
 
+    AppConfigs::publish(appConfigs);
     return opStatus;
 }
 
+// Signal, Per-App and Properties Configs are reloaded at runtime, the remaining layers are
+// only consumed at startup and are watched so that changes to them can be reported.
+static ErrCode startConfigReloader() {
+    ReloadConfigPaths reloadPaths;
+    reloadPaths.mSignalConfigPaths = {
+        UrmSettings::mCommonSignalsPath,
+        UrmSettings::mDevIndexedSignalsPath,
+        getFullTargetBasedConfPath("SignalsConfig.yaml"),
+        UrmSettings::mCustomSignalsPath,
+        Extensions::getSignalsConfigFilePath(),
+    };
+
+    reloadPaths.mAppConfigPaths = {
+        UrmSettings::mDevIndexedAppPath,
+        getFullTargetBasedConfPath("PerApp.yaml"),
+        UrmSettings::mCustomAppConfigPath,
+        Extensions::getAppConfigFilePath(),
+    };
+
+    reloadPaths.mPropertiesConfigPaths = {
+        UrmSettings::mCommonPropertiesPath,
+        UrmSettings::mDevIndexedPropertiesPath,
+        getFullTargetBasedConfPath("PropertiesConfig.yaml"),
+        UrmSettings::mCustomPropertiesPath,
+        Extensions::getPropertiesConfigFilePath(),
+    };
+
+    reloadPaths.mRestartOnlyPaths = {
+        UrmSettings::mCommonResourcesPath,
+        UrmSettings::mDevIndexedResourcesPath,
+        getFullTargetBasedConfPath("ResourcesConfig.yaml"),
+        UrmSettings::mCustomResourcesPath,
+        Extensions::getResourceConfigFilePath(),
+        UrmSettings::mCommonInitPath,
+        UrmSettings::mDevIndexedInitPath,
+        getFullTargetBasedConfPath("InitConfig.yaml"),
+        UrmSettings::mCustomInitPath,
+        Extensions::getInitConfigFilePath(),
+        UrmSettings::mDevIndexedTargetPath,
+        getFullTargetBasedConfPath("TargetConfig.yaml"),
+        UrmSettings::mCustomTargetPath,
+        Extensions::getTargetConfigFilePath(),
+        UrmSettings::mDevIndexedExtFeatPath,
+        getFullTargetBasedConfPath("ExtFeaturesConfig.yaml"),
+        UrmSettings::mCustomExtFeaturesPath,
+        Extensions::getExtFeaturesConfigFilePath(),
+    };
+
+    return ConfigReloader::getInstance()->startConfigReloader(reloadPaths);
+}
+
+typedef ErrCode (*ConfigFetchRoutine)();
+
+// Tracks a batch of Config families being parsed concurrently on the Request ThreadPool.
+typedef struct {
+    std::mutex mBatchMutex;
+    std::condition_variable mBatchCond;
+    int32_t mPending;
+} ConfigFetchBatch;
+
+typedef struct {
+    ConfigFetchRoutine mFetchRoutine;
+    ErrCode mStatus;
+    ConfigFetchBatch* mBatch;
+} ConfigFetchTask;
+
+static void runConfigFetchTask(void* arg) {
+    ConfigFetchTask* task = (ConfigFetchTask*)arg;
+    task->mStatus = task->mFetchRoutine();
+
+    const std::lock_guard<std::mutex> lock(task->mBatch->mBatchMutex);
+    task->mBatch->mPending--;
+    task->mBatch->mBatchCond.notify_one();
+}
+
+// Each routine parses all the layers (Common -> Target-Specific -> Custom) of a single Config
+// family in order, so the override semantics are unchanged, while independent families, each
+// feeding a separate registry, are parsed in parallel. If a task cannot be handed over to the
+// ThreadPool, it is run inline instead.
+static ErrCode fetchConcurrently(const std::vector<ConfigFetchRoutine>& fetchRoutines) {
+    ConfigFetchBatch batch;
+    batch.mPending = 0;
+
+    std::vector<ConfigFetchTask> tasks(fetchRoutines.size());
+    for(size_t i = 0; i < fetchRoutines.size(); i++) {
+        tasks[i].mFetchRoutine = fetchRoutines[i];
+        tasks[i].mStatus = RC_SUCCESS;
+        tasks[i].mBatch = &batch;
+
+        {
+            const std::lock_guard<std::mutex> lock(batch.mBatchMutex);
+            batch.mPending++;
+        }
+
+        if(RequestReceiver::mRequestsThreadPool == nullptr ||
+           !RequestReceiver::mRequestsThreadPool->enqueueTask(runConfigFetchTask, &tasks[i])) {
+            runConfigFetchTask(&tasks[i]);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(batch.mBatchMutex);
+    batch.mBatchCond.wait(lock, [&batch] {return batch.mPending == 0;});
+
+    for(const ConfigFetchTask& task: tasks) {
+        if(RC_IS_NOTOK(task.mStatus)) {
+            return task.mStatus;
+        }
+    }
+
+    return RC_SUCCESS;
+}
+
 // Initialize Request and Timer ThreadPools
 static ErrCode preAllocateWorkers() {
     uint32_t desiredThreadCapacity = UrmSettings::metaConfigs.mDesiredThreadCount;
@@ -447,6 +774,8 @@ static void* restuneThreadStart() {
 
     // Initialize CocoTable
     CocoTable::getInstance();
+    signalReadiness(handlerReadiness, true);
+
     while(UrmSettings::isServerOnline()) {
         requestQueue->wait();
     }
@@ -491,9 +820,10 @@ static void configureFocusedSlice() {
 
 static ErrCode init(void* arg) {
     (void)arg;
-    // Server might have been restarted by systemd
-    // Ensure that Resource Nodes are reset to sane state
-    restoreToSafeState();
+    // Holds the Config snapshot, not fatal since it is only a cache.
+    if(mkdir(UrmSettings::mStateDir.c_str(), 0755) < 0 && errno != EEXIST) {
+        TYPELOGV(ERRNO_LOG, "mkdir", strerror(errno));
+    }
 
     // Start Resource Tuner Server Initialization
     // As part of Server Initialization the Configs (Resource / Signals etc.) will be parsed
@@ -563,38 +893,73 @@ static ErrCode init(void* arg) {
         return RC_MODULE_INIT_FAILURE;
     }
 
-    // Fetch and Parse Resource Configs
-    // Resource Configs which will be considered:
-    // - Common Resource Configs
-    // - Target Specific Resource Configs (if present)
-    // - Custom Resource Configs (if present)
+    // If none of the Resource / Signal Config inputs have changed since the last run,
+    // the merged Configs are loaded directly from the compiled snapshot.
+    ConfigSnapshot configSnapshot(UrmSettings::mConfigSnapshotPath);
+    addConfigSnapshotInputs(configSnapshot);
+    int8_t snapshotLoaded = RC_IS_OK(loadConfigSnapshot(configSnapshot));
+
+    // Create the Registries upfront, since the parsers below run concurrently.
+    ResourceRegistry::getInstance();
+    SignalRegistry::getInstance();
+    AppConfigs::getInstance();
+
+    // Fetch and Parse the Resource, Signal and Per-App Configs, concurrently.
+    // For each of these, the Configs which will be considered:
+    // - Common Configs (Resources and Signals only)
+    // - Target Specific Configs (if present)
+    // - Custom Configs (if present)
     // Note by this point, we will know the Target Info, i.e. number of Core, Clusters etc.
-    if(RC_IS_NOTOK(fetchResources())) {
-        return RC_MODULE_INIT_FAILURE;
+    std::vector<ConfigFetchRoutine> fetchRoutines;
+    if(!snapshotLoaded) {
+        fetchRoutines.push_back(fetchResources);
+        fetchRoutines.push_back(fetchSignals);
     }
+    fetchRoutines.push_back(fetchPerAppConfigs);
 
-    // Fetch and Parse Signal Configs
-    // Signal Configs which will be considered:
-    // - Common Signal Configs
-    // - Target Specific Signal Configs (if present)
-    // - Custom Signal Configs (if present)
-    if(RC_IS_NOTOK(fetchSignals())) {
+    if(RC_IS_NOTOK(fetchConcurrently(fetchRoutines))) {
         return RC_MODULE_INIT_FAILURE;
     }
 
-    // Fetch and Parse: Custom Per-App Configs
-    if(RC_IS_NOTOK(fetchPerAppConfigs())) {
-        return RC_MODULE_INIT_FAILURE;
+    if(!snapshotLoaded) {
+        // Not fatal, the Configs will simply be parsed again on the next start.
+        if(RC_IS_NOTOK(configSnapshot.store(ResourceRegistry::getInstance()->getRegisteredResources(),
+                                            SignalRegistry::getInstance()->getSignalConfigs()))) {
+            LOGW("RESTUNE_CONFIG_SNAPSHOT", "Failed to write the Config snapshot");
+        }
     }
 
     // Fetch and Parse: Custom ExtFeature Configs
+    // Features subscribe to Signals, hence this needs the Signal Configs to be in place.
     if(RC_IS_NOTOK(fetchExtFeatureConfigs())) {
         return RC_MODULE_INIT_FAILURE;
     }
 
+    // All the Resource and Signal Configs have been parsed, build the direct-indexed
+    // lookup tables which serve the Resource / Signal lookups on the Request path.
+    ResourceRegistry::getInstance()->buildLookupTable();
+    SignalRegistry::getInstance()->buildLookupTable();
+
+    // Route the relayed Signals to the Features subscribed to them.
+    SignalExtFeatureMapper::publish(
+        ExtFeaturesRegistry::getInstance()->buildSignalMappings(SignalRegistry::getInstance()));
+
     // By this point, all the Extension Appliers / Resources would have been registered.
     ResourceRegistry::getInstance()->pluginModifications();
 
+    // Server might have been restarted by systemd
+    // Ensure that Resource Nodes are reset to sane state
+    restoreToSafeState();
+
+    // Journal the original value of every node, before it is first modified.
+    // Not fatal, only crash recovery is affected.
+    if(mkdir(UrmSettings::mRuntimeDir.c_str(), 0755) < 0 && errno != EEXIST) {
+        TYPELOGV(ERRNO_LOG, "mkdir", strerror(errno));
+    }
+    if(RC_IS_NOTOK(ResourceRegistry::getInstance()->openDefaultsJournal(UrmSettings::mPersistenceFile))) {
+        LOGW("RESTUNE_SERVER_INIT", "Failed to create the sysfs original values journal");
+    }
+
     // Initialize external features
     ExtFeaturesRegistry::getInstance()->initializeFeatures();
 
@@ -610,7 +975,10 @@ static ErrCode init(void* arg) {
     }
 
     // Wait for the thread to initialize
-    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    if(!waitForReadiness(handlerReadiness)) {
+        TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "resource-tuner", "thread did not come up");
+        return RC_MODULE_INIT_FAILURE;
+    }
 
     // Start the Pulse Monitor and Garbage Collector Daemon Threads
     if(RC_IS_NOTOK(startPulseMonitorDaemon())) {
@@ -623,9 +991,12 @@ static ErrCode init(void* arg) {
         return RC_MODULE_INIT_FAILURE;
     }
 
+    // Restore the Requests from before a restart, before any new Request can be received.
+    replayActiveRequests();
+
     // Create the listener thread
     try {
-        resourceTunerListener = std::thread(listenerThreadStartRoutine);
+        resourceTunerListener = std::thread(listenerThreadStartRoutine, onListenerReady);
         TYPELOGD(LISTENER_THREAD_CREATION_SUCCESS);
 
     } catch(const std::system_error& e) {
@@ -633,14 +1004,24 @@ static ErrCode init(void* arg) {
         return RC_MODULE_INIT_FAILURE;
     }
 
-    // Wait for the thread to initialize
-    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    // Wait for the listening socket to be set up
+    if(!waitForReadiness(listenerReadiness)) {
+        TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "resource-tuner-listener", "socket setup failed");
+        return RC_MODULE_INIT_FAILURE;
+    }
+
+    // Watch the Configs for changes, a failure here only disables runtime reloads.
+    if(RC_IS_NOTOK(startConfigReloader())) {
+        LOGW("RESTUNE_CONFIG_RELOADER", "Config reload disabled, changes need a restart");
+    }
 
     return RC_SUCCESS;
 }
 
 static ErrCode tear(void* arg) {
     (void)arg;
+    ConfigReloader::getInstance()->stopConfigReloader();
+
     // Check if the thread is joinable, to prevent undefined behaviour
     if(resourceTunerListener.joinable()) {
         resourceTunerListener.join();
@@ -670,8 +1051,16 @@ static ErrCode tear(void* arg) {
         delete Timer::mTimerThreadPool;
     }
 
-    // Delete the Sysfs Persistent File
-    AuxRoutines::deleteFile(UrmSettings::mPersistenceFile);
+    // Note, the active Requests journal is retained, so that the Requests of clients
+    // which are still alive are re-applied when the Server is started again.
+    RequestManager::getInstance()->closeRequestJournal();
+
+    // All the nodes have been restored, delete the Sysfs Persistent File. Unless init
+    // failed before the journal of the previous run could be replayed.
+    ResourceRegistry::getInstance()->closeDefaultsJournal();
+    if(defaultsJournalReplayed) {
+        AuxRoutines::deleteFile(UrmSettings::mPersistenceFile);
+    }
 
     if(extensionLibHandles != nullptr) {
         for(uint32_t i = 0; i < UrmSettings::metaConfigs.mPluginCount; i++) {
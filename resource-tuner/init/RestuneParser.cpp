@@ -173,13 +173,13 @@ static int8_t isKeyTypeList(const std::string& keyName) {
     return false;
 }
 
-static int32_t onDeviceNodesCount(const std::string& filePath) {
+ErrCode RestuneParser::getResourceNodePaths(const std::string& filePath,
+                                           std::vector<std::string>& nodePaths) {
     SETUP_LIBYAML_PARSING(filePath);
 
     int8_t parsingDone = false;
     int8_t docMarker = false;
     int8_t parsingKey = false;
-    int32_t count = 0;
 
     std::string value = "";
 
@@ -208,9 +208,7 @@ static int32_t onDeviceNodesCount(const std::string& filePath) {
                     parsingKey = true;
                 } else {
                     if(parsingKey) {
-                        if(AuxRoutines::fileExists(value)) {
-                            count++;
-                        }
+                        nodePaths.push_back(value);
                     }
                     parsingKey = false;
                 }
@@ -225,6 +223,22 @@ static int32_t onDeviceNodesCount(const std::string& filePath) {
     }
 
     TEARDOWN_LIBYAML_PARSING
+    return RC_SUCCESS;
+}
+
+static int32_t onDeviceNodesCount(const std::string& filePath) {
+    std::vector<std::string> nodePaths;
+    ErrCode opStatus = RestuneParser::getResourceNodePaths(filePath, nodePaths);
+    if(RC_IS_NOTOK(opStatus)) {
+        return opStatus;
+    }
+
+    int32_t count = 0;
+    for(const std::string& nodePath: nodePaths) {
+        if(AuxRoutines::fileExists(nodePath)) {
+            count++;
+        }
+    }
     return count;
 }
 
@@ -344,6 +358,11 @@ ErrCode RestuneParser::parseResourceConfigYamlNode(const std::string& filePath)
 }
 
 ErrCode RestuneParser::parsePropertiesConfigYamlNode(const std::string& filePath) {
+    std::shared_ptr<PropertiesRegistry> propertiesRegistry = this->mPropertiesRegistry;
+    if(propertiesRegistry == nullptr) {
+        propertiesRegistry = PropertiesRegistry::getInstance();
+    }
+
     SETUP_LIBYAML_PARSING(filePath);
 
     int8_t parsingDone = false;
@@ -365,7 +384,7 @@ ErrCode RestuneParser::parsePropertiesConfigYamlNode(const std::string& filePath
 
             case YAML_MAPPING_END_EVENT:
                 if(currentKey.length() > 0 && currentValue.length() > 0) {
-                    PropertiesRegistry::getInstance()->createProperty(currentKey, currentValue);
+                    propertiesRegistry->createProperty(currentKey, currentValue);
                 }
 
                 currentKey.clear();
@@ -729,6 +748,11 @@ ErrCode RestuneParser::parseInitConfigYamlNode(const std::string& filePath) {
 }
 
 ErrCode RestuneParser::parseSignalConfigYamlNode(const std::string& filePath) {
+    std::shared_ptr<SignalRegistry> signalRegistry = this->mSignalRegistry;
+    if(signalRegistry == nullptr) {
+        signalRegistry = SignalRegistry::getInstance();
+    }
+
     SETUP_LIBYAML_PARSING(filePath);
 
     ErrCode rc = RC_SUCCESS;
@@ -803,8 +827,7 @@ ErrCode RestuneParser::parseSignalConfigYamlNode(const std::string& filePath) {
                         rc = signalInfoBuilder->setSignalCategory("0");
                     }
 
-                    SignalRegistry::getInstance()->
-                        registerSignal(signalInfoBuilder->build());
+                    signalRegistry->registerSignal(signalInfoBuilder->build());
                     delete(signalInfoBuilder);
                     signalInfoBuilder = nullptr;
                 }
@@ -998,6 +1021,11 @@ ErrCode RestuneParser::parseExtFeatureConfigYamlNode(const std::string& filePath
 }
 
 ErrCode RestuneParser::parsePerAppConfigYamlNode(const std::string& filePath) {
+    std::shared_ptr<AppConfigs> appConfigs = this->mAppConfigs;
+    if(appConfigs == nullptr) {
+        appConfigs = AppConfigs::getInstance();
+    }
+
     SETUP_LIBYAML_PARSING(filePath);
 
     ErrCode rc = RC_SUCCESS;
@@ -1044,7 +1072,7 @@ ErrCode RestuneParser::parsePerAppConfigYamlNode(const std::string& filePath) {
                 topKey = keyTracker.top();
                 if(topKey == APP_CONFIGS_ROOT) {
                     // Add to registry
-                    AppConfigs::getInstance()->registerAppConfig(appConfigBuider->build());
+                    appConfigs->registerAppConfig(appConfigBuider->build());
                     appConfigBuider = nullptr;
                 }
                 break;
@@ -1159,6 +1187,18 @@ ErrCode RestuneParser::parsePerAppConfigYamlNode(const std::string& filePath) {
     return rc;
 }
 
+void RestuneParser::setSignalRegistry(std::shared_ptr<SignalRegistry> signalRegistry) {
+    this->mSignalRegistry = signalRegistry;
+}
+
+void RestuneParser::setAppConfigs(std::shared_ptr<AppConfigs> appConfigs) {
+    this->mAppConfigs = appConfigs;
+}
+
+void RestuneParser::setPropertiesRegistry(std::shared_ptr<PropertiesRegistry> propertiesRegistry) {
+    this->mPropertiesRegistry = propertiesRegistry;
+}
+
 ErrCode RestuneParser::parseResourceConfigs(const std::string& filePath) {
     return parseResourceConfigYamlNode(filePath);
 }
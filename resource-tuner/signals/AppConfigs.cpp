@@ -5,13 +5,41 @@
 
 std::shared_ptr<AppConfigs> AppConfigs::appConfigRegistryInstance = nullptr;
 
+static void freeAppConfig(AppConfig* appConfig) {
+    if(appConfig == nullptr) return;
+
+    delete[] appConfig->mThreadNameList;
+    delete[] appConfig->mCGroupIds;
+    delete[] appConfig->mSignalCodes;
+    delete appConfig;
+}
+
 void AppConfigs::registerAppConfig(AppConfig* appConfig) {
     if(appConfig == nullptr) return;
+
+    // Configs are only registered into a generation which is not yet published (refer
+    // fetchPerAppConfigs and ConfigReloader), hence an overridden entry can be freed right away.
+    auto it = this->mAppConfig.find(appConfig->mAppName);
+    if(it != this->mAppConfig.end() && it->second != appConfig) {
+        freeAppConfig(it->second);
+    }
+
     this->mAppConfig[appConfig->mAppName] = appConfig;
 }
 
 AppConfig* AppConfigs::getAppConfig(const std::string& name) {
-    return this->mAppConfig[name];
+    // Lookups must not insert, the map is read concurrently.
+    auto it = this->mAppConfig.find(name);
+    if(it == this->mAppConfig.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+AppConfigs::~AppConfigs() {
+    for(std::pair<std::string, AppConfig*> entry: this->mAppConfig) {
+        freeAppConfig(entry.second);
+    }
 }
 
 AppConfigBuilder::AppConfigBuilder() {
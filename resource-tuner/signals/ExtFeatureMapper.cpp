@@ -5,20 +5,18 @@
 
 std::shared_ptr<SignalExtFeatureMapper> SignalExtFeatureMapper::signalExtFeatureMapperInstance = nullptr;
 
-int8_t SignalExtFeatureMapper::addFeature(uint64_t signalCode, int32_t feature) {
-    if(SignalRegistry::getInstance()->getSignalConfigById(signalCode) == nullptr) {
-        return false;
-    }
-
+// Only called on a generation which is not yet published.
+void SignalExtFeatureMapper::addFeature(uint64_t signalCode, int32_t feature) {
     this->mSignalTofeaturesMap[signalCode].push_back(feature);
-    return true;
 }
 
 int8_t SignalExtFeatureMapper::getFeatures(uint64_t signalCode, std::vector<uint32_t>& features) {
-    if(this->mSignalTofeaturesMap.find(signalCode) == this->mSignalTofeaturesMap.end()) {
+    // Lookups must not insert, the map is read concurrently.
+    auto it = this->mSignalTofeaturesMap.find(signalCode);
+    if(it == this->mSignalTofeaturesMap.end()) {
         return false;
     }
 
-    features = mSignalTofeaturesMap[signalCode];
+    features = it->second;
     return true;
 }
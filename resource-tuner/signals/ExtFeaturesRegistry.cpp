@@ -35,10 +35,28 @@ void ExtFeaturesRegistry::registerExtFeature(ExtFeatureInfo* featureInfo) {
     this->mExtFeaturesConfigs.push_back(featureInfo);
 
     this->mTotalExtFeatures++;
+}
+
+std::shared_ptr<SignalExtFeatureMapper> ExtFeaturesRegistry::buildSignalMappings(
+                                            std::shared_ptr<SignalRegistry> signalRegistry) {
+    std::shared_ptr<SignalExtFeatureMapper> mapper = SignalExtFeatureMapper::createGeneration();
+    if(mapper == nullptr || signalRegistry == nullptr) {
+        return mapper;
+    }
 
-    for(uint32_t signalCode: *featureInfo->mSignalsSubscribedTo) {
-        SignalExtFeatureMapper::getInstance()->addFeature(signalCode, featureInfo->mFeatureId);
+    for(ExtFeatureInfo* featureInfo: this->mExtFeaturesConfigs) {
+        if(featureInfo == nullptr || featureInfo->mSignalsSubscribedTo == nullptr) continue;
+
+        for(uint32_t signalCode: *featureInfo->mSignalsSubscribedTo) {
+            // Subscriptions to Signals which are not configured are skipped. Note, the
+            // Registry is keyed by the Signal Code in the upper 32 bits, and the Sub-Type.
+            uint64_t signalKey = ((uint64_t)signalCode << 32) | DEFAULT_SIGNAL_TYPE;
+            if(signalRegistry->getSignalTableIndex(signalKey) != -1) {
+                mapper->addFeature(signalCode, featureInfo->mFeatureId);
+            }
+        }
     }
+    return mapper;
 }
 
 std::vector<ExtFeatureInfo*> ExtFeaturesRegistry::getExtFeaturesConfigs() {
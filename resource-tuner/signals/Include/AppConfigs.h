@@ -22,26 +22,51 @@ typedef struct {
     uint32_t* mSignalCodes;
 } AppConfig;
 
+/**
+ * @brief AppConfigs
+ * @details Stores the Per-App Configs. Similar to the SignalRegistry, a new generation can be
+ *          built via createGeneration and then published (on a Config reload), readers should
+ *          hold on to the shared_ptr returned by getInstance while using any AppConfig from it.
+ */
 class AppConfigs {
 private:
     static std::shared_ptr<AppConfigs> appConfigRegistryInstance;
     std::unordered_map<std::string, AppConfig*> mAppConfig;
 
 public:
+    ~AppConfigs();
+
     void registerAppConfig(AppConfig* appConfig);
     AppConfig* getAppConfig(const std::string& appName);
 
+    static std::shared_ptr<AppConfigs> createGeneration() {
+        try {
+            return std::shared_ptr<AppConfigs>(new AppConfigs());
+        } catch(const std::bad_alloc& e) {
+            LOGE("RESTUNE_SIGNAL_REGISTRY",
+                 "Failed to allocate memory for AppConfigs instance: " + std::string(e.what()));
+            return nullptr;
+        }
+    }
+
+    static void publish(std::shared_ptr<AppConfigs> generation) {
+        std::atomic_store(&appConfigRegistryInstance, generation);
+    }
+
     static std::shared_ptr<AppConfigs> getInstance() {
-        if(appConfigRegistryInstance == nullptr) {
-            try {
-                appConfigRegistryInstance = std::shared_ptr<AppConfigs>(new AppConfigs());
-            } catch(const std::bad_alloc& e) {
-                LOGE("RESTUNE_SIGNAL_REGISTRY",
-                     "Failed to allocate memory for AppConfigs instance: " + std::string(e.what()));
+        std::shared_ptr<AppConfigs> instance = std::atomic_load(&appConfigRegistryInstance);
+        if(instance == nullptr) {
+            std::shared_ptr<AppConfigs> generation = createGeneration();
+            if(generation == nullptr) {
                 return nullptr;
             }
+
+            if(!std::atomic_compare_exchange_strong(&appConfigRegistryInstance, &instance, generation)) {
+                return instance;
+            }
+            instance = generation;
         }
-        return appConfigRegistryInstance;
+        return instance;
     }
 };
 
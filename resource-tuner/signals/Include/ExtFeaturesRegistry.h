@@ -81,6 +81,15 @@ public:
     void registerExtFeature(ExtFeatureInfo* extFeatureInfo);
     void displayExtFeatures();
 
+    /**
+     * @brief Map the Signals subscribed to by the registered Features, to the Features.
+     * @details Built against the given Signal Registry generation, the result is to be published
+     *          along with it, i.e. at init and on every Config reload, since a Signal subscribed
+     *          to may have been added or removed meanwhile.
+     */
+    std::shared_ptr<SignalExtFeatureMapper> buildSignalMappings(
+                                                std::shared_ptr<SignalRegistry> signalRegistry);
+
     static std::shared_ptr<ExtFeaturesRegistry> getInstance() {
         if(extFeaturesRegistryInstance == nullptr) {
             extFeaturesRegistryInstance = std::shared_ptr<ExtFeaturesRegistry> (new ExtFeaturesRegistry());
@@ -10,21 +10,50 @@
 
 #include "SignalRegistry.h"
 
+/**
+ * @brief SignalExtFeatureMapper
+ * @details Maps Signals to the Ext Features subscribed to them. Built against a given Signal
+ *          Registry generation (refer ExtFeaturesRegistry::buildSignalMappings), and replaced
+ *          along with it on a Config reload, same as the SignalRegistry.
+ */
 class SignalExtFeatureMapper {
 private:
     static std::shared_ptr<SignalExtFeatureMapper> signalExtFeatureMapperInstance;
     std::unordered_map<uint32_t, std::vector<uint32_t>> mSignalTofeaturesMap;
 
 public:
-    int8_t addFeature(uint64_t signal, int32_t feature);
+    void addFeature(uint64_t signal, int32_t feature);
 
     int8_t getFeatures(uint64_t signal, std::vector<uint32_t>& features);
 
+    static std::shared_ptr<SignalExtFeatureMapper> createGeneration() {
+        try {
+            return std::shared_ptr<SignalExtFeatureMapper>(new SignalExtFeatureMapper());
+        } catch(const std::bad_alloc& e) {
+            LOGE("RESTUNE_EXT_FEATURES",
+                 "Failed to allocate memory for SignalExtFeatureMapper instance: " + std::string(e.what()));
+            return nullptr;
+        }
+    }
+
+    static void publish(std::shared_ptr<SignalExtFeatureMapper> generation) {
+        std::atomic_store(&signalExtFeatureMapperInstance, generation);
+    }
+
     static std::shared_ptr<SignalExtFeatureMapper> getInstance() {
-        if(signalExtFeatureMapperInstance == nullptr) {
-            signalExtFeatureMapperInstance = std::shared_ptr<SignalExtFeatureMapper> (new SignalExtFeatureMapper());
+        std::shared_ptr<SignalExtFeatureMapper> instance = std::atomic_load(&signalExtFeatureMapperInstance);
+        if(instance == nullptr) {
+            std::shared_ptr<SignalExtFeatureMapper> generation = createGeneration();
+            if(generation == nullptr) {
+                return nullptr;
+            }
+
+            if(!std::atomic_compare_exchange_strong(&signalExtFeatureMapperInstance, &instance, generation)) {
+                return instance;
+            }
+            instance = generation;
         }
-        return signalExtFeatureMapperInstance;
+        return instance;
     }
 };
 
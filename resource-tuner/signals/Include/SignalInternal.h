@@ -23,4 +23,14 @@
  */
 ErrCode submitSignalRequest(void* clientReq);
 
+typedef void (*FocusHintListener)(pid_t pid);
+
+/**
+ * @brief Register the listener for focus hints, i.e. URM_SIG_APP_FOCUS relay Signals carrying
+ *        the pid of the focused app as their first argument.
+ * @details A single listener is supported, pass nullptr to unregister. Once this returns,
+ *          the previous listener is no longer being invoked.
+ */
+void registerFocusHintListener(FocusHintListener listener);
+
 #endif
@@ -14,6 +14,7 @@
 #include "Logger.h"
 #include "Resource.h"
 #include "MemoryPool.h"
+#include "DirectIndexTable.h"
 #include "UrmSettings.h"
 
 /**
@@ -66,7 +67,11 @@ typedef struct {
 /**
  * @brief SignalRegistry
  * @details Stores information Relating to all the Signals available for Tuning.
- *          Note: This information is extracted from Config YAML files.
+ *          Note: This information is extracted from Config YAML files.\n
+ *          The Registry can be replaced at runtime (on a Config reload): a new generation is
+ *          built off to the side via createGeneration, and then published. Readers should hold
+ *          on to the shared_ptr returned by getInstance for as long as they use any SignalInfo
+ *          obtained from it, the previous generation is freed once its last reader lets go.
  */
 class SignalRegistry {
 private:
@@ -75,6 +80,7 @@ private:
     int32_t mTotalSignals;
     std::vector<SignalInfo*> mSignalsConfigs;
     std::unordered_map<uint64_t, int32_t> mSILMap;
+    DirectIndexTable mSignalLookup;
 
     SignalRegistry();
 
@@ -106,17 +112,49 @@ public:
     int32_t getSignalsConfigCount();
     int32_t getSignalTableIndex(uint64_t signalID);
 
+    /**
+     * @brief Build the direct-indexed lookup table over all the registered Signals.
+     * @details The table is keyed by the Signal Code (Category and ID), Signal codes registered
+     *          with more than one Sub-Type are resolved via mSILMap. Should be called once Config
+     *          parsing is complete.
+     */
+    void buildLookupTable();
+
+    /**
+     * @brief Create a new, empty Registry generation, which is not visible to readers until published.
+     */
+    static std::shared_ptr<SignalRegistry> createGeneration() {
+        try {
+            return std::shared_ptr<SignalRegistry>(new SignalRegistry());
+        } catch(const std::bad_alloc& e) {
+            LOGE("RESTUNE_SIGNAL_REGISTRY",
+                 "Failed to allocate memory for SignalRegistry instance: " + std::string(e.what()));
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief Atomically replace the current Registry generation with the given one.
+     */
+    static void publish(std::shared_ptr<SignalRegistry> generation) {
+        std::atomic_store(&signalRegistryInstance, generation);
+    }
+
     static std::shared_ptr<SignalRegistry> getInstance() {
-        if(signalRegistryInstance == nullptr) {
-            try {
-                signalRegistryInstance = std::shared_ptr<SignalRegistry>(new SignalRegistry());
-            } catch(const std::bad_alloc& e) {
-                LOGE("RESTUNE_SIGNAL_REGISTRY",
-                     "Failed to allocate memory for SignalRegistry instance: " + std::string(e.what()));
+        std::shared_ptr<SignalRegistry> instance = std::atomic_load(&signalRegistryInstance);
+        if(instance == nullptr) {
+            std::shared_ptr<SignalRegistry> generation = createGeneration();
+            if(generation == nullptr) {
                 return nullptr;
             }
+
+            // Lost the race, use the instance created by the other thread.
+            if(!std::atomic_compare_exchange_strong(&signalRegistryInstance, &instance, generation)) {
+                return instance;
+            }
+            instance = generation;
         }
-        return signalRegistryInstance;
+        return instance;
     }
 };
 
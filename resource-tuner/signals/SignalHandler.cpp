@@ -1,8 +1,57 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <mutex>
+#include <condition_variable>
+
 #include "SignalInternal.h"
 
+static std::mutex focusHintMutex;
+static std::condition_variable focusHintCond;
+static FocusHintListener focusHintListener = nullptr;
+// Listener invocations underway, they run without focusHintMutex held.
+static int32_t focusHintCallsInFlight = 0;
+
+void registerFocusHintListener(FocusHintListener listener) {
+    std::unique_lock<std::mutex> lock(focusHintMutex);
+    focusHintListener = listener;
+    focusHintCond.wait(lock, [] { return focusHintCallsInFlight == 0; });
+}
+
+static void notifyFocusHint(Signal* signal) {
+    std::vector<uint32_t>* args = signal->getListArgs();
+    if(args == nullptr || args->empty()) {
+        LOGW("RESTUNE_SIGNAL_QUEUE", "Focus hint without a pid, dropping");
+        return;
+    }
+
+    // Moving the focused profile (and cgroup) onto an arbitrary process is a privileged operation.
+    if(ClientDataManager::getInstance()->getClientLevelByID(signal->getClientPID()) != PERMISSION_SYSTEM) {
+        LOGW("RESTUNE_SIGNAL_QUEUE",
+             "Focus hint from unprivileged client: " + std::to_string(signal->getClientPID()) + ", dropping");
+        return;
+    }
+
+    FocusHintListener listener = nullptr;
+    {
+        const std::lock_guard<std::mutex> lock(focusHintMutex);
+        listener = focusHintListener;
+        if(listener == nullptr) {
+            return;
+        }
+        focusHintCallsInFlight++;
+    }
+
+    // Called without focusHintMutex held, the listener takes its own locks.
+    listener((pid_t)(*args)[0]);
+
+    {
+        const std::lock_guard<std::mutex> lock(focusHintMutex);
+        focusHintCallsInFlight--;
+    }
+    focusHintCond.notify_all();
+}
+
 static int8_t getRequestPriority(int8_t clientPermissions, int8_t reqSpecifiedPriority) {
     if(clientPermissions == PERMISSION_SYSTEM) {
         switch(reqSpecifiedPriority) {
@@ -251,6 +300,10 @@ static void processIncomingRequest(Signal* signal) {
         }
 
         case REQ_SIGNAL_RELAY: {
+            if(signal->getSignalCode() == URM_SIG_APP_FOCUS) {
+                notifyFocusHint(signal);
+            }
+
             // Get all the subscribed Features
             std::vector<uint32_t> subscribedFeatures;
             int8_t featureExist = SignalExtFeatureMapper::getInstance()->getFeatures(
@@ -57,6 +57,9 @@ void SignalRegistry::registerSignal(SignalInfo* signalInfo) {
     signalBitmap <<= 32; // Make Room
     signalBitmap |= ((uint32_t)signalInfo->mSigType);
 
+    // Any previously built lookup table is now stale.
+    this->mSignalLookup.reset();
+
     // Check for any conflict
     if(this->mSILMap.find(signalBitmap) != this->mSILMap.end()) {
 
@@ -81,13 +84,13 @@ std::vector<SignalInfo*> SignalRegistry::getSignalConfigs() {
 }
 
 SignalInfo* SignalRegistry::getSignalConfigById(uint64_t sigCode) {
-    if(this->mSILMap.find(sigCode) == this->mSILMap.end()) {
+    int32_t signalTableIndex = this->getSignalTableIndex(sigCode);
+    if(signalTableIndex == -1) {
         TYPELOGV(SIGNAL_REGISTRY_SIGNAL_NOT_FOUND, GET_SIGNAL_ID(sigCode), GET_SIGNAL_TYPE(sigCode));
         return nullptr;
     }
 
-    int32_t mResourceTableIndex = this->mSILMap[sigCode];
-    return this->mSignalsConfigs[mResourceTableIndex];
+    return this->mSignalsConfigs[signalTableIndex];
 }
 
 SignalInfo* SignalRegistry::getSignalConfigById(uint32_t sigId, uint32_t sigType) {
@@ -98,13 +101,13 @@ SignalInfo* SignalRegistry::getSignalConfigById(uint32_t sigId, uint32_t sigType
     signalBitmap <<= 32; // Make Room
     signalBitmap |= sigType;
 
-    if(this->mSILMap.find(signalBitmap) == this->mSILMap.end()) {
+    int32_t signalTableIndex = this->getSignalTableIndex(signalBitmap);
+    if(signalTableIndex == -1) {
         TYPELOGV(SIGNAL_REGISTRY_SIGNAL_NOT_FOUND, sigId, sigType);
         return nullptr;
     }
 
-    int32_t mResourceTableIndex = this->mSILMap[signalBitmap];
-    return this->mSignalsConfigs[mResourceTableIndex];
+    return this->mSignalsConfigs[signalTableIndex];
 }
 
 int32_t SignalRegistry::getSignalsConfigCount() {
@@ -112,11 +115,41 @@ int32_t SignalRegistry::getSignalsConfigCount() {
 }
 
 int32_t SignalRegistry::getSignalTableIndex(uint64_t signalCode) {
-    if(this->mSILMap.find(signalCode) == this->mSILMap.end()) {
+    int32_t signalTableIndex = this->mSignalLookup.lookup(GET_SIGNAL_ID(signalCode));
+    if(signalTableIndex >= 0) {
+        // Only a single Sub-Type is registered for this Signal Code.
+        if(this->mSignalsConfigs[signalTableIndex]->mSigType != GET_SIGNAL_TYPE(signalCode)) {
+            return -1;
+        }
+        return signalTableIndex;
+    }
+
+    if(signalTableIndex != DIRECT_INDEX_FALLBACK) {
+        return -1;
+    }
+
+    auto it = this->mSILMap.find(signalCode);
+    if(it == this->mSILMap.end()) {
         return -1;
     }
 
-    return this->mSILMap[signalCode];
+    return it->second;
+}
+
+void SignalRegistry::buildLookupTable() {
+    // Collapse the Sub-Type, Signal Codes with multiple Sub-Types are marked for fallback.
+    std::unordered_map<uint32_t, int32_t> codeIndices;
+    for(std::pair<uint64_t, int32_t> entry: this->mSILMap) {
+        uint32_t sigCode = GET_SIGNAL_ID(entry.first);
+        if(codeIndices.find(sigCode) != codeIndices.end()) {
+            codeIndices[sigCode] = DIRECT_INDEX_FALLBACK;
+        } else {
+            codeIndices[sigCode] = entry.second;
+        }
+    }
+
+    std::vector<std::pair<uint32_t, int32_t>> entries(codeIndices.begin(), codeIndices.end());
+    this->mSignalLookup.build(entries);
 }
 
 SignalRegistry::~SignalRegistry() {
@@ -0,0 +1,443 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+/**
+ * Tests for the Contextual Classifier's building blocks which do not depend on the
+ * ML model, hence these are run irrespective of floret's availability.
+ */
+
+#include <csignal>
+#include <fstream>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/wait.h>
+
+#include "TestUtils.h"
+#include "URMTests.h"
+#include "AuxRoutines.h"
+#include "FocusTracker.h"
+#include "ProcessIndex.h"
+#include "ClassificationCache.h"
+#include "ClassifierEventQueue.h"
+#include "ContextualClassifier.h"
+#include "SignalRegistry.h"
+
+#define TEST_CLASS "COMPONENT"
+#define TEST_SUBCAT "CLASSIFIER"
+
+URM_TEST(TestFocusTrackerWithoutHints, {
+    FocusTracker focusTracker;
+
+    // Without a focus provider, every classified app is taken to be focused.
+    E_ASSERT((focusTracker.onClassified(1001, {1001, "app1", 1}, 1) == true));
+    focusTracker.setFocusedApp(1001, 1);
+    E_ASSERT((focusTracker.onClassified(1002, {1002, "app2", 2}, 2) == true));
+    focusTracker.setFocusedApp(1002, 2);
+
+    E_ASSERT((focusTracker.focusHintsSeen() == false));
+    E_ASSERT((focusTracker.getFocusedApp() == 1002));
+})
+
+URM_TEST(TestFocusTrackerBackgroundLaunchKeepsProfile, {
+    FocusTracker focusTracker;
+    ClassifiedApp app;
+
+    E_ASSERT((focusTracker.onClassified(1001, {1001, "app1", 1}, 1) == true));
+    focusTracker.setFocusedApp(1001, 1);
+
+    // The classified app got focus, which is already in effect.
+    E_ASSERT((focusTracker.onFocusHint(1001, app) == FOCUS_UNCHANGED));
+
+    // Launched in the background, only recorded.
+    E_ASSERT((focusTracker.onClassified(1002, {1002, "app2", 3}, 2) == false));
+    E_ASSERT((focusTracker.getFocusedApp() == 1001));
+})
+
+URM_TEST(TestFocusTrackerFocusSwitch, {
+    FocusTracker focusTracker;
+    ClassifiedApp app;
+
+    E_ASSERT((focusTracker.onClassified(1001, {1001, "app1", 1}, 1) == true));
+    focusTracker.setFocusedApp(1001, 1);
+    E_ASSERT((focusTracker.onFocusHint(1001, app) == FOCUS_UNCHANGED));
+    E_ASSERT((focusTracker.onClassified(1002, {1002, "app2", 3}, 2) == false));
+
+    // Focus moves to the already classified app, without classifying again.
+    E_ASSERT((focusTracker.onFocusHint(1002, app) == FOCUS_SWITCH));
+    E_ASSERT((app.tgid == 1002));
+    E_ASSERT((app.comm == "app2"));
+    E_ASSERT((app.contextType == 3));
+    focusTracker.setFocusedApp(1002, 3);
+
+    // Repeated hint, nothing to switch.
+    E_ASSERT((focusTracker.onFocusHint(1002, app) == FOCUS_UNCHANGED));
+})
+
+URM_TEST(TestFocusTrackerFocusOnUnclassifiedApp, {
+    FocusTracker focusTracker;
+    ClassifiedApp app;
+
+    E_ASSERT((focusTracker.onClassified(1001, {1001, "app1", 1}, 1) == true));
+    focusTracker.setFocusedApp(1001, 1);
+
+    // Unknown app, the previous profile is dropped.
+    E_ASSERT((focusTracker.onFocusHint(1003, app) == FOCUS_CLASSIFY));
+    E_ASSERT((focusTracker.getFocusedApp() == -1));
+
+    // Its classification result is applied once available, others stay in the background.
+    E_ASSERT((focusTracker.onClassified(1002, {1002, "app2", 2}, 2) == false));
+    E_ASSERT((focusTracker.onClassified(1003, {1003, "app3", 2}, 3) == true));
+})
+
+URM_TEST(TestFocusTrackerAppExit, {
+    FocusTracker focusTracker;
+    ClassifiedApp app;
+
+    E_ASSERT((focusTracker.onClassified(1001, {1001, "app1", 1}, 1) == true));
+    focusTracker.setFocusedApp(1001, 1);
+    E_ASSERT((focusTracker.onFocusHint(1001, app) == FOCUS_UNCHANGED));
+    E_ASSERT((focusTracker.onClassified(1002, {1002, "app2", 2}, 2) == false));
+
+    focusTracker.onAppExit(1001);
+    E_ASSERT((focusTracker.getFocusedApp() == -1));
+
+    // The exited app is forgotten, it needs to be classified again.
+    focusTracker.onAppExit(1002);
+    E_ASSERT((focusTracker.onFocusHint(1002, app) == FOCUS_CLASSIFY));
+})
+
+URM_TEST(TestFocusTrackerStaleClassification, {
+    FocusTracker focusTracker;
+
+    // app2 was launched after app1, but its classification completed first.
+    E_ASSERT((focusTracker.onClassified(1002, {1002, "app2", 2}, 11) == true));
+    focusTracker.setFocusedApp(1002, 11);
+
+    // app1's result arrives late, it must not override the newer app.
+    E_ASSERT((focusTracker.onClassified(1001, {1001, "app1", 1}, 10) == false));
+    E_ASSERT((focusTracker.getFocusedApp() == 1002));
+
+    // A later launch is applied as usual.
+    E_ASSERT((focusTracker.onClassified(1003, {1003, "app3", 3}, 12) == true));
+})
+
+static void registerAppSignal(std::shared_ptr<SignalRegistry> registry,
+                              const std::string& sigType,
+                              const std::string& name) {
+    SignalInfoBuilder builder;
+    E_ASSERT((builder.setSignalID("0x0003") == RC_SUCCESS));
+    E_ASSERT((builder.setSignalCategory("0x02") == RC_SUCCESS));
+    E_ASSERT((builder.setSignalType(sigType) == RC_SUCCESS));
+    E_ASSERT((builder.setName(name) == RC_SUCCESS));
+    registry->registerSignal(builder.build());
+}
+
+URM_TEST(TestBackgroundClassificationUsesBackgroundConfig, {
+    // Game workload Signal (URM_SIG_GAME_APP_OPEN), along with its background variant.
+    std::shared_ptr<SignalRegistry> prevRegistry = SignalRegistry::getInstance();
+    std::shared_ptr<SignalRegistry> registry = SignalRegistry::createGeneration();
+    E_ASSERT((registry != nullptr));
+    registerAppSignal(registry, "0", "GAME_APP_OPEN");
+    registerAppSignal(registry, "1", "GAME_APP_BACKGROUND");
+    registry->buildLookupTable();
+    SignalRegistry::publish(registry);
+
+    FocusTracker focusTracker;
+    ClassifiedApp app;
+    uint32_t sigId = 0;
+    uint32_t sigType = 0;
+
+    E_ASSERT((focusTracker.onClassified(1001, {1001, "app1", CC_APP}, 1) == true));
+    focusTracker.setFocusedApp(1001, 1);
+    E_ASSERT((focusTracker.onFocusHint(1001, app) == FOCUS_UNCHANGED));
+
+    // A game launched in the background gets the background config only.
+    int8_t isFocused = focusTracker.onClassified(1002, {1002, "game", CC_GAME}, 2);
+    E_ASSERT((isFocused == false));
+    ContextualClassifier::GetActionSignal(CC_GAME, isFocused, sigId, sigType);
+    SignalInfo* signalInfo = SignalRegistry::getInstance()->getSignalConfigById(sigId, sigType);
+    E_ASSERT((signalInfo != nullptr));
+    E_ASSERT((signalInfo->mSignalName == "GAME_APP_BACKGROUND"));
+
+    // Once focused, the game's regular config is applied.
+    E_ASSERT((focusTracker.onFocusHint(1002, app) == FOCUS_SWITCH));
+    ContextualClassifier::GetActionSignal(app.contextType, true, sigId, sigType);
+    signalInfo = SignalRegistry::getInstance()->getSignalConfigById(sigId, sigType);
+    E_ASSERT((signalInfo != nullptr));
+    E_ASSERT((signalInfo->mSignalName == "GAME_APP_OPEN"));
+
+    SignalRegistry::publish(prevRegistry);
+})
+
+static ProcEvent makeEvent(int32_t pid, int32_t type, uint64_t seq) {
+    ProcEvent ev{};
+    ev.pid = pid;
+    ev.tgid = pid;
+    ev.type = type;
+    ev.seq = seq;
+    return ev;
+}
+
+URM_TEST(TestClassifierEventQueuePerPidSerialization, {
+    ClassifierEventQueue eventQueue(10);
+    eventQueue.push(makeEvent(100, CC_APP_OPEN, 1));
+    eventQueue.push(makeEvent(100, CC_APP_CLOSE, 2));
+    eventQueue.push(makeEvent(200, CC_APP_OPEN, 3));
+
+    ProcEvent ev{};
+    E_ASSERT((eventQueue.popRunnable(ev) == true));
+    E_ASSERT((ev.pid == 100 && ev.seq == 1));
+
+    // pid 100 is in flight, its next event is held back while others proceed.
+    E_ASSERT((eventQueue.popRunnable(ev) == true));
+    E_ASSERT((ev.pid == 200 && ev.seq == 3));
+    E_ASSERT((eventQueue.popRunnable(ev) == false));
+
+    eventQueue.markDone(100);
+    E_ASSERT((eventQueue.popRunnable(ev) == true));
+    E_ASSERT((ev.pid == 100 && ev.seq == 2 && ev.type == CC_APP_CLOSE));
+    E_ASSERT((eventQueue.size() == 0));
+})
+
+URM_TEST(TestClassifierEventQueueCrossPidOrdering, {
+    ClassifierEventQueue eventQueue(3);
+    for(int32_t i = 0; i < 4; i++) {
+        eventQueue.push(makeEvent(100 + i, CC_APP_OPEN, i + 1));
+    }
+
+    // Bounded, the oldest event was dropped. The rest are picked in order of arrival.
+    E_ASSERT((eventQueue.size() == 3));
+    ProcEvent ev{};
+    uint64_t lastSeq = 1;
+    while(eventQueue.popRunnable(ev)) {
+        E_ASSERT((ev.seq == lastSeq + 1));
+        lastSeq = ev.seq;
+    }
+    E_ASSERT((lastSeq == 4));
+})
+
+static int8_t containsTask(const std::vector<pid_t>& tids, pid_t tid) {
+    return std::find(tids.begin(), tids.end(), tid) != tids.end();
+}
+
+URM_TEST(TestProcessIndexUpdateAndRemove, {
+    ProcessIndex processIndex;
+    processIndex.update(5000, 5000, "gameapp");
+    processIndex.update(5001, 5000, "RenderThread");
+    E_ASSERT((processIndex.size() == 2));
+
+    // Renamed, only the latest comm matches.
+    processIndex.update(5001, 5000, "AudioThread");
+    E_ASSERT((processIndex.findTasks("RenderThread", 5000).empty()));
+    E_ASSERT((containsTask(processIndex.findTasks("AudioThread", 5000), 5001)));
+
+    processIndex.remove(5001);
+    E_ASSERT((processIndex.size() == 1));
+    E_ASSERT((processIndex.findTasks("AudioThread", 5000).empty()));
+})
+
+URM_TEST(TestProcessIndexFindTasksScoping, {
+    ProcessIndex processIndex;
+    processIndex.update(5000, 5000, "gameapp");
+    processIndex.update(5001, 5000, "RenderThread");
+    // Spawned by the app, and a grandchild
+    processIndex.update(5100, 5100, "RenderHelper");
+    processIndex.setParent(5100, 5000);
+    processIndex.update(5200, 5200, "RenderWorker");
+    processIndex.setParent(5200, 5100);
+    processIndex.update(5201, 5200, "RenderThread");
+    // Unrelated tasks of the same name
+    processIndex.update(6000, 6000, "RenderThread");
+    processIndex.setParent(6000, 1);
+    processIndex.update(6001, 6000, "RenderThread");
+
+    std::vector<pid_t> tids = processIndex.findTasks("Render", 5000);
+    E_ASSERT((tids.size() == 4));
+    E_ASSERT((containsTask(tids, 5001)));
+    E_ASSERT((containsTask(tids, 5100)));
+    E_ASSERT((containsTask(tids, 5200)));
+    E_ASSERT((containsTask(tids, 5201)));
+
+    E_ASSERT((processIndex.isDescendant(5200, 5000) == true));
+    E_ASSERT((processIndex.isDescendant(6000, 5000) == false));
+
+    // Matched anywhere within the comm.
+    tids = processIndex.findTasks("Thread", 5000);
+    E_ASSERT((tids.size() == 2));
+    E_ASSERT((containsTask(tids, 5001)));
+    E_ASSERT((containsTask(tids, 5201)));
+    E_ASSERT((processIndex.findTasks("RenderThread", 5000).size() == 2));
+    E_ASSERT((processIndex.findTasks("", 5000).empty()));
+})
+
+URM_TEST(TestProcessIndexForkThenRename, {
+    ProcessIndex processIndex;
+    processIndex.update(5000, 5000, "gameapp");
+
+    // Forked, without an exec, it runs under the app's comm.
+    processIndex.recordFork(5300, 5000);
+    E_ASSERT((processIndex.isDescendant(5300, 5000) == true));
+    E_ASSERT((containsTask(processIndex.findTasks("gameapp", 5000), 5300)));
+
+    // Renamed (COMM event), the parent is kept.
+    processIndex.update(5300, 5300, "AudioWorker");
+    E_ASSERT((processIndex.isDescendant(5300, 5000) == true));
+    E_ASSERT((containsTask(processIndex.findTasks("Audio", 5000), 5300)));
+    E_ASSERT((processIndex.findTasks("gameapp", 5000).size() == 1));
+})
+
+URM_TEST(TestProcessIndexPopulate, {
+    std::string comm;
+    E_ASSERT((AuxRoutines::fetchComm(getpid(), comm) == 0));
+
+    pid_t childPid = fork();
+    if(childPid == 0) {
+        pause();
+        _exit(0);
+    }
+    E_ASSERT((childPid > 0));
+
+    ProcessIndex processIndex;
+    processIndex.populate();
+    E_ASSERT((processIndex.size() > 0));
+
+    // The child shares the comm, and is found as a descendant.
+    std::vector<pid_t> tids = processIndex.findTasks(comm, getpid());
+    int8_t foundSelf = containsTask(tids, getpid());
+    int8_t foundChild = containsTask(tids, childPid);
+    int8_t childIsDescendant = processIndex.isDescendant(childPid, getpid());
+
+    kill(childPid, SIGKILL);
+    waitpid(childPid, nullptr, 0);
+
+    E_ASSERT((foundSelf == true));
+    E_ASSERT((foundChild == true));
+    E_ASSERT((childIsDescendant == true));
+})
+
+static ExeIdentity makeIdentity(uint64_t ino, int64_t mtimeNs, uint64_t cmdlineHash) {
+    return {"/usr/bin/testapp", 2049, ino, mtimeNs, 4096, cmdlineHash};
+}
+
+URM_TEST(TestClassificationCacheLRUEviction, {
+    ClassificationCache classificationCache(2);
+    int32_t contextType = 0;
+
+    classificationCache.insert(makeIdentity(1, 100, 7), 1);
+    classificationCache.insert(makeIdentity(2, 100, 7), 2);
+
+    // Marks the first entry as most recently used, the second one is evicted next.
+    E_ASSERT((classificationCache.lookup(makeIdentity(1, 100, 7), contextType) == true));
+    classificationCache.insert(makeIdentity(3, 100, 7), 3);
+
+    E_ASSERT((classificationCache.size() == 2));
+    E_ASSERT((classificationCache.lookup(makeIdentity(2, 100, 7), contextType) == false));
+    E_ASSERT((classificationCache.lookup(makeIdentity(1, 100, 7), contextType) == true));
+    E_ASSERT((contextType == 1));
+    E_ASSERT((classificationCache.lookup(makeIdentity(3, 100, 7), contextType) == true));
+    E_ASSERT((contextType == 3));
+
+    // Shrinking drops the least recently used entries.
+    classificationCache.setMaxEntries(1);
+    E_ASSERT((classificationCache.size() == 1));
+    E_ASSERT((classificationCache.lookup(makeIdentity(3, 100, 7), contextType) == true));
+})
+
+URM_TEST(TestClassificationCacheKeyFields, {
+    ClassificationCache classificationCache;
+    int32_t contextType = 0;
+    classificationCache.insert(makeIdentity(1, 100, 7), 2);
+
+    // Replaced binary (inode), upgraded in place (mtime), or another app run by the same
+    // interpreter (cmdline), each is classified afresh.
+    E_ASSERT((classificationCache.lookup(makeIdentity(9, 100, 7), contextType) == false));
+    E_ASSERT((classificationCache.lookup(makeIdentity(1, 200, 7), contextType) == false));
+    E_ASSERT((classificationCache.lookup(makeIdentity(1, 100, 8), contextType) == false));
+    E_ASSERT((classificationCache.lookup(makeIdentity(1, 100, 7), contextType) == true));
+    E_ASSERT((contextType == 2));
+
+    ExeIdentity identity;
+    E_ASSERT((ClassificationCache::getExeIdentity(getpid(), identity) == true));
+    E_ASSERT((identity.mExePath.length() > 0 && identity.mExePath[0] == '/'));
+    E_ASSERT((identity.mIno != 0));
+    E_ASSERT((identity.mSize > 0));
+
+    // Stable across lookups of the same process
+    ExeIdentity sameIdentity;
+    E_ASSERT((ClassificationCache::getExeIdentity(getpid(), sameIdentity) == true));
+    E_ASSERT((identity.mCmdlineHash == sameIdentity.mCmdlineHash));
+    E_ASSERT((identity.mMtimeNs == sameIdentity.mMtimeNs));
+})
+
+URM_TEST(TestClassificationCachePersistence, {
+    std::string cachePath = "/tmp/urm_test_classification_cache";
+    std::string modelPath = "/tmp/urm_test_classification_model.bin";
+    {
+        std::ofstream modelFile(modelPath, std::ios::trunc);
+        modelFile << "model-v1";
+    }
+
+    ClassificationCache savedCache;
+    savedCache.setModelIdentity(modelPath);
+    savedCache.insert(makeIdentity(1, 100, 7), 1);
+    savedCache.insert(makeIdentity(2, 100, 7), 2);
+    E_ASSERT((savedCache.save(cachePath) == true));
+
+    // Round trip, the recency order is retained.
+    ClassificationCache loadedCache(1);
+    loadedCache.setModelIdentity(modelPath);
+    int32_t contextType = 0;
+    E_ASSERT((loadedCache.load(cachePath) == true));
+    E_ASSERT((loadedCache.size() == 1));
+    E_ASSERT((loadedCache.lookup(makeIdentity(2, 100, 7), contextType) == true));
+    E_ASSERT((contextType == 2));
+
+    // Written for another model
+    {
+        std::ofstream modelFile(modelPath, std::ios::trunc);
+        modelFile << "model-v2, retrained";
+    }
+    ClassificationCache otherModelCache;
+    otherModelCache.setModelIdentity(modelPath);
+    E_ASSERT((otherModelCache.load(cachePath) == false));
+    E_ASSERT((otherModelCache.size() == 0));
+
+    std::remove(cachePath.c_str());
+    std::remove(modelPath.c_str());
+})
+
+URM_TEST(TestClassificationCacheCorruptFile, {
+    std::string cachePath = "/tmp/urm_test_classification_cache_corrupt";
+    std::string modelPath = "/tmp/urm_test_classification_model_corrupt.bin";
+    {
+        std::ofstream modelFile(modelPath, std::ios::trunc);
+        modelFile << "model";
+    }
+
+    ClassificationCache savedCache;
+    savedCache.setModelIdentity(modelPath);
+    savedCache.insert(makeIdentity(1, 100, 7), 1);
+    E_ASSERT((savedCache.save(cachePath) == true));
+
+    // Truncated entry, appended after a valid one
+    {
+        std::ofstream cacheFile(cachePath, std::ios::app);
+        cacheFile << "3 2049:5:100\n";
+    }
+
+    ClassificationCache loadedCache;
+    loadedCache.setModelIdentity(modelPath);
+    E_ASSERT((loadedCache.load(cachePath) == false));
+    E_ASSERT((loadedCache.size() == 0));
+
+    // No header
+    {
+        std::ofstream cacheFile(cachePath, std::ios::trunc);
+        cacheFile << "1 2049:1:100:4096:7:/usr/bin/testapp\n";
+    }
+    E_ASSERT((loadedCache.load(cachePath) == false));
+    E_ASSERT((loadedCache.size() == 0));
+
+    std::remove(cachePath.c_str());
+    std::remove(modelPath.c_str());
+})
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
 #include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #include "ErrCodes.h"
 #include "TestUtils.h"
@@ -176,6 +178,84 @@ URM_TEST(TestClientDataManagerPulseMonitorClientListFetch, {
     }
 })
 
+URM_TEST(TestClientDataManagerPulseMonitorClientExitNotification, {
+    Init();
+    std::shared_ptr<ClientDataManager> clientDataManager = ClientDataManager::getInstance();
+    if(!clientDataManager->isLivenessTrackingSupported()) {
+        return;
+    }
+
+    pid_t childPID = fork();
+    E_ASSERT((childPID >= 0));
+    if(childPID == 0) {
+        usleep(100000);
+        _exit(0);
+    }
+
+    clientDataManager->createNewClient(childPID, childPID);
+
+    // A watched client should not be reported for the /proc polling fallback.
+    std::vector<int32_t> unwatchedClients;
+    clientDataManager->getUnwatchedClientList(unwatchedClients);
+    for(int32_t clientPID: unwatchedClients) {
+        E_ASSERT((clientPID != childPID));
+    }
+
+    std::vector<pid_t> deadClients;
+    for(int32_t i = 0; i < 5 && deadClients.empty(); i++) {
+        E_ASSERT((clientDataManager->waitForClientExits(deadClients, 1000) >= 0));
+    }
+
+    E_ASSERT((deadClients.size() == 1));
+    E_ASSERT((deadClients[0] == childPID));
+
+    waitpid(childPID, nullptr, 0);
+    clientDataManager->deleteClientPID(childPID);
+    clientDataManager->deleteClientTID(childPID);
+})
+
+URM_TEST(TestClientDataManagerConcurrentClientUpdates, {
+    Init();
+    std::shared_ptr<ClientDataManager> clientDataManager = ClientDataManager::getInstance();
+
+    // Clients are spread across shards, each worker creates and updates its own set of clients.
+    std::vector<std::thread> workers;
+    for(int32_t w = 0; w < 4; w++) {
+        workers.emplace_back([clientDataManager, w]() {
+            for(int32_t i = 0; i < 5; i++) {
+                int32_t clientID = 300 + w * 5 + i;
+                clientDataManager->createNewClient(clientID, clientID);
+            }
+
+            for(int32_t iter = 0; iter < 1000; iter++) {
+                for(int32_t i = 0; i < 5; i++) {
+                    int32_t clientID = 300 + w * 5 + i;
+                    clientDataManager->updateHealthByClientID(clientID, (double)(iter % 100));
+                    clientDataManager->updateLastRequestTimestampByClientID(clientID, iter + 1);
+                }
+            }
+        });
+    }
+
+    for(std::thread& worker: workers) {
+        worker.join();
+    }
+
+    std::vector<int32_t> clientList;
+    clientDataManager->getActiveClientList(clientList);
+    E_ASSERT((clientList.size() == 20));
+
+    for(int32_t clientID = 300; clientID < 320; clientID++) {
+        E_ASSERT((clientDataManager->clientExists(clientID, clientID) == true));
+        E_ASSERT((clientDataManager->getHealthByClientID(clientID) == 99.0));
+        E_ASSERT((clientDataManager->getLastRequestTimestampByClientID(clientID) == 1000));
+
+        clientDataManager->deleteClientPID(clientID);
+        clientDataManager->deleteClientTID(clientID);
+        E_ASSERT((clientDataManager->clientExists(clientID, clientID) == false));
+    }
+})
+
 URM_TEST(TestClientDataManagerRequestMapInsertion, {
     Init();
     std::shared_ptr<ClientDataManager> clientDataManager = ClientDataManager::getInstance();
@@ -3,6 +3,7 @@
 
 #include "TestUtils.h"
 #include "CocoTable.h"
+#include "MemoryPool.h"
 #include "URMTests.h"
 
 #define TEST_CLASS "COMPONENT"
@@ -23,3 +24,100 @@ URM_TEST(TestCocoTableInsertRequest3, {
     E_ASSERT((CocoTable::getInstance()->insertRequest(request) == false));
     delete request;
 })
+
+URM_TEST(TestCocoTableRemoveRequests1, {
+    std::vector<Request*> requests;
+    E_ASSERT((CocoTable::getInstance()->removeRequests(requests) == true));
+
+    Request* request = new Request;
+    requests.push_back(nullptr);
+    requests.push_back(request);
+    E_ASSERT((CocoTable::getInstance()->removeRequests(requests) == true));
+    delete request;
+})
+
+static int32_t applyCount = 0;
+static int32_t tearCount = 0;
+static int32_t lastAppliedValue = -1;
+
+static void countingApplier(void* context) {
+    applyCount++;
+    lastAppliedValue = ((Resource*)context)->getValueAt(0);
+}
+
+static void countingTear(void* context) {
+    (void)context;
+    tearCount++;
+}
+
+static Request* createCocoTestRequest(int64_t handle, uint32_t resCode, int32_t value) {
+    Resource* resource = MPLACED(Resource);
+    resource->setResCode(resCode);
+    resource->setNumValues(1);
+    resource->setValueAt(0, value);
+
+    ResIterable* resIterable = MPLACED(ResIterable);
+    resIterable->mData = resource;
+
+    Request* request = MPLACED(Request);
+    request->setRequestType(REQ_RESOURCE_TUNING);
+    request->setHandle(handle);
+    request->setDuration(-1);
+    request->setPriority(SYSTEM_HIGH);
+    request->setClientPID(321);
+    request->setClientTID(321);
+    request->addResource(resIterable);
+    return request;
+}
+
+URM_TEST(TestCocoTableRemoveRequests2, {
+    MakeAlloc<Resource> (10);
+    MakeAlloc<ResIterable> (10);
+    MakeAlloc<Request> (10);
+    MakeAlloc<DLManager> (10);
+
+    // TEST_RESOURCE_4: global, higher is better
+    uint32_t resCode = CONSTRUCT_RES_CODE(0xff, 0x0003);
+    ResConfInfo* resConfInfo = ResourceRegistry::getInstance()->getResConf(resCode);
+    E_ASSERT((resConfInfo != nullptr));
+
+    ResourceLifecycleCallback applier = resConfInfo->mResourceApplierCallback;
+    ResourceLifecycleCallback tear = resConfInfo->mResourceTearCallback;
+    int32_t currMode = UrmSettings::targetConfigs.currMode;
+    resConfInfo->mResourceApplierCallback = countingApplier;
+    resConfInfo->mResourceTearCallback = countingTear;
+    UrmSettings::targetConfigs.currMode = MODE_RESUME;
+
+    std::vector<Request*> requests;
+    int32_t values[] = {100, 300, 400, 500};
+    for(int32_t i = 0; i < 4; i++) {
+        requests.push_back(createCocoTestRequest(9100 + i, resCode, values[i]));
+        CocoTable::getInstance()->insertRequest(requests.back());
+    }
+    E_ASSERT((lastAppliedValue == 500));
+
+    // Three of the requests on the slot go together, the slot is re-evaluated once
+    // and ends up with the remaining request.
+    applyCount = 0;
+    tearCount = 0;
+    E_ASSERT((CocoTable::getInstance()->removeRequests({requests[1], requests[2], requests[3]}) == true));
+    int32_t bulkApplyCount = applyCount;
+    int32_t bulkTearCount = tearCount;
+    int32_t bulkAppliedValue = lastAppliedValue;
+
+    // Last one out, the Resource is reset.
+    E_ASSERT((CocoTable::getInstance()->removeRequests({requests[0]}) == true));
+    int32_t finalTearCount = tearCount;
+
+    resConfInfo->mResourceApplierCallback = applier;
+    resConfInfo->mResourceTearCallback = tear;
+    UrmSettings::targetConfigs.currMode = currMode;
+    for(Request* request: requests) {
+        Request::cleanUpRequest(request);
+    }
+
+    E_ASSERT((bulkApplyCount == 1));
+    E_ASSERT((bulkTearCount == 0));
+    E_ASSERT((bulkAppliedValue == 100));
+    E_ASSERT((finalTearCount == 1));
+})
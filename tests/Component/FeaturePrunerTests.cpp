@@ -0,0 +1,179 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+/**
+ * Golden tests for the feature normalisation (FeaturePruner), which does not depend on
+ * the ML model, hence these are run irrespective of floret's availability.
+ */
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "TestUtils.h"
+#include "URMTests.h"
+#include "FeaturePruner.h"
+
+#define TEST_CLASS "COMPONENT"
+#define TEST_SUBCAT "FEATURE_PRUNER"
+
+/*
+ * Golden outputs of the feature normalisation, captured from the std::regex based
+ * implementation the model was trained against. The inputs are /proc feature sets
+ * (cgroup, cmdline, environ, maps, fds) and journal lines, along with the date, time,
+ * uuid and number forms the normalisation targets. The normalised text must stay
+ * byte-identical, else the model sees different tokens than it was trained on.
+ */
+static const std::pair<std::string, std::string> cleanTextGolden[] = {
+    {"unconfined 0::/user.slice/user-1000.slice/user@1000.service/app.slice/app-org.gnome.Terminal.slice/vte-spawn-3f1b2c.scope /usr/lib/firefox/firefox -contentproc -childID 12 -isForBrowser -prefsLen 31542 {d3b0e1f2-7c4a-4e1b-9f2d-0a1b2c3d4e5f} Isolated Web Co",
+     "0::/user.slice/user-<num>.slice/user@<num>.service/app.slice/app-org.gnome.terminal.slice/vte-spawn-3f1b2c.scope /usr/lib/firefox/firefox -contentproc -childid -isforbrowser -prefslen d3b0e1f2-7c4a-4e1b-9f2d-0a1b2c3d4e5f isolated web co"},
+    {"0::/system.slice/snapd.service /usr/bin/python3 /usr/bin/update-manager --no-update 3.10 python3 libpython3.10.so.1.0 libc.so.6 SESSION_MANAGER=local/host:@/tmp/.ICE-unix/2201,unix/host:/tmp/.ICE-unix/2201",
+     "0::/system.slice/snapd.service /usr/bin/python3 /usr/bin/update-manager --no-update python3 libpython3.10.so.1.0 libc.so.6 session_manager=local/host:@/tmp/.ice-unix/<num> unix/host:/tmp/.ice-unix/<num>"},
+    {"(enforce) vlc --started-from-file /home/user/Videos/Trip_2023(1).mp4 [0x7ffd5e3a] libavcodec.so.58 pulse DISPLAY=:0 XDG_SESSION_TYPE=x11 0X1F 12345 6.28 42",
+     "enforce vlc --started-from-file /home/user/videos/trip_<num> .mp4 <hex> libavcodec.so.58 pulse display=:0 xdg_session_type=x11 <hex>"},
+    {"steam steamwebhelper -lang=en_US -cachedir=/home/user/.steam/config/htmlcache -steampid=48213 -buildid=1699999999 -steamid=0 [chromium] user@42.service user-7.slice vte-spawn-.scope x y z",
+     "steam steamwebhelper -lang=en_us -cachedir=/home/user/.steam/config/htmlcache -steampid=<num> -buildid=<num> -steamid=0 chromium"},
+    {"gnome-shell: [INFO] Window manager warning: Buggy client sent a _NET_ACTIVE_WINDOW message with a timestamp of 0 for 0x2a00007",
+     "gnome-shell: info window manager warning: buggy client sent _net_active_window message with timestamp of for <hex>"},
+    {"",
+     ""},
+    {"   ,,, [] () {}   ",
+     ""},
+};
+
+static const std::pair<std::string, std::string> datesGolden[] = {
+    {"app-2024-01-05 12:30:01.log", "app- .log"},
+    {"report 12/31/2023", "report "},
+    {"2023.1.5", ""},
+    {"Jan 5, 2024", ""},
+    {"backup 15 September 2021 final", "backup final"},
+    {"sept 3 99", ""},
+    {"started at 9:05 PM today", "started at today"},
+    {"12:30:45am", ""},
+    {"1:2:3", "1:2:3"},
+    {"socket", "socket"},
+    {"anon_inode", "anon_inode"},
+    {"eventfd", "eventfd"},
+    {"pipe", "pipe"},
+    {"memfd  cache  2024-13-45", "memfd cache "},
+    {"550e8400-e29b-41d4-a716-446655440000", "550e8400-e29b-41d4-a716-446655440000"},
+    {"deadbeef", "deadbeef"},
+    {"cafe_babe", "cafe_babe"},
+    {"build-1234", "build-1234"},
+    {"a-123", "a-123"},
+    {"-42", "-42"},
+    {"x+7 y", "x+7 y"},
+    {"0x1f", "0x1f"},
+    {"ff00ff", "ff00ff"},
+    {"node12", "node12"},
+};
+
+static const std::pair<std::string, std::string> numbersGolden[] = {
+    {"app-2024-01-05 12:30:01.log", "app-nnn n:n:n.log"},
+    {"report 12/31/2023", "report n/n/n"},
+    {"2023.1.5", "n.n.n"},
+    {"Jan 5, 2024", "Jan n, n"},
+    {"backup 15 September 2021 final", "backup n September n final"},
+    {"sept 3 99", "sept n n"},
+    {"started at 9:05 PM today", "started at n:n PM today"},
+    {"12:30:45am", "n:n:45am"},
+    {"1:2:3", "n:n:n"},
+    {"socket", "socket"},
+    {"anon_inode", "anon_inode"},
+    {"eventfd", "eventfd"},
+    {"pipe", "pipe"},
+    {"memfd  cache  2024-13-45", "memfd  cache  nnn"},
+    {"550e8400-e29b-41d4-a716-446655440000", "n"},
+    {"deadbeef", "n"},
+    {"cafe_babe", "cafe_babe"},
+    {"build-1234", "build-n"},
+    {"a-123", "an"},
+    {"-42", "-n"},
+    {"x+7 y", "xn y"},
+    {"0x1f", "0x1f"},
+    {"ff00ff", "n"},
+    {"node12", "node12"},
+};
+
+static const std::pair<std::string, std::string> journalGolden[] = {
+    {"myhost gnome-shell[1234]: [INFO] Window manager warning: Buggy client", "gnome-shell: [INFO] Window manager warning: Buggy client"},
+    {"myhost kernel: usb 1-1: new high-speed USB device number 3", ""},
+    {"myhost systemd[1]: Started Session 2 of User user.", "systemd: Started Session 2 of User user."},
+    {"myhost app[x][42]: message with [WARN ] tag and [ error] and [trace]", "app[x]: message with [WARN ] tag and [ error] and [trace]"},
+    {"[ debug ]value [ ] [ INFO] plain [text] unterminated [ info", ""},
+    {"selinux_u:role_r:type_t:s0 (enforce)", ""},
+    {"unconfined  (enforce)(enforce)", ""},
+};
+
+static const std::pair<std::string, std::string> logTagsGolden[] = {
+    {"myhost gnome-shell[1234]: [INFO] Window manager warning: Buggy client", "myhost gnome-shell1234]:  Window manager warning: Buggy client"},
+    {"myhost kernel: usb 1-1: new high-speed USB device number 3", "myhost kernel: usb 1-1: new high-speed USB device number 3"},
+    {"myhost systemd[1]: Started Session 2 of User user.", "myhost systemd1]: Started Session 2 of User user."},
+    {"myhost app[x][42]: message with [WARN ] tag and [ error] and [trace]", "myhost appx]42]: message with  tag and  and "},
+    {"[ debug ]value [ ] [ INFO] plain [text] unterminated [ info", "value   plain text] unterminated "},
+    {"selinux_u:role_r:type_t:s0 (enforce)", "selinux_u:role_r:type_t:s0 (enforce)"},
+    {"unconfined  (enforce)(enforce)", "unconfined  (enforce)(enforce)"},
+};
+
+static const std::pair<std::string, std::string> enforceGolden[] = {
+    {"myhost gnome-shell[1234]: [INFO] Window manager warning: Buggy client", "myhost gnome-shell[1234]: [INFO] Window manager warning: Buggy client"},
+    {"myhost kernel: usb 1-1: new high-speed USB device number 3", "myhost kernel: usb 1-1: new high-speed USB device number 3"},
+    {"myhost systemd[1]: Started Session 2 of User user.", "myhost systemd[1]: Started Session 2 of User user."},
+    {"myhost app[x][42]: message with [WARN ] tag and [ error] and [trace]", "myhost app[x][42]: message with [WARN ] tag and [ error] and [trace]"},
+    {"[ debug ]value [ ] [ INFO] plain [text] unterminated [ info", "[ debug ]value [ ] [ INFO] plain [text] unterminated [ info"},
+    {"selinux_u:role_r:type_t:s0 (enforce)", "selinux_u:role_r:type_t:s0"},
+    {"unconfined  (enforce)(enforce)", "unconfined"},
+};
+
+/**
+ * API under test: FeaturePruner::cleanText
+ * - Normalises the concatenated features exactly as the model training pipeline does
+ * Cross-Reference: MLInference::Predict
+ */
+URM_TEST(TestFeaturePrunerCleanTextGolden, {
+    for (const auto &entry : cleanTextGolden) {
+        E_ASSERT((FeaturePruner::cleanText(entry.first) == entry.second));
+    }
+})
+
+/**
+ * API under test: FeaturePruner::removeDatesAndTimesFromToken, normalize_numbers_inplace
+ * - Dates, times, uuids, hex runs and decimal numbers are rewritten as before
+ */
+URM_TEST(TestFeaturePrunerTokenGolden, {
+    for (const auto &entry : datesGolden) {
+        E_ASSERT((FeaturePruner::removeDatesAndTimesFromToken(entry.first) == entry.second));
+    }
+
+    for (const auto &entry : numbersGolden) {
+        std::vector<std::string> tokens = {entry.first};
+        FeaturePruner::normalize_numbers_inplace(tokens);
+        E_ASSERT((tokens[0] == entry.second));
+    }
+
+    std::vector<std::string> parts = FeaturePruner::splitString("::a..b:c.", ".:");
+    E_ASSERT((parts == std::vector<std::string>({"a", "b", "c"})));
+})
+
+/**
+ * API under test: FeaturePruner::formatJournalLine, removeLogLevelTags, removeEnforceMarker
+ * - Journal lines reduce to "<comm>: <message>", lines without a "<comm>[<pid>]:" are skipped
+ */
+URM_TEST(TestFeaturePrunerLogGolden, {
+    for (const auto &entry : journalGolden) {
+        std::string formatted;
+        int8_t matched = FeaturePruner::formatJournalLine(entry.first, formatted);
+        E_ASSERT((matched == !entry.second.empty()));
+        if (matched) {
+            E_ASSERT((formatted == entry.second));
+        }
+    }
+
+    for (const auto &entry : logTagsGolden) {
+        E_ASSERT((FeaturePruner::removeLogLevelTags(entry.first) == entry.second));
+    }
+
+    for (const auto &entry : enforceGolden) {
+        E_ASSERT((FeaturePruner::removeEnforceMarker(entry.first) == entry.second));
+    }
+})
@@ -1,6 +1,11 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <fstream>
+#include <climits>
+#include <dirent.h>
+#include <unistd.h>
+
 #include "UrmPlatformAL.h"
 #include "TestUtils.h"
 #include "MemoryPool.h"
@@ -121,6 +126,54 @@ URM_TEST(TestAuxRoutineFileExists, {
     E_ASSERT((fileExists == false));
 })
 
+URM_TEST(TestAuxRoutineProcFieldParsing, {
+    E_ASSERT((AuxRoutines::firstLine("first\nsecond\n") == "first"));
+    E_ASSERT((AuxRoutines::firstLine("single") == "single"));
+    E_ASSERT((AuxRoutines::firstLine("") == ""));
+
+    // The comm may contain spaces and parentheses, fields are counted from the last ')'
+    std::string stat = "1234 (my (app) x) S 1 1234 1234 34816 1234 4194560";
+    int64_t value = 0;
+    E_ASSERT((AuxRoutines::getStatField(stat, 1, value) == true));
+    E_ASSERT((value == 1234));
+    E_ASSERT((AuxRoutines::getStatField(stat, 4, value) == true));
+    E_ASSERT((value == 1));
+    E_ASSERT((AuxRoutines::getStatField(stat, 7, value) == true));
+    E_ASSERT((value == 34816));
+    E_ASSERT((AuxRoutines::getStatField(stat, 64, value) == false));
+
+    std::string status = "Name:\tbash\nUmask:\t0022\nUid:\t1000\t0\t0\t0\n";
+    std::string_view field;
+    E_ASSERT((AuxRoutines::getStatusField(status, "Uid", field) == true));
+    E_ASSERT((field == "1000\t0\t0\t0"));
+    E_ASSERT((AuxRoutines::getStatusField(status, "Gid", field) == false));
+})
+
+URM_TEST(TestAuxRoutineReadProcFile, {
+    std::string_view contents;
+    E_ASSERT((AuxRoutines::readProcFile(getpid(), "stat", contents) == true));
+
+    int64_t pid = 0;
+    E_ASSERT((AuxRoutines::getStatField(contents, 1, pid) == true));
+    E_ASSERT((pid == getpid()));
+
+    E_ASSERT((AuxRoutines::readProcFile(getpid(), "no_such_file", contents) == false));
+})
+
+URM_TEST(TestAuxRoutineTaskStartTime, {
+    std::string_view contents;
+    int64_t expected = 0;
+    E_ASSERT((AuxRoutines::readProcFile(getpid(), "stat", contents) == true));
+    E_ASSERT((AuxRoutines::getStatField(contents, 22, expected) == true));
+
+    // The main thread starts along with the process.
+    int64_t startTime = -1;
+    E_ASSERT((AuxRoutines::getTaskStartTime(getpid(), getpid(), startTime) == true));
+    E_ASSERT((startTime == expected));
+
+    E_ASSERT((AuxRoutines::getTaskStartTime(getpid(), INT_MAX, startTime) == false));
+})
+
 URM_TEST(TestRequestModeAddition, {
     Request request;
     request.setProperties(0);
@@ -133,3 +186,83 @@ URM_TEST(TestRequestModeAddition, {
     request.addProcessingMode(MODE_DOZE);
     E_ASSERT((request.getProcessingModes() == (MODE_RESUME | MODE_SUSPEND | MODE_DOZE)));
 })
+
+URM_TEST(TestLoggerAsyncFileOutput, {
+    std::string marker = "async-logger-marker-" + std::to_string(getpid());
+    Logger::configure(LOG_DEBUG, false, RedirectOptions::LOG_TOFILE);
+
+    for(int32_t i = 0; i < 100; i++) {
+        LOGD("URM_TESTS", marker + "-" + std::to_string(i));
+    }
+    Logger::flush();
+
+    // Restore the default output, before checking the file contents.
+    Logger::configure(LOG_DEBUG, false, RedirectOptions::LOG_TOSYSLOG);
+
+    std::ifstream logFile("/tmp/urm.log");
+    E_ASSERT((logFile.is_open()));
+
+    int32_t matchCount = 0;
+    std::string line;
+    while(std::getline(logFile, line)) {
+        if(line.find(marker) != std::string::npos) {
+            matchCount++;
+        }
+    }
+
+    // Ring has room for all the Messages, none should be dropped.
+    E_ASSERT((matchCount == 100));
+})
+
+static int8_t isLogFileOpen() {
+    int8_t found = false;
+    DIR* fdDir = opendir("/proc/self/fd");
+    if(fdDir == nullptr) return false;
+
+    struct dirent* entry;
+    while((entry = readdir(fdDir)) != nullptr) {
+        char target[PATH_MAX];
+        std::string fdPath = "/proc/self/fd/" + std::string(entry->d_name);
+        ssize_t len = readlink(fdPath.c_str(), target, sizeof(target) - 1);
+        if(len > 0) {
+            target[len] = '\0';
+            if(std::string(target) == "/tmp/urm.log") {
+                found = true;
+            }
+        }
+    }
+    closedir(fdDir);
+    return found;
+}
+
+URM_TEST(TestLoggerLongLines, {
+    std::string marker = "long-line-marker-" + std::to_string(getpid());
+    std::string longMessage = marker + std::string(2000, 'x') + "-end";
+    Logger::configure(LOG_DEBUG, false, RedirectOptions::LOG_TOFILE);
+
+    LOGD("URM_TESTS", marker + "-before");
+    LOGD("URM_TESTS", longMessage);
+    LOGD("URM_TESTS", marker + "-after");
+    Logger::flush();
+
+    // Switching back to syslog lets go of the file.
+    Logger::configure(LOG_DEBUG, false, RedirectOptions::LOG_TOSYSLOG);
+    E_ASSERT((isLogFileOpen() == false));
+
+    std::ifstream logFile("/tmp/urm.log");
+    E_ASSERT((logFile.is_open()));
+
+    // Written in full, in order with the lines around it.
+    std::vector<std::string> matches;
+    std::string line;
+    while(std::getline(logFile, line)) {
+        if(line.find(marker) != std::string::npos) {
+            matches.push_back(line);
+        }
+    }
+
+    E_ASSERT((matches.size() == 3));
+    E_ASSERT((matches[0].find(marker + "-before") != std::string::npos));
+    E_ASSERT((matches[1].find(longMessage) != std::string::npos));
+    E_ASSERT((matches[2].find(marker + "-after") != std::string::npos));
+})
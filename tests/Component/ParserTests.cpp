@@ -1,6 +1,12 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <unistd.h>
+#include <sys/stat.h>
+
 #include "ErrCodes.h"
 #include "TestUtils.h"
 #include "RestuneParser.h"
@@ -10,6 +16,9 @@
 #include "Utils.h"
 #include "RestuneInternal.h"
 #include "PropertiesRegistry.h"
+#include "ConfigSnapshot.h"
+#include "ConfigReloader.h"
+#include "DefaultsJournal.h"
 #include "URMTests.h"
 
 #define TEST_CLASS "COMPONENT"
@@ -413,6 +422,38 @@ URM_TEST(ExtFeaturesParsingTests, {
     }
 })
 
+URM_TEST(ExtFeatureMappingsFollowSignalReload, {
+    ExtFeatureInfoBuilder featureBuilder;
+    E_ASSERT((featureBuilder.setId("0x00000077") == RC_SUCCESS));
+    E_ASSERT((featureBuilder.setName("FEAT-RELOAD") == RC_SUCCESS));
+    E_ASSERT((featureBuilder.setLib("/usr/lib/libreloadfeature.so") == RC_SUCCESS));
+    E_ASSERT((featureBuilder.addSignalSubscribedTo("0x000d0a77") == RC_SUCCESS));
+    ExtFeaturesRegistry::getInstance()->registerExtFeature(featureBuilder.build());
+
+    // Subscribed Signal not configured, nothing to route.
+    std::shared_ptr<SignalRegistry> signalRegistry = SignalRegistry::createGeneration();
+    E_ASSERT((signalRegistry != nullptr));
+    std::shared_ptr<SignalExtFeatureMapper> mapper =
+        ExtFeaturesRegistry::getInstance()->buildSignalMappings(signalRegistry);
+    std::vector<uint32_t> features;
+    E_ASSERT((mapper != nullptr));
+    E_ASSERT((mapper->getFeatures(0x000d0a77, features) == false));
+
+    // The Signal shows up in a reloaded generation, the mappings are rebuilt against it.
+    SignalInfoBuilder signalBuilder;
+    E_ASSERT((signalBuilder.setSignalID("0x0a77") == RC_SUCCESS));
+    E_ASSERT((signalBuilder.setSignalCategory("0x0d") == RC_SUCCESS));
+    E_ASSERT((signalBuilder.setName("TEST_RELOADED_SIGNAL") == RC_SUCCESS));
+    signalRegistry = SignalRegistry::createGeneration();
+    signalRegistry->registerSignal(signalBuilder.build());
+    signalRegistry->buildLookupTable();
+
+    mapper = ExtFeaturesRegistry::getInstance()->buildSignalMappings(signalRegistry);
+    E_ASSERT((mapper != nullptr));
+    E_ASSERT((mapper->getFeatures(0x000d0a77, features) == true));
+    E_ASSERT((features.size() == 1 && features[0] == 0x00000077));
+})
+
 URM_TEST(ResourceParsingTestsAddOn, {
     {
         ErrCode parsingStatus = RC_SUCCESS;
@@ -683,3 +724,453 @@ URM_TEST(AppConfigParserTests, {
         E_ASSERT((appConfigInfo->mSignalCodes == nullptr));
     }
 })
+
+URM_TEST(RegistryLookupTableTests, {
+    {
+        ErrCode parsingStatus = RC_SUCCESS;
+        RestuneParser configProcessor;
+
+        parsingStatus = configProcessor.parseResourceConfigs("/etc/urm/tests/configs/ResourcesConfig.yaml");
+        E_ASSERT((parsingStatus == RC_SUCCESS));
+
+        parsingStatus = configProcessor.parseSignalConfigs("/etc/urm/tests/configs/SignalsConfig.yaml");
+        E_ASSERT((parsingStatus == RC_SUCCESS));
+
+        ResourceRegistry::getInstance()->buildLookupTable();
+        SignalRegistry::getInstance()->buildLookupTable();
+    }
+
+    {
+        // Every registered Resource should resolve to its own config via the lookup table
+        std::shared_ptr<ResourceRegistry> resourceRegistry = ResourceRegistry::getInstance();
+        for(ResConfInfo* rConf: resourceRegistry->getRegisteredResources()) {
+            uint32_t resCode = CONSTRUCT_RES_CODE(rConf->mResourceResType, rConf->mResourceResID);
+            E_ASSERT((resourceRegistry->getResConf(resCode) == rConf));
+        }
+
+        E_ASSERT((resourceRegistry->getResConf(CONSTRUCT_RES_CODE(0xff, 0x0fff)) == nullptr));
+        E_ASSERT((resourceRegistry->getResConf(CONSTRUCT_RES_CODE(0xfe, 0x0000)) == nullptr));
+        E_ASSERT((resourceRegistry->getResConf(GENERATE_RESOURCE_ID(0xff, 0x0000)) == nullptr));
+    }
+
+    {
+        // Every registered Signal should resolve to its own config via the lookup table
+        std::shared_ptr<SignalRegistry> signalRegistry = SignalRegistry::getInstance();
+        for(SignalInfo* sConf: signalRegistry->getSignalConfigs()) {
+            uint32_t sigCode = CONSTRUCT_SIG_CODE(sConf->mSignalCategory, sConf->mSignalID);
+            E_ASSERT((signalRegistry->getSignalConfigById(sigCode, sConf->mSigType) == sConf));
+        }
+
+        E_ASSERT((signalRegistry->getSignalConfigById(CONSTRUCT_SIG_CODE(0x0d, 0x0000), 0x1234) == nullptr));
+        E_ASSERT((signalRegistry->getSignalConfigById(CONSTRUCT_SIG_CODE(0x0d, 0x0fff), 0) == nullptr));
+    }
+})
+
+URM_TEST(ConfigSnapshotTests, {
+    std::string snapshotPath = "/tmp/urm_test_config_snapshot.bin";
+    std::string resourcesPath = "/etc/urm/tests/configs/ResourcesConfig.yaml";
+    std::string signalsPath = "/etc/urm/tests/configs/SignalsConfig.yaml";
+
+    {
+        RestuneParser configProcessor;
+        E_ASSERT((configProcessor.parseResourceConfigs(resourcesPath) == RC_SUCCESS));
+        E_ASSERT((configProcessor.parseSignalConfigs(signalsPath) == RC_SUCCESS));
+    }
+
+    std::vector<ResConfInfo*> registeredResources = ResourceRegistry::getInstance()->getRegisteredResources();
+    std::vector<SignalInfo*> registeredSignals = SignalRegistry::getInstance()->getSignalConfigs();
+
+    {
+        ConfigSnapshot snapshot(snapshotPath);
+        snapshot.addInputFile(resourcesPath);
+        snapshot.addInputFile(signalsPath);
+        snapshot.addInputKey("test-target");
+        E_ASSERT((snapshot.store(registeredResources, registeredSignals) == RC_SUCCESS));
+    }
+
+    {
+        // Same inputs, the snapshot should reproduce the registries exactly
+        ConfigSnapshot snapshot(snapshotPath);
+        snapshot.addInputFile(resourcesPath);
+        snapshot.addInputFile(signalsPath);
+        snapshot.addInputKey("test-target");
+
+        std::vector<ResConfInfo*> resources;
+        std::vector<SignalInfo*> signals;
+        E_ASSERT((snapshot.load(resources, signals) == RC_SUCCESS));
+        E_ASSERT((resources.size() == registeredResources.size()));
+        E_ASSERT((signals.size() == registeredSignals.size()));
+
+        for(size_t i = 0; i < resources.size(); i++) {
+            E_ASSERT((resources[i]->mResourceName == registeredResources[i]->mResourceName));
+            E_ASSERT((resources[i]->mResourcePath == registeredResources[i]->mResourcePath));
+            E_ASSERT((resources[i]->mResourceResType == registeredResources[i]->mResourceResType));
+            E_ASSERT((resources[i]->mResourceResID == registeredResources[i]->mResourceResID));
+            E_ASSERT((resources[i]->mHighThreshold == registeredResources[i]->mHighThreshold));
+            E_ASSERT((resources[i]->mLowThreshold == registeredResources[i]->mLowThreshold));
+            E_ASSERT((resources[i]->mPermissions == registeredResources[i]->mPermissions));
+            E_ASSERT((resources[i]->mModes == registeredResources[i]->mModes));
+            E_ASSERT((resources[i]->mApplyType == registeredResources[i]->mApplyType));
+            E_ASSERT((resources[i]->mPolicy == registeredResources[i]->mPolicy));
+            E_ASSERT((resources[i]->mUnit == registeredResources[i]->mUnit));
+            delete resources[i];
+        }
+
+        for(size_t i = 0; i < signals.size(); i++) {
+            SignalInfo* loaded = signals[i];
+            SignalInfo* parsed = registeredSignals[i];
+
+            E_ASSERT((loaded->mSignalCategory == parsed->mSignalCategory));
+            E_ASSERT((loaded->mSignalID == parsed->mSignalID));
+            E_ASSERT((loaded->mSigType == parsed->mSigType));
+            E_ASSERT((loaded->mSignalName == parsed->mSignalName));
+            E_ASSERT((loaded->mTimeout == parsed->mTimeout));
+
+            E_ASSERT(((loaded->mPermissions == nullptr) == (parsed->mPermissions == nullptr)));
+            if(parsed->mPermissions != nullptr) {
+                E_ASSERT((*loaded->mPermissions == *parsed->mPermissions));
+            }
+
+            E_ASSERT(((loaded->mDerivatives == nullptr) == (parsed->mDerivatives == nullptr)));
+            if(parsed->mDerivatives != nullptr) {
+                E_ASSERT((*loaded->mDerivatives == *parsed->mDerivatives));
+            }
+
+            E_ASSERT(((loaded->mSignalResources == nullptr) == (parsed->mSignalResources == nullptr)));
+            if(parsed->mSignalResources != nullptr) {
+                E_ASSERT((loaded->mSignalResources->size() == parsed->mSignalResources->size()));
+                for(size_t j = 0; j < parsed->mSignalResources->size(); j++) {
+                    Resource* loadedRes = loaded->mSignalResources->at(j);
+                    Resource* parsedRes = parsed->mSignalResources->at(j);
+                    E_ASSERT((loadedRes->getResCode() == parsedRes->getResCode()));
+                    E_ASSERT((loadedRes->getResInfo() == parsedRes->getResInfo()));
+                    E_ASSERT((loadedRes->getValuesCount() == parsedRes->getValuesCount()));
+                    for(int32_t k = 0; k < parsedRes->getValuesCount(); k++) {
+                        E_ASSERT((loadedRes->getValueAt(k) == parsedRes->getValueAt(k)));
+                    }
+                    delete loadedRes;
+                }
+                delete loaded->mSignalResources;
+            }
+
+            delete loaded->mPermissions;
+            delete loaded->mDerivatives;
+            delete loaded;
+        }
+    }
+
+    {
+        // Any change in the inputs should invalidate the snapshot
+        ConfigSnapshot snapshot(snapshotPath);
+        snapshot.addInputFile(resourcesPath);
+        snapshot.addInputFile("/etc/urm/tests/configs/SignalsConfigAddOn.yaml");
+        snapshot.addInputKey("test-target");
+
+        std::vector<ResConfInfo*> resources;
+        std::vector<SignalInfo*> signals;
+        E_ASSERT((snapshot.load(resources, signals) == RC_FILE_NOT_FOUND));
+        E_ASSERT((resources.size() == 0));
+        E_ASSERT((signals.size() == 0));
+    }
+
+    {
+        // A Resource node showing up (for ex. a late-loaded driver) should invalidate the snapshot
+        std::string nodePath = "/tmp/urm_test_snapshot_node";
+        AuxRoutines::deleteFile(nodePath);
+
+        ConfigSnapshot snapshot(snapshotPath);
+        snapshot.addInputNode(nodePath);
+        uint64_t keyWithoutNode = snapshot.getKey();
+
+        AuxRoutines::writeToFile(nodePath, "1");
+        ConfigSnapshot updatedSnapshot(snapshotPath);
+        updatedSnapshot.addInputNode(nodePath);
+        E_ASSERT((updatedSnapshot.getKey() != keyWithoutNode));
+
+        AuxRoutines::deleteFile(nodePath);
+    }
+
+    {
+        // Wildcard nodes, keyed by the directory the wildcard is matched against
+        std::string nodeDir = "/tmp/urm_test_snapshot_nodes";
+        mkdir(nodeDir.c_str(), 0755);
+
+        ConfigSnapshot snapshot(snapshotPath);
+        snapshot.addInputNode(nodeDir + "/*gpu/min_freq");
+        uint64_t keyWithoutNode = snapshot.getKey();
+
+        mkdir((nodeDir + "/kgsl-gpu").c_str(), 0755);
+        ConfigSnapshot updatedSnapshot(snapshotPath);
+        updatedSnapshot.addInputNode(nodeDir + "/*gpu/min_freq");
+        E_ASSERT((updatedSnapshot.getKey() != keyWithoutNode));
+
+        rmdir((nodeDir + "/kgsl-gpu").c_str());
+        rmdir(nodeDir.c_str());
+    }
+
+    {
+        // A corrupted payload must be rejected, rather than partially loaded
+        std::fstream snapshotFile(snapshotPath, std::ios::in | std::ios::out | std::ios::binary);
+        snapshotFile.seekp(-1, std::ios::end);
+        snapshotFile.put((char)0x5a);
+        snapshotFile.close();
+
+        ConfigSnapshot snapshot(snapshotPath);
+        snapshot.addInputFile(resourcesPath);
+        snapshot.addInputFile(signalsPath);
+        snapshot.addInputKey("test-target");
+
+        std::vector<ResConfInfo*> resources;
+        std::vector<SignalInfo*> signals;
+        E_ASSERT((snapshot.load(resources, signals) == RC_INVALID_VALUE));
+        E_ASSERT((resources.size() == 0));
+        E_ASSERT((signals.size() == 0));
+    }
+
+    AuxRoutines::deleteFile(snapshotPath);
+})
+
+URM_TEST(ConfigReloadTests, {
+    std::string reloadDir = "/tmp/urm_test_config_reload";
+    std::string commonSignalsPath = reloadDir + "/SignalsConfig.yaml";
+    std::string customSignalsPath = reloadDir + "/SignalsConfigCustom.yaml";
+
+    mkdir(reloadDir.c_str(), 0755);
+    AuxRoutines::deleteFile(customSignalsPath);
+    {
+        std::ifstream src("/etc/urm/tests/configs/SignalsConfig.yaml", std::ios::binary);
+        std::ofstream dst(commonSignalsPath, std::ios::binary | std::ios::trunc);
+        dst << src.rdbuf();
+    }
+
+    std::shared_ptr<SignalRegistry> original = SignalRegistry::getInstance();
+
+    ReloadConfigPaths reloadPaths;
+    reloadPaths.mSignalConfigPaths = {commonSignalsPath, customSignalsPath};
+    E_ASSERT((ConfigReloader::getInstance()->startConfigReloader(reloadPaths) == RC_SUCCESS));
+
+    // Synchronous reload, publishes a fresh generation
+    E_ASSERT((ConfigReloader::getInstance()->reload() == RC_SUCCESS));
+    std::shared_ptr<SignalRegistry> firstGeneration = SignalRegistry::getInstance();
+    E_ASSERT((firstGeneration != original));
+    E_ASSERT((firstGeneration->getSignalsConfigCount() > 0));
+    E_ASSERT((firstGeneration->getSignalConfigById(CONSTRUCT_SIG_CODE(0xde, 0xaadd), 0) == nullptr));
+
+    // Adding the optional layer is picked up by the watcher
+    {
+        std::ifstream src("/etc/urm/tests/configs/SignalsConfigAddOn.yaml", std::ios::binary);
+        std::ofstream dst(customSignalsPath, std::ios::binary | std::ios::trunc);
+        dst << src.rdbuf();
+    }
+
+    SignalInfo* signalInfo = nullptr;
+    for(int32_t i = 0; i < 60 && signalInfo == nullptr; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        signalInfo = SignalRegistry::getInstance()->getSignalConfigById(CONSTRUCT_SIG_CODE(0xde, 0xaadd), 0);
+    }
+
+    E_ASSERT((signalInfo != nullptr));
+    E_ASSERT((signalInfo->mTimeout == 14500));
+
+    // The generation held across the reload stays intact
+    E_ASSERT((firstGeneration->getSignalConfigById(CONSTRUCT_SIG_CODE(0xde, 0xaadd), 0) == nullptr));
+
+    // A broken layer leaves the published generation untouched
+    std::shared_ptr<SignalRegistry> lastGeneration = SignalRegistry::getInstance();
+    {
+        std::ofstream dst(commonSignalsPath, std::ios::trunc);
+        dst << "SignalConfigs: [ {";
+    }
+    E_ASSERT((RC_IS_NOTOK(ConfigReloader::getInstance()->reload())));
+    E_ASSERT((SignalRegistry::getInstance() == lastGeneration));
+
+    ConfigReloader::getInstance()->stopConfigReloader();
+    SignalRegistry::publish(original);
+
+    AuxRoutines::deleteFile(commonSignalsPath);
+    AuxRoutines::deleteFile(customSignalsPath);
+    rmdir(reloadDir.c_str());
+})
+
+URM_TEST(ConfigReloadPropertiesTests, {
+    std::string reloadDir = "/tmp/urm_test_properties_reload";
+    std::string commonSignalsPath = "/etc/urm/tests/configs/SignalsConfig.yaml";
+    std::string commonPropertiesPath = reloadDir + "/PropertiesConfig.yaml";
+
+    mkdir(reloadDir.c_str(), 0755);
+    {
+        std::ofstream dst(commonPropertiesPath, std::ios::trunc);
+        dst << "PropertyConfigs:\n  - Name: \"test.reload.value\"\n    Value: \"first\"\n";
+    }
+
+    std::shared_ptr<SignalRegistry> originalSignals = SignalRegistry::getInstance();
+    std::shared_ptr<PropertiesRegistry> originalProperties = PropertiesRegistry::getInstance();
+
+    ReloadConfigPaths reloadPaths;
+    reloadPaths.mSignalConfigPaths = {commonSignalsPath};
+    reloadPaths.mPropertiesConfigPaths = {commonPropertiesPath};
+    E_ASSERT((ConfigReloader::getInstance()->startConfigReloader(reloadPaths) == RC_SUCCESS));
+
+    E_ASSERT((ConfigReloader::getInstance()->reload() == RC_SUCCESS));
+    std::shared_ptr<PropertiesRegistry> firstGeneration = PropertiesRegistry::getInstance();
+    E_ASSERT((firstGeneration != originalProperties));
+
+    std::string result;
+    E_ASSERT((submitPropGetRequest("test.reload.value", result, "") > 0));
+    E_ASSERT((result == "first"));
+
+    // A changed value is picked up by the watcher
+    {
+        std::ofstream dst(commonPropertiesPath, std::ios::trunc);
+        dst << "PropertyConfigs:\n  - Name: \"test.reload.value\"\n    Value: \"second\"\n";
+    }
+
+    for(int32_t i = 0; i < 60 && result != "second"; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        submitPropGetRequest("test.reload.value", result, "");
+    }
+    E_ASSERT((result == "second"));
+
+    // The generation held across the reload stays intact
+    E_ASSERT((firstGeneration->queryProperty("test.reload.value", result) > 0));
+    E_ASSERT((result == "first"));
+
+    // A broken layer leaves the published generation untouched
+    std::shared_ptr<PropertiesRegistry> lastGeneration = PropertiesRegistry::getInstance();
+    {
+        std::ofstream dst(commonPropertiesPath, std::ios::trunc);
+        dst << "PropertyConfigs: [ {";
+    }
+    E_ASSERT((RC_IS_NOTOK(ConfigReloader::getInstance()->reload())));
+    E_ASSERT((PropertiesRegistry::getInstance() == lastGeneration));
+
+    ConfigReloader::getInstance()->stopConfigReloader();
+    SignalRegistry::publish(originalSignals);
+    PropertiesRegistry::publish(originalProperties);
+
+    AuxRoutines::deleteFile(commonPropertiesPath);
+    rmdir(reloadDir.c_str());
+})
+
+URM_TEST(ResourceDefaultsCaptureTests, {
+    std::string nodePath = "/tmp/urm_test_lazy_default_node";
+    AuxRoutines::writeToFile(nodePath, "42");
+
+    ResourceConfigInfoBuilder builder;
+    E_ASSERT((builder.setName("LAZY_DEFAULT_TEST") == RC_SUCCESS));
+    E_ASSERT((builder.setPath(nodePath) == RC_SUCCESS));
+    E_ASSERT((builder.setResType("0xfa") == RC_SUCCESS));
+    E_ASSERT((builder.setResID("0x0001") == RC_SUCCESS));
+    E_ASSERT((builder.setApplyType("global") == RC_SUCCESS));
+
+    std::shared_ptr<ResourceRegistry> resourceRegistry = ResourceRegistry::getInstance();
+    resourceRegistry->registerResource(builder.build());
+    uint32_t resCode = CONSTRUCT_RES_CODE(0xfa, 0x0001);
+
+    // Nothing is read at registration
+    E_ASSERT((resourceRegistry->getDefaultValue(nodePath) == ""));
+
+    // The value in place right before the first apply is the default
+    AuxRoutines::writeToFile(nodePath, "99");
+    resourceRegistry->captureDefaults(resCode);
+    E_ASSERT((resourceRegistry->getDefaultValue(nodePath) == "99"));
+
+    // Further applies keep the original default
+    AuxRoutines::writeToFile(nodePath, "7");
+    resourceRegistry->captureDefaults(resCode);
+    E_ASSERT((resourceRegistry->getDefaultValue(nodePath) == "99"));
+
+    resourceRegistry->deleteDefaultValue(nodePath);
+    AuxRoutines::deleteFile(nodePath);
+})
+
+URM_TEST(DefaultsJournalTests, {
+    std::string journalPath = "/tmp/urm_test_defaults.journal";
+
+    {
+        DefaultsJournal journal;
+        E_ASSERT((journal.open(journalPath) == RC_SUCCESS));
+        E_ASSERT((journal.append("/sys/node_a", "100") == RC_SUCCESS));
+        E_ASSERT((journal.append("/sys/node_b", "") == RC_SUCCESS));
+        E_ASSERT((journal.append("/sys/node_a", "200") == RC_SUCCESS));
+        journal.close();
+        E_ASSERT((journal.append("/sys/node_c", "300") != RC_SUCCESS));
+    }
+
+    {
+        // The first value recorded for a node is its original value
+        std::vector<std::pair<std::string, std::string>> entries;
+        E_ASSERT((DefaultsJournal::replay(journalPath, entries) == RC_SUCCESS));
+        E_ASSERT((entries.size() == 2));
+        E_ASSERT((entries[0].first == "/sys/node_a" && entries[0].second == "100"));
+        E_ASSERT((entries[1].first == "/sys/node_b" && entries[1].second == ""));
+    }
+
+    {
+        // A torn tail is dropped, the records preceding it survive
+        std::ofstream journalFile(journalPath, std::ios::binary | std::ios::app);
+        uint32_t tornRecord[2] = {64, 0};
+        journalFile.write((const char*)tornRecord, sizeof(tornRecord));
+        journalFile.write("/sys/node_d", 11);
+    }
+
+    {
+        std::vector<std::pair<std::string, std::string>> entries;
+        E_ASSERT((DefaultsJournal::replay(journalPath, entries) == RC_SUCCESS));
+        E_ASSERT((entries.size() == 2));
+    }
+
+    {
+        // Nodes are journaled when their defaults are captured
+        std::string nodePath = "/tmp/urm_test_journaled_node";
+        AuxRoutines::writeToFile(nodePath, "55");
+
+        ResourceConfigInfoBuilder builder;
+        E_ASSERT((builder.setPath(nodePath) == RC_SUCCESS));
+        E_ASSERT((builder.setResType("0xfa") == RC_SUCCESS));
+        E_ASSERT((builder.setResID("0x0002") == RC_SUCCESS));
+        E_ASSERT((builder.setApplyType("global") == RC_SUCCESS));
+
+        std::shared_ptr<ResourceRegistry> resourceRegistry = ResourceRegistry::getInstance();
+        resourceRegistry->registerResource(builder.build());
+
+        E_ASSERT((resourceRegistry->openDefaultsJournal(journalPath) == RC_SUCCESS));
+        resourceRegistry->captureDefaults(CONSTRUCT_RES_CODE(0xfa, 0x0002));
+        resourceRegistry->closeDefaultsJournal();
+
+        std::vector<std::pair<std::string, std::string>> entries;
+        E_ASSERT((DefaultsJournal::replay(journalPath, entries) == RC_SUCCESS));
+        E_ASSERT((entries.size() == 1));
+        E_ASSERT((entries[0].first == nodePath && entries[0].second == "55"));
+
+        resourceRegistry->deleteDefaultValue(nodePath);
+        AuxRoutines::deleteFile(nodePath);
+    }
+
+    {
+        // Defaults recorded directly by the appliers are journaled as well, once.
+        // But only for the Resource nodes, a task's cgroup can't be restored after a crash.
+        std::string nodePath = "/tmp/urm_test_journaled_node";
+        std::string procPath = "/proc/" + std::to_string(getpid()) + "/cgroup";
+        std::shared_ptr<ResourceRegistry> resourceRegistry = ResourceRegistry::getInstance();
+
+        E_ASSERT((resourceRegistry->isResourceNodePath(nodePath) == true));
+        E_ASSERT((resourceRegistry->isResourceNodePath(procPath) == false));
+
+        E_ASSERT((resourceRegistry->openDefaultsJournal(journalPath) == RC_SUCCESS));
+        resourceRegistry->addDefaultValue(procPath, "/user.slice");
+        resourceRegistry->addDefaultValue(nodePath, "12");
+        resourceRegistry->addDefaultValue(nodePath, "13");
+        resourceRegistry->closeDefaultsJournal();
+
+        std::vector<std::pair<std::string, std::string>> entries;
+        E_ASSERT((DefaultsJournal::replay(journalPath, entries) == RC_SUCCESS));
+        E_ASSERT((entries.size() == 1));
+        E_ASSERT((entries[0].first == nodePath && entries[0].second == "12"));
+
+        resourceRegistry->deleteDefaultValue(nodePath);
+        resourceRegistry->deleteDefaultValue(procPath);
+    }
+
+    AuxRoutines::deleteFile(journalPath);
+})
@@ -1,6 +1,9 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <thread>
+#include <atomic>
+
 #include "TestUtils.h"
 #include "RequestManager.h"
 #include "RateLimiter.h"
@@ -169,3 +172,49 @@ URM_TEST(TestClientSpammingWithGoodRequests, {
         Request::cleanUpRequest(req);
     }
 })
+
+URM_TEST(TestClientConcurrentRequestsScenario, {
+    Init();
+    std::shared_ptr<ClientDataManager> clientDataManager = ClientDataManager::getInstance();
+    std::shared_ptr<RateLimiter> rateLimiter = RateLimiter::getInstance();
+
+    // Two clients, each spammed from 4 threads in parallel.
+    // The first Request is free, followed by 49 penalized Requests, which brings the
+    // health down to 2. Hence exactly 50 Requests should be admitted per client, irrespective
+    // of how the Requests from the different threads interleave.
+    // All the Requests are evaluated against the same timestamp, so that no reward can be
+    // earned, irrespective of how long the threads take to run.
+    const int64_t requestMillis = 1000;
+    int32_t clientIDs[2] = {997, 998};
+    std::atomic<int32_t> admittedCount[2];
+
+    for(int32_t c = 0; c < 2; c++) {
+        admittedCount[c].store(0);
+        clientDataManager->createNewClient(clientIDs[c], clientIDs[c]);
+    }
+
+    std::vector<std::thread> workers;
+    for(int32_t w = 0; w < 8; w++) {
+        int32_t c = w % 2;
+        workers.emplace_back([&rateLimiter, &admittedCount, &clientIDs, c, requestMillis]() {
+            for(int32_t i = 0; i < 20; i++) {
+                if(rateLimiter->isRateLimitHonored(clientIDs[c], requestMillis)) {
+                    admittedCount[c].fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for(std::thread& worker: workers) {
+        worker.join();
+    }
+
+    for(int32_t c = 0; c < 2; c++) {
+        E_ASSERT((admittedCount[c].load() == 50));
+        E_ASSERT((clientDataManager->getHealthByClientID(clientIDs[c]) == 0));
+        E_ASSERT((rateLimiter->isRateLimitHonored(clientIDs[c], requestMillis) == false));
+
+        clientDataManager->deleteClientPID(clientIDs[c]);
+        clientDataManager->deleteClientTID(clientIDs[c]);
+    }
+})
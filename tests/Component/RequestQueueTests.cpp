@@ -1,7 +1,16 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <fstream>
+
 #include "RequestQueue.h"
+#include "RequestJournal.h"
+#include "CocoTable.h"
+#include "ResourceRegistry.h"
+#include "ClientDataManager.h"
+#include "ClientGarbageCollector.h"
+#include "RestuneInternal.h"
+#include "UrmSettings.h"
 #include "TestUtils.h"
 #include "URMTests.h"
 
@@ -13,6 +22,10 @@ static void Init() {
     if(!initDone) {
         initDone = true;
         MakeAlloc<Message> (30);
+        MakeAlloc<Request> (10);
+        MakeAlloc<Resource> (10);
+        MakeAlloc<ResIterable> (10);
+        MakeAlloc<DLManager> (10);
     }
 }
 
@@ -526,3 +539,260 @@ URM_TEST(TestRequestQueueInvalidPriority, {
 
     E_ASSERT((requestQueue->addAndWakeup(invalidRequest) == false));
 })
+
+URM_TEST(TestRequestSerializeRoundTrip, {
+    Init();
+    Request* request = MPLACED(Request);
+    request->setRequestType(REQ_RESOURCE_TUNING);
+    request->setHandle(77);
+    request->setDuration(5000);
+    request->setProperties(3);
+    request->setClientPID(321);
+    request->setClientTID(2445);
+
+    for(int32_t i = 0; i < 2; i++) {
+        Resource* resource = MPLACED(Resource);
+        resource->setResCode(0x00030000 + i);
+        resource->setResInfo(i);
+        resource->setNumValues(1);
+        resource->setValueAt(0, 700 + i);
+
+        ResIterable* resIterable = MPLACED(ResIterable);
+        resIterable->mData = resource;
+        request->addResource(resIterable);
+    }
+
+    char buf[REQ_BUFFER_SIZE];
+    int32_t size = request->serialize(buf, sizeof(buf));
+    E_ASSERT((size > 0));
+    E_ASSERT((request->serialize(buf, 8) == -1));
+
+    Request* decoded = MPLACED(Request);
+    E_ASSERT((decoded->deserialize(buf) == RC_SUCCESS));
+    E_ASSERT((decoded->getRequestType() == REQ_RESOURCE_TUNING));
+    E_ASSERT((decoded->getHandle() == 77));
+    E_ASSERT((decoded->getDuration() == 5000));
+    E_ASSERT((decoded->getProperties() == 3));
+    E_ASSERT((decoded->getClientPID() == 321));
+    E_ASSERT((decoded->getClientTID() == 2445));
+    E_ASSERT((decoded->getResourcesCount() == 2));
+
+    int32_t index = 0;
+    DL_ITERATE(decoded->getResDlMgr()) {
+        Resource* resource = (Resource*)((ResIterable*)iter)->mData;
+        E_ASSERT((resource->getResCode() == (uint32_t)(0x00030000 + index)));
+        E_ASSERT((resource->getResInfo() == index));
+        E_ASSERT((resource->getValueAt(0) == 700 + index));
+        index++;
+    }
+
+    Request::cleanUpRequest(request);
+    Request::cleanUpRequest(decoded);
+})
+
+URM_TEST(TestRequestJournalReplay, {
+    std::string journalPath = "/tmp/urm_test_active_requests.journal";
+    const char requestData[3][4] = {"r_a", "r_b", "r_c"};
+
+    {
+        RequestJournal journal;
+        E_ASSERT((journal.open(journalPath) == RC_SUCCESS));
+        E_ASSERT((journal.recordAdd(11, 1000, 501, requestData[0], 4) == RC_SUCCESS));
+        E_ASSERT((journal.recordAdd(12, -1, 502, requestData[1], 4) == RC_SUCCESS));
+        E_ASSERT((journal.recordAdd(13, 3000, -1, requestData[2], 4) == RC_SUCCESS));
+        E_ASSERT((journal.recordRemove(12) == RC_SUCCESS));
+        // Retune, the later expiry wins
+        E_ASSERT((journal.recordAdd(11, 9000, 511, requestData[0], 4) == RC_SUCCESS));
+        journal.close();
+    }
+
+    {
+        std::vector<JournaledRequest> requests;
+        E_ASSERT((RequestJournal::replay(journalPath, requests) == RC_SUCCESS));
+        E_ASSERT((requests.size() == 2));
+        E_ASSERT((requests[0].mHandle == 11 && requests[0].mExpiry == 9000));
+        E_ASSERT((requests[0].mClientStartTime == 511));
+        E_ASSERT((std::string(requests[0].mRequestData.data()) == "r_a"));
+        E_ASSERT((requests[1].mHandle == 13 && requests[1].mExpiry == 3000));
+        E_ASSERT((requests[1].mClientStartTime == -1));
+    }
+
+    {
+        // A torn tail is dropped, the records preceding it survive
+        std::ofstream journalFile(journalPath, std::ios::binary | std::ios::app);
+        uint32_t tornRecord[2] = {128, 0};
+        journalFile.write((const char*)tornRecord, sizeof(tornRecord));
+        journalFile.write("r_d", 3);
+    }
+
+    {
+        std::vector<JournaledRequest> requests;
+        E_ASSERT((RequestJournal::replay(journalPath, requests) == RC_SUCCESS));
+        E_ASSERT((requests.size() == 2));
+    }
+
+    std::remove(journalPath.c_str());
+})
+
+URM_TEST(TestRequestJournalCompaction, {
+    std::string journalPath = "/tmp/urm_test_active_requests.journal";
+    const char requestData[] = "request";
+
+    RequestJournal journal;
+    E_ASSERT((journal.open(journalPath) == RC_SUCCESS));
+    E_ASSERT((journal.recordAdd(1, -1, 0, requestData, sizeof(requestData)) == RC_SUCCESS));
+
+    // Short lived Requests, compaction keeps the journal bounded
+    for(int64_t handle = 2; handle < 2000; handle++) {
+        E_ASSERT((journal.recordAdd(handle, 500, 0, requestData, sizeof(requestData)) == RC_SUCCESS));
+        E_ASSERT((journal.recordRemove(handle) == RC_SUCCESS));
+    }
+    E_ASSERT((journal.recordAdd(2000, 700, 0, requestData, sizeof(requestData)) == RC_SUCCESS));
+    journal.close();
+
+    std::ifstream journalFile(journalPath, std::ios::binary | std::ios::ate);
+    E_ASSERT((journalFile.tellg() < 200 * 40));
+
+    std::vector<JournaledRequest> requests;
+    E_ASSERT((RequestJournal::replay(journalPath, requests) == RC_SUCCESS));
+    E_ASSERT((requests.size() == 2));
+    E_ASSERT((requests[0].mHandle == 1 && requests[0].mExpiry == -1));
+    E_ASSERT((requests[1].mHandle == 2000));
+
+    std::remove(journalPath.c_str());
+})
+
+// A dead client's Requests are torn down via the Garbage Collector, and the Resource
+// goes back to its original value.
+URM_TEST(TestClientTeardownRestoresResource, {
+    Init();
+    MakeAlloc<ClientInfo> (4);
+    MakeAlloc<ClientTidData> (4);
+    MakeAlloc<std::unordered_set<int64_t>> (4);
+
+    // TEST_RESOURCE_4: global, higher is better
+    uint32_t resCode = CONSTRUCT_RES_CODE(0xff, 0x0003);
+    ResConfInfo* resConfInfo = ResourceRegistry::getInstance()->getResConf(resCode);
+    E_ASSERT((resConfInfo != nullptr));
+
+    int32_t currMode = UrmSettings::targetConfigs.currMode;
+    uint32_t maxConcurrentRequests = UrmSettings::metaConfigs.mMaxConcurrentRequests;
+    uint32_t cleanupBatchSize = UrmSettings::metaConfigs.mCleanupBatchSize;
+    UrmSettings::targetConfigs.currMode = MODE_RESUME;
+    UrmSettings::metaConfigs.mMaxConcurrentRequests = 16;
+    UrmSettings::metaConfigs.mCleanupBatchSize = 4;
+    std::string defaultValue = ResourceRegistry::getInstance()->getDefaultValue(resConfInfo->mResourcePath);
+
+    pid_t clientID = 8801;
+    int64_t handle = 9301;
+    E_ASSERT((ClientDataManager::getInstance()->createNewClient(clientID, clientID) == true));
+
+    Resource* resource = MPLACED(Resource);
+    resource->setResCode(resCode);
+    resource->setNumValues(1);
+    resource->setValueAt(0, 1234);
+
+    ResIterable* resIterable = MPLACED(ResIterable);
+    resIterable->mData = resource;
+
+    Request* request = MPLACED(Request);
+    request->setRequestType(REQ_RESOURCE_TUNING);
+    request->setHandle(handle);
+    request->setDuration(-1);
+    request->setPriority(SYSTEM_HIGH);
+    request->setClientPID(clientID);
+    request->setClientTID(clientID);
+    request->addResource(resIterable);
+
+    E_ASSERT((RequestManager::getInstance()->addRequest(request) == true));
+    RequestManager::getInstance()->markRequestAsComplete(handle);
+    E_ASSERT((CocoTable::getInstance()->insertRequest(request) == true));
+    std::string tunedValue = AuxRoutines::readFromFile(resConfInfo->mResourcePath);
+
+    ClientGarbageCollector::getInstance()->submitClientForCleanup(clientID);
+    ClientGarbageCollector::getInstance()->performCleanup();
+    RequestQueue::getInstance()->orderedQueueConsumerHook();
+
+    std::string restoredValue = AuxRoutines::readFromFile(resConfInfo->mResourcePath);
+    RequestInfo requestInfo = RequestManager::getInstance()->getRequestFromMap(handle);
+    int8_t clientTidExists = ClientDataManager::getInstance()->clientExists(clientID, clientID);
+
+    ClientDataManager::getInstance()->deleteClientPID(clientID);
+    UrmSettings::targetConfigs.currMode = currMode;
+    UrmSettings::metaConfigs.mMaxConcurrentRequests = maxConcurrentRequests;
+    UrmSettings::metaConfigs.mCleanupBatchSize = cleanupBatchSize;
+
+    E_ASSERT((defaultValue != "1234"));
+    E_ASSERT((AuxRoutines::trimView(tunedValue) == "1234"));
+    E_ASSERT((AuxRoutines::trimView(restoredValue) == defaultValue));
+    E_ASSERT((requestInfo.first == nullptr));
+    E_ASSERT((clientTidExists == false));
+})
+
+static Request* createReplayedRequest(int64_t handle, int32_t value) {
+    Resource* resource = MPLACED(Resource);
+    resource->setResCode(CONSTRUCT_RES_CODE(0xff, 0x0003));
+    resource->setNumValues(1);
+    resource->setValueAt(0, value);
+
+    ResIterable* resIterable = MPLACED(ResIterable);
+    resIterable->mData = resource;
+
+    Request* request = MPLACED(Request);
+    request->setRequestType(REQ_RESOURCE_TUNING);
+    request->setHandle(handle);
+    request->setDuration(-1);
+    request->setProperties(0);
+    // As journaled, i.e. with the granted priority.
+    request->setPriority(THIRD_PARTY_HIGH);
+    request->setClientPID(getpid());
+    request->setClientTID(getpid());
+    request->addResource(resIterable);
+    return request;
+}
+
+// Journaled Requests are replayed before any client has connected.
+URM_TEST(TestReplayedRequestResubmission, {
+    Init();
+    MakeAlloc<ClientInfo> (4);
+    MakeAlloc<ClientTidData> (4);
+    MakeAlloc<std::unordered_set<int64_t>> (4);
+
+    int32_t currMode = UrmSettings::targetConfigs.currMode;
+    uint32_t maxConcurrentRequests = UrmSettings::metaConfigs.mMaxConcurrentRequests;
+    UrmSettings::targetConfigs.currMode = MODE_RESUME;
+    UrmSettings::metaConfigs.mMaxConcurrentRequests = 16;
+
+    int8_t clientExisted = ClientDataManager::getInstance()->clientExists(getpid(), getpid());
+
+    // Still valid against the current configs, admitted and queued for application.
+    Request* validRequest = createReplayedRequest(9401, 1500);
+    int8_t validSubmitted = resubmitResProvisionRequest(validRequest);
+    Request* admittedRequest = RequestManager::getInstance()->getRequestFromMap(9401).first;
+
+    Request* queuedRequest = nullptr;
+    if(RequestQueue::getInstance()->hasPendingTasks()) {
+        queuedRequest = (Request*)RequestQueue::getInstance()->pop();
+    }
+    if(admittedRequest != nullptr) {
+        RequestManager::getInstance()->removeRequest(admittedRequest);
+        Request::cleanUpRequest(admittedRequest);
+    }
+
+    // Out of the Resource's (current) bounds, dropped.
+    Request* invalidRequest = createReplayedRequest(9402, 4000);
+    int8_t invalidSubmitted = resubmitResProvisionRequest(invalidRequest);
+    Request* droppedRequest = RequestManager::getInstance()->getRequestFromMap(9402).first;
+
+    ClientDataManager::getInstance()->deleteClientTID(getpid());
+    ClientDataManager::getInstance()->deleteClientPID(getpid());
+    UrmSettings::targetConfigs.currMode = currMode;
+    UrmSettings::metaConfigs.mMaxConcurrentRequests = maxConcurrentRequests;
+
+    E_ASSERT((clientExisted == false));
+    E_ASSERT((validSubmitted == true));
+    E_ASSERT((admittedRequest == validRequest));
+    E_ASSERT((queuedRequest == validRequest));
+    E_ASSERT((invalidSubmitted == false));
+    E_ASSERT((droppedRequest == nullptr));
+})